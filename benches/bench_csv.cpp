@@ -4,16 +4,38 @@
 
 #include <csv.hpp>
 
+#include "template_cli_cpp/recording/recorder_factory.hpp"
+#include "template_cli_cpp/utility/csv_wrapper.hpp"
+#include "template_cli_cpp/utility/csv_writer.hpp"
+
+#include <algorithm>
 #include <array>
 #include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <functional>
 #include <initializer_list>
+#include <iterator>
+#include <limits>
 #include <random>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#if TEMPLATE_CLI_CPP_HAS_ZLIB
+#include <zlib.h>
+#endif
+#if TEMPLATE_CLI_CPP_HAS_ZSTD
+#include <zstd.h>
+#endif
+
 namespace {
 
 constexpr int kNumRows = 2'000'000;
@@ -216,6 +238,29 @@ void BenchRawRead(ankerl::nanobench::Bench &bench,
         }
         ankerl::nanobench::doNotOptimizeAway(count);
     });
+
+    // mmap + utility::CsvTokenizer: フィールドはマップ領域を直接指す string_view（コピーなし）
+    // 区切り文字・改行の検出はカーネル別（スカラー / 実行中の CPU で最速のもの）に計測する
+    std::vector<utility::ScanKernel> kernels = {utility::ScanKernel::kScalar};
+    if (utility::DetectScanKernel() != utility::ScanKernel::kScalar) {
+        kernels.push_back(utility::DetectScanKernel());
+    }
+    for (const utility::ScanKernel kernel : kernels) {
+        const char *kernel_name = kernel == utility::ScanKernel::kAvx2   ? "avx2"
+                                  : kernel == utility::ScanKernel::kSse2 ? "sse2"
+                                                                          : "scalar";
+        bench.run(std::string("CsvReader  ") + label + " [raw] mmap tokenizer (" + kernel_name + ")", [&] {
+            const auto file = utility::MappedFile::Open(path);
+            utility::CsvTokenizer tokenizer(file->View(), ',', kernel);
+            std::vector<std::string_view> fields;
+            int64_t count = 0;
+            while (tokenizer.NextRow(fields)) {
+                ankerl::nanobench::doNotOptimizeAway(fields);
+                ++count;
+            }
+            ankerl::nanobench::doNotOptimizeAway(count);
+        });
+    }
 }
 
 // ──────────────────────────────────────────────────────────────
@@ -286,6 +331,671 @@ void BenchFiltered(ankerl::nanobench::Bench &bench,
             ankerl::nanobench::doNotOptimizeAway(result);
         });
     }
+
+    // (E) 列指向出力: utility::CsvReader::ReadColumns で列ごとの連続バッファに格納
+    //     出力列の事前確保により push_back の再確保が発生しない
+    {
+        auto pred = [&flag_idx](const csv::CSVRow &row) {
+            return row[flag_idx].get<int>() == 1;
+        };
+        std::vector<utility::ColumnSpec> specs;
+        for (const auto &name : out_col_names) {
+            specs.push_back({name, utility::ColumnType::kDouble});
+        }
+        const utility::CsvReader reader(path);
+        bench.batch(filtered_count).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+        bench.run(std::string("CsvReader  ") + label + " [filtered:E] columnar", [&] {
+            auto table = reader.ReadColumns(pred, specs);
+            ankerl::nanobench::doNotOptimizeAway(table);
+        });
+    }
+
+    // (F) mmap バックエンド: utility::CsvRowView 述語でマップ領域を直接トークナイズ
+    {
+        auto pred = [flag_idx](const utility::CsvRowView &row) {
+            return row[static_cast<std::size_t>(flag_idx)].get<int>() == 1;
+        };
+        utility::CsvReaderOptions options;
+        options.backend = utility::CsvBackend::kMmap;
+        const utility::CsvReader reader(path, options);
+        bench.batch(filtered_count).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+        bench.run(std::string("CsvReader  ") + label + " [filtered:F] mmap", [&] {
+            auto result = reader.ReadFiltered(pred, out_col_names);
+            ankerl::nanobench::doNotOptimizeAway(result);
+        });
+    }
+
+    // (G) 型付き列射影: CsvReader::Read<double, double> で述語・列型・列数をコンパイル時に固定
+    //     (D) と同等の特殊化を公開 API で得られるかを確認する
+    {
+        auto pred = [flag_idx](const utility::CsvRowView &row) {
+            return row[static_cast<std::size_t>(flag_idx)].get<int>() == 1;
+        };
+        const utility::CsvReader reader(path);
+        bench.batch(filtered_count).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+        bench.run(std::string("CsvReader  ") + label + " [filtered:G] typed Read", [&] {
+            auto columns = reader.Read<double, double>(pred, {out_col_names.at(0), out_col_names.at(1)});
+            ankerl::nanobench::doNotOptimizeAway(columns);
+        });
+    }
+
+    // (H) フィルタ式: utility::CsvFilter で flag 列までだけ分割し、通過しない行の残りは分割しない
+    {
+        const utility::CsvReader reader(path);
+        const auto filter = utility::Col("flag") == 1;
+        bench.batch(filtered_count).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+        bench.run(std::string("CsvReader  ") + label + " [filtered:H] filter expression", [&] {
+            auto result = reader.ReadFiltered(filter, out_col_names);
+            ankerl::nanobench::doNotOptimizeAway(result);
+        });
+    }
+}
+
+// ──────────────────────────────────────────────────────────────
+// セクション: utility::CsvReader 並列スキャン（flag==1、スレッド数別）
+// 1 スレッドは従来の逐次読み込み。2 スレッド以上はレコード境界で分割した
+// バイト範囲を各ワーカーが独立に解析し、行順を保って連結する
+// ──────────────────────────────────────────────────────────────
+
+void BenchParallel(ankerl::nanobench::Bench &bench,
+                   const std::string &path,
+                   const char *label,
+                   const std::vector<std::string> &out_col_names,
+                   int flag_idx) {
+    const int64_t filtered_count = CountFiltered(path, flag_idx);
+    auto pred = [flag_idx](const csv::CSVRow &row) {
+        return row[flag_idx].get<int>() == 1;
+    };
+
+    const unsigned int hw_threads = std::max(1U, std::thread::hardware_concurrency());
+    for (unsigned int num_threads : {1U, 2U, 4U, 8U}) {
+        if (num_threads > 1 && num_threads > hw_threads) {
+            break;
+        }
+        utility::CsvReaderOptions options;
+        options.num_threads = num_threads;
+        const utility::CsvReader reader(path, options);
+
+        bench.batch(filtered_count).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+        bench.run(std::string("CsvReader  ") + label + " [parallel] " + std::to_string(num_threads) + " thread(s)",
+                  [&] {
+                      auto result = reader.ReadFiltered(pred, out_col_names);
+                      ankerl::nanobench::doNotOptimizeAway(result);
+                  });
+    }
+}
+
+// ──────────────────────────────────────────────────────────────
+// セクション: utility::CsvReader バッチストリーミング（flag==1、出力列の合計まで）
+// 全件を ReadColumns で集めてから集計する場合と、ReadBatches で解析と集計を
+// 重ねる場合を比較する。後者は保持する行数がバッチサイズで頭打ちになる
+// ──────────────────────────────────────────────────────────────
+
+void BenchStreaming(ankerl::nanobench::Bench &bench,
+                    const std::string &path,
+                    const char *label,
+                    const std::vector<std::string> &out_col_names,
+                    int flag_idx) {
+    const int64_t filtered_count = CountFiltered(path, flag_idx);
+    const auto filter = utility::Col("flag") == 1;
+    std::vector<utility::ColumnSpec> specs;
+    for (const auto &name : out_col_names) {
+        specs.push_back({name, utility::ColumnType::kDouble});
+    }
+    auto sum_table = [](const utility::ColumnTable &table) {
+        double sum = 0.0;
+        for (std::size_t col = 0; col < table.ColumnCount(); ++col) {
+            for (double v : table.DoubleColumn(col)) {
+                sum += v;
+            }
+        }
+        return sum;
+    };
+
+    utility::CsvReaderOptions options;
+    options.backend = utility::CsvBackend::kMmap;
+    const utility::CsvReader reader(path, options);
+
+    bench.batch(filtered_count).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+    bench.run(std::string("CsvReader  ") + label + " [stream] ReadColumns then sum", [&] {
+        const auto table = reader.ReadColumns(filter, specs);
+        ankerl::nanobench::doNotOptimizeAway(sum_table(table));
+    });
+
+    for (std::size_t batch_rows : {std::size_t{4096}, utility::CsvReader::kDefaultBatchRows}) {
+        bench.batch(filtered_count).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+        bench.run(std::string("CsvReader  ") + label + " [stream] ReadBatches " + std::to_string(batch_rows) + " rows",
+                  [&] {
+                      double sum = 0.0;
+                      reader.ReadBatches(
+                          filter, specs, [&](utility::ColumnTable &batch) { sum += sum_table(batch); }, batch_rows);
+                      ankerl::nanobench::doNotOptimizeAway(sum);
+                  });
+    }
+}
+
+// ──────────────────────────────────────────────────────────────
+// セクション: utility::CsvReader 先読み I/O（flag==1 フィルタ式、backend 別・スレッド数別）
+// kMmap と kReadAhead（I/O スレッドが pread で先読みし、解析と重ねる）を比較する
+// cold: 毎回 posix_fadvise(DONTNEED) でページキャッシュから追い出してから読む（ディスク読み込みを含む）
+// ──────────────────────────────────────────────────────────────
+
+// path のページをページキャッシュから追い出す（書き戻し済みのページのみ。失敗しても計測は続ける）
+void DropPageCache(const std::string &path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    ::fdatasync(fd);
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+}
+
+void BenchReadAhead(ankerl::nanobench::Bench &bench,
+                    const std::string &path,
+                    const char *label,
+                    const std::vector<std::string> &out_col_names,
+                    int flag_idx) {
+    const int64_t filtered_count = CountFiltered(path, flag_idx);
+    const auto filter = utility::Col("flag") == 1;
+
+    const unsigned int hw_threads = std::max(1U, std::thread::hardware_concurrency());
+    for (const bool cold : {false, true}) {
+        for (const auto backend : {utility::CsvBackend::kMmap, utility::CsvBackend::kReadAhead}) {
+            for (unsigned int num_threads : {1U, 4U}) {
+                if (num_threads > 1 && num_threads > hw_threads) {
+                    break;
+                }
+                utility::CsvReaderOptions options;
+                options.num_threads = num_threads;
+                options.backend = backend;
+                const utility::CsvReader reader(path, options);
+                const std::string name = std::string(backend == utility::CsvBackend::kMmap ? "mmap" : "read-ahead") +
+                                         (cold ? " cold " : " warm ") + std::to_string(num_threads) + " thread(s)";
+
+                bench.batch(filtered_count).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+                bench.run(std::string("CsvReader  ") + label + " [read-ahead] " + name, [&] {
+                    if (cold) {
+                        DropPageCache(path);
+                    }
+                    auto result = reader.ReadFiltered(filter, out_col_names);
+                    ankerl::nanobench::doNotOptimizeAway(result);
+                });
+            }
+        }
+    }
+}
+
+// ──────────────────────────────────────────────────────────────
+// セクション: utility::CsvReader 圧縮ファイル入力（flag==1 フィルタ式）
+// 非圧縮ファイル（mmap / read-ahead）を基準に、.csv.gz と複数フレームの .csv.zst を比較する
+// （zlib / zstd が見つからない構成では該当する形式を省く）
+// ──────────────────────────────────────────────────────────────
+
+// path を kFrameBytes ごとに別フレーム（gzip はメンバー）として圧縮したファイルを書き、そのパスを返す
+// （圧縮ライブラリが無い場合は空文字列）
+std::string WriteCompressedCopy(const std::string &path, [[maybe_unused]] utility::CompressionFormat format) {
+    [[maybe_unused]] constexpr std::size_t kFrameBytes = std::size_t{4} * 1024 * 1024;
+    std::ifstream in(path, std::ios::binary);
+    const std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::string out;
+    std::string suffix;
+#if TEMPLATE_CLI_CPP_HAS_ZLIB
+    if (format == utility::CompressionFormat::kGzip) {
+        suffix = ".gz";
+        for (std::size_t pos = 0; pos < content.size(); pos += kFrameBytes) {
+            const std::size_t n = std::min(kFrameBytes, content.size() - pos);
+            z_stream stream{};
+            deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+            std::string member(deflateBound(&stream, static_cast<uLong>(n)), '\0');
+            stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(content.data() + pos));
+            stream.avail_in = static_cast<uInt>(n);
+            stream.next_out = reinterpret_cast<Bytef *>(member.data());
+            stream.avail_out = static_cast<uInt>(member.size());
+            deflate(&stream, Z_FINISH);
+            member.resize(stream.total_out);
+            deflateEnd(&stream);
+            out += member;
+        }
+    }
+#endif
+#if TEMPLATE_CLI_CPP_HAS_ZSTD
+    if (format == utility::CompressionFormat::kZstd) {
+        suffix = ".zst";
+        for (std::size_t pos = 0; pos < content.size(); pos += kFrameBytes) {
+            const std::size_t n = std::min(kFrameBytes, content.size() - pos);
+            std::string frame(ZSTD_compressBound(n), '\0');
+            frame.resize(ZSTD_compress(frame.data(), frame.size(), content.data() + pos, n, 3));
+            out += frame;
+        }
+    }
+#endif
+    if (suffix.empty()) {
+        return {};
+    }
+    const std::string compressed_path = path + suffix;
+    std::ofstream(compressed_path, std::ios::binary).write(out.data(), static_cast<std::streamsize>(out.size()));
+    std::printf("%s: %zu -> %zu bytes\n", compressed_path.c_str(), content.size(), out.size());
+    return compressed_path;
+}
+
+void BenchCompressed(ankerl::nanobench::Bench &bench,
+                     const std::string &path,
+                     const char *label,
+                     const std::vector<std::string> &out_col_names,
+                     int flag_idx) {
+    const int64_t filtered_count = CountFiltered(path, flag_idx);
+    const auto filter = utility::Col("flag") == 1;
+    const unsigned int hw_threads = std::max(1U, std::thread::hardware_concurrency());
+
+    struct Input {
+        std::string name;
+        std::string path;
+        utility::CsvBackend backend;
+    };
+    std::vector<Input> inputs = {
+        {"plain mmap      ", path, utility::CsvBackend::kMmap},
+        {"plain read-ahead", path, utility::CsvBackend::kReadAhead},
+    };
+    for (const auto format : {utility::CompressionFormat::kGzip, utility::CompressionFormat::kZstd}) {
+        std::string compressed_path = WriteCompressedCopy(path, format);
+        if (!compressed_path.empty()) {
+            const char *name = format == utility::CompressionFormat::kGzip ? "gzip            " : "zstd            ";
+            inputs.push_back({name, std::move(compressed_path), utility::CsvBackend::kMmap});
+        }
+    }
+
+    for (const auto &input : inputs) {
+        for (unsigned int num_threads : {1U, 4U}) {
+            if (num_threads > 1 && num_threads > hw_threads) {
+                break;
+            }
+            utility::CsvReaderOptions options;
+            options.num_threads = num_threads;
+            options.backend = input.backend;
+            const utility::CsvReader reader(input.path, options);
+
+            bench.batch(filtered_count).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+            bench.run(
+                std::string("CsvReader  ") + label + " [compressed] " + input.name + " " +
+                    std::to_string(num_threads) + " thread(s)",
+                [&] {
+                    auto result = reader.ReadFiltered(filter, out_col_names);
+                    ankerl::nanobench::doNotOptimizeAway(result);
+                }
+            );
+        }
+        if (input.path != path) {
+            std::filesystem::remove(input.path);
+        }
+    }
+}
+
+// ──────────────────────────────────────────────────────────────
+// セクション: utility::CsvReader 列指向バイナリキャッシュ（flag==1 フィルタ式）
+// cold: 毎回キャッシュを削除して作成から行う（初回クエリ相当）
+// warm: 作成済みのキャッシュを mmap して読む（2 回目以降のクエリ相当）
+// ──────────────────────────────────────────────────────────────
+
+void BenchColumnCache(ankerl::nanobench::Bench &bench,
+                      const std::string &path,
+                      const char *label,
+                      const std::vector<std::string> &out_col_names,
+                      int flag_idx) {
+    const int64_t filtered_count = CountFiltered(path, flag_idx);
+    const auto filter = utility::Col("flag") == 1;
+    utility::CsvReaderOptions options;
+    options.column_cache = true;
+    const utility::CsvReader reader(path, options);
+    const std::string cache_path = utility::CsvColumnCache::PathFor(path, options.cache_dir);
+
+    bench.batch(filtered_count).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+    bench.run(std::string("CsvReader  ") + label + " [cache] cold (build + read)", [&] {
+        std::filesystem::remove(cache_path);
+        auto result = reader.ReadFiltered(filter, out_col_names);
+        ankerl::nanobench::doNotOptimizeAway(result);
+    });
+
+    bench.batch(filtered_count).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+    bench.run(std::string("CsvReader  ") + label + " [cache] warm", [&] {
+        auto result = reader.ReadFiltered(filter, out_col_names);
+        ankerl::nanobench::doNotOptimizeAway(result);
+    });
+
+    std::filesystem::remove(cache_path);
+}
+
+// ──────────────────────────────────────────────────────────────
+// セクション: utility::CsvReader 行番号による部分読み込み
+// ファイル中央の 100 行・1% 標本を、全行走査（id の範囲をフィルタ式で指定）と行位置インデックスで比較する
+// （batch は読み出す行数: 1 行あたりの時間）
+// ──────────────────────────────────────────────────────────────
+
+void BenchRowAccess(ankerl::nanobench::Bench &bench, const std::string &path, int num_rows, const char *label) {
+    const std::vector<utility::ColumnSpec> specs = {
+        {     "id",  utility::ColumnType::kInt64},
+        {"value_a", utility::ColumnType::kDouble},
+    };
+    const auto first = static_cast<std::uint64_t>(num_rows / 2);
+    const std::uint64_t last = first + 100;
+    const auto id_range =
+        utility::Col("id") >= static_cast<double>(first) && utility::Col("id") < static_cast<double>(last);
+    const utility::CsvReader reader(path);
+
+    bench.batch(last - first).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+    bench.run(std::string("CsvReader  ") + label + " [rows] 100 rows: full scan (ReadColumns)", [&] {
+        auto result = reader.ReadColumns(id_range, specs);
+        ankerl::nanobench::doNotOptimizeAway(result);
+    });
+
+    bench.batch(num_rows).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+    bench.run(std::string("CsvReader  ") + label + " [rows] build row index (per file row)", [&] {
+        auto index = utility::CsvRowIndex::Build(path);
+        ankerl::nanobench::doNotOptimizeAway(index);
+    });
+
+    reader.RowIndex(); // 以降は作成済みのインデックスを使う
+    bench.batch(last - first).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+    bench.run(std::string("CsvReader  ") + label + " [rows] 100 rows: ReadRange", [&] {
+        auto result = reader.ReadRange(first, last, specs);
+        ankerl::nanobench::doNotOptimizeAway(result);
+    });
+
+    const std::size_t sample_count = static_cast<std::size_t>(num_rows / 100);
+    for (const auto method : {utility::CsvSampling::kUniform, utility::CsvSampling::kStratified}) {
+        const char *name = method == utility::CsvSampling::kUniform ? "uniform   " : "stratified";
+        bench.batch(sample_count).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+        bench.run(std::string("CsvReader  ") + label + " [rows] 1% sample " + name + ": ReadSample", [&] {
+            auto result = reader.ReadSample(sample_count, specs, method);
+            ankerl::nanobench::doNotOptimizeAway(result);
+        });
+    }
+}
+
+// ──────────────────────────────────────────────────────────────
+// セクション: utility::CsvReader 列の型の推定
+// 標本（先頭 + 無作為な位置）による推定と、ファイル全体を調べる場合を比較する
+// （batch はファイルの行数: どちらもファイル 1 行あたりに換算した時間）
+// ──────────────────────────────────────────────────────────────
+
+void BenchSchema(ankerl::nanobench::Bench &bench, const std::string &path, int num_rows, const char *label) {
+    const utility::CsvReader reader(path);
+    utility::CsvSchemaOptions whole_file;
+    whole_file.head_bytes = std::numeric_limits<std::size_t>::max();
+
+    bench.batch(num_rows).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+    bench.run(std::string("CsvReader  ") + label + " [schema] InferSchema sampled", [&] {
+        auto schema = reader.InferSchema();
+        ankerl::nanobench::doNotOptimizeAway(schema);
+    });
+
+    bench.batch(num_rows).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+    bench.run(std::string("CsvReader  ") + label + " [schema] InferSchema whole file", [&] {
+        auto schema = reader.InferSchema(whole_file);
+        ankerl::nanobench::doNotOptimizeAway(schema);
+    });
+}
+
+// ──────────────────────────────────────────────────────────────
+// セクション: utility::CsvReader 複数問い合わせ（条件・出力列の異なる 3 問い合わせ）
+// 問い合わせごとに ReadColumns を呼ぶ場合と、ReadQueries で 1 回の走査にまとめる場合を比較する
+// （batch はファイルの行数: 1 行あたりの全問い合わせの処理時間）
+// ──────────────────────────────────────────────────────────────
+
+void BenchMultiQuery(ankerl::nanobench::Bench &bench, const std::string &path, int num_rows, const char *label) {
+    const std::vector<utility::ColumnSpec> value_spec = {{"value_a", utility::ColumnType::kDouble}};
+    const std::vector<utility::ColumnSpec> id_spec = {{"id", utility::ColumnType::kInt64}};
+    const std::vector<utility::ColumnSpec> label_spec = {{"category", utility::ColumnType::kString}};
+    const auto flagged = utility::Col("flag") == 1;
+    const auto large = utility::Col("value_b") > 900.0;
+    const auto category = utility::Col("category") == "A";
+
+    utility::CsvQuerySet queries;
+    queries.Add(flagged, value_spec);
+    queries.Add(large, id_spec);
+    queries.Add(category, label_spec);
+
+    const utility::CsvReader reader(path);
+    bench.batch(num_rows).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+    bench.run(std::string("CsvReader  ") + label + " [multi] 3 x ReadColumns", [&] {
+        auto a = reader.ReadColumns(flagged, value_spec);
+        auto b = reader.ReadColumns(large, id_spec);
+        auto c = reader.ReadColumns(category, label_spec);
+        ankerl::nanobench::doNotOptimizeAway(a);
+        ankerl::nanobench::doNotOptimizeAway(b);
+        ankerl::nanobench::doNotOptimizeAway(c);
+    });
+
+    bench.batch(num_rows).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+    bench.run(std::string("CsvReader  ") + label + " [multi] ReadQueries (single pass)", [&] {
+        auto results = reader.ReadQueries(queries);
+        ankerl::nanobench::doNotOptimizeAway(results);
+    });
+}
+
+// ──────────────────────────────────────────────────────────────
+// セクション: utility::CsvReader 集計（flag==1 の category 別 value_a の平均）
+// ReadColumns で中間テーブルを作ってから集計する場合と、ReadAggregates で走査中に
+// 集計する場合を比較する。並列版はスレッドごとの部分集計を最後に合成する
+// ──────────────────────────────────────────────────────────────
+
+void BenchAggregate(ankerl::nanobench::Bench &bench, const std::string &path, const char *label, int flag_idx) {
+    const int64_t filtered_count = CountFiltered(path, flag_idx);
+    const auto filter = utility::Col("flag") == 1;
+
+    {
+        const utility::CsvReader reader(path);
+        bench.batch(filtered_count).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+        bench.run(std::string("CsvReader  ") + label + " [aggregate] ReadColumns then group-by", [&] {
+            const auto table = reader.ReadColumns(
+                filter,
+                {{"category", utility::ColumnType::kString}, {"value_a", utility::ColumnType::kDouble}}
+            );
+            utility::GroupedAggregates result({"value_a"});
+            for (std::size_t i = 0; i < table.RowCount(); ++i) {
+                const std::size_t group = result.AddGroup(table.StringColumn(0)[i]);
+                result.CountRow(group);
+                result.Add(group, 0, table.DoubleColumn(1)[i]);
+            }
+            ankerl::nanobench::doNotOptimizeAway(result);
+        });
+    }
+
+    const unsigned int hw_threads = std::max(1U, std::thread::hardware_concurrency());
+    for (unsigned int num_threads : {1U, 4U}) {
+        if (num_threads > 1 && num_threads > hw_threads) {
+            break;
+        }
+        utility::CsvReaderOptions options;
+        options.num_threads = num_threads;
+        const utility::CsvReader reader(path, options);
+        bench.batch(filtered_count).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+        bench.run(std::string("CsvReader  ") + label + " [aggregate] ReadAggregates " + std::to_string(num_threads) +
+                      " thread(s)",
+                  [&] {
+                      auto result = reader.ReadAggregates(filter, "category", {"value_a"});
+                      ankerl::nanobench::doNotOptimizeAway(result);
+                  });
+        bench.batch(filtered_count).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+        bench.run(std::string("CsvReader  ") + label + " [aggregate] ReadHistogram " + std::to_string(num_threads) +
+                      " thread(s)",
+                  [&] {
+                      auto result = reader.ReadHistogram(filter, "value_a", 0.0, 1000.0, 100);
+                      ankerl::nanobench::doNotOptimizeAway(result);
+                  });
+    }
+}
+
+// ──────────────────────────────────────────────────────────────
+// セクション: utility::CsvReader 文字列列の辞書符号化（全行の category 列）
+// kString（行ごとに文字列を保持）と kDictionary（種類ごとに 1 つ保持し、行ごとは 32 bit コード）の
+// 読み込み時間を比較し、結果テーブルの概算メモリ量（ヒープ上の配列と文字列本体）を表示する
+// ──────────────────────────────────────────────────────────────
+
+void BenchDictionary(ankerl::nanobench::Bench &bench, const std::string &path, int num_rows, const char *label) {
+    const auto all_rows = [](const utility::CsvRowView &) { return true; };
+    const utility::CsvReader reader(path);
+
+    bench.batch(num_rows).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+    bench.run(std::string("CsvReader  ") + label + " [dictionary] ReadColumns kString", [&] {
+        auto table = reader.ReadColumns(all_rows, {{"category", utility::ColumnType::kString}});
+        ankerl::nanobench::doNotOptimizeAway(table);
+    });
+
+    bench.batch(num_rows).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(500));
+    bench.run(std::string("CsvReader  ") + label + " [dictionary] ReadColumns kDictionary", [&] {
+        auto table = reader.ReadColumns(all_rows, {{"category", utility::ColumnType::kDictionary}});
+        ankerl::nanobench::doNotOptimizeAway(table);
+    });
+
+    const auto strings = reader.ReadColumns(all_rows, {{"category", utility::ColumnType::kString}});
+    std::size_t string_bytes = strings.StringColumn(0).Size() * sizeof(std::string_view);
+    for (std::string_view text : strings.StringColumn(0)) {
+        string_bytes += text.size();
+    }
+    const auto encoded = reader.ReadColumns(all_rows, {{"category", utility::ColumnType::kDictionary}});
+    const auto &dictionary = encoded.DictionaryColumn(0);
+    std::size_t dictionary_bytes = dictionary.Size() * sizeof(std::uint32_t);
+    for (std::string_view value : dictionary.Values()) {
+        dictionary_bytes += sizeof(std::string_view) + value.size();
+    }
+    std::printf("CsvReader  %s [dictionary] memory: kString %zu bytes, kDictionary %zu bytes (%zu values)\n",
+                label,
+                string_bytes,
+                dictionary_bytes,
+                dictionary.Values().size());
+}
+
+// ──────────────────────────────────────────────────────────────
+// セクション: 数値変換コスト（列の型別、変換処理のみを計測）
+// 対象列の全フィールドを事前に文字列として取り出しておき、ファイル読み込み・
+// トークナイズの影響を除いて 1 フィールドあたりの変換コストを比較する
+// ──────────────────────────────────────────────────────────────
+
+template <typename T>
+void BenchConversionColumn(ankerl::nanobench::Bench &bench,
+                           const std::string &path,
+                           const char *label,
+                           const std::string &column,
+                           const char *type_name) {
+    std::vector<std::string> texts;
+    {
+        const auto file = utility::MappedFile::Open(path);
+        utility::CsvTokenizer tokenizer(file->View());
+        std::vector<std::string_view> fields;
+        tokenizer.NextRow(fields);
+        const auto header = utility::CsvHeader(std::vector<std::string>(fields.begin(), fields.end()));
+        const auto idx = static_cast<size_t>(header.IndexOf(column));
+        while (tokenizer.NextRow(fields)) {
+            texts.emplace_back(fields[idx]);
+        }
+    }
+    std::vector<std::string_view> views(texts.begin(), texts.end());
+    const std::string prefix = std::string("convert    ") + label + " [" + type_name + "] ";
+
+    bench.batch(views.size()).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(200));
+
+    bench.run(prefix + "csv::CSVField::get", [&] {
+        T sum{};
+        for (const auto sv : views) {
+            csv::CSVField field(sv);
+            sum += field.get<T>();
+        }
+        ankerl::nanobench::doNotOptimizeAway(sum);
+    });
+
+    bench.run(prefix + (std::is_floating_point_v<T> ? "std::strtod" : "std::strtoll"), [&] {
+        T sum{};
+        for (const auto &text : texts) {
+            char *end = nullptr;
+            if constexpr (std::is_floating_point_v<T>) {
+                sum += static_cast<T>(std::strtod(text.c_str(), &end));
+            } else {
+                sum += static_cast<T>(std::strtoll(text.c_str(), &end, 10));
+            }
+        }
+        ankerl::nanobench::doNotOptimizeAway(sum);
+    });
+
+    bench.run(prefix + "utility::ParseNumber", [&] {
+        T sum{};
+        for (const auto sv : views) {
+            T value{};
+            utility::ParseNumber(sv, value);
+            sum += value;
+        }
+        ankerl::nanobench::doNotOptimizeAway(sum);
+    });
+}
+
+void BenchConversion(ankerl::nanobench::Bench &bench, const std::string &path, const char *label) {
+    BenchConversionColumn<int64_t>(bench, path, label, "id", "int64 ");
+    BenchConversionColumn<int>(bench, path, label, "flag", "int   ");
+    BenchConversionColumn<double>(bench, path, label, "value_a", "double");
+}
+
+// ──────────────────────────────────────────────────────────────
+// セクション: CSV 書き出し（id, time, value_a, value_b, category の 5 列）
+// RecorderFactory::MakeCsvFile + Write（1 行ごとに fmt::format と spdlog 呼び出し）と
+// utility::CsvWriter::WriteColumns（列をまとめて整形し大きな write で書く）を比較する
+// ──────────────────────────────────────────────────────────────
+
+void BenchWriter(ankerl::nanobench::Bench &bench, int num_rows, const char *label) {
+    const auto path = (std::filesystem::temp_directory_path() / "bench_csv_writer.csv").string();
+    const auto rows = static_cast<std::size_t>(num_rows);
+
+    std::mt19937_64 rng(kRandomSeed);
+    std::uniform_real_distribution<double> value_dist(0.0, 1000.0);
+    std::uniform_int_distribution<int> cat_dist(0, 4);
+    std::vector<std::int64_t> ids(rows);
+    std::vector<double> times(rows);
+    std::vector<double> values_a(rows);
+    std::vector<double> values_b(rows);
+    std::vector<std::string_view> categories(rows);
+    for (std::size_t i = 0; i < rows; ++i) {
+        ids[i] = static_cast<std::int64_t>(i);
+        times[i] = static_cast<double>(i) * 1e-3;
+        values_a[i] = value_dist(rng);
+        values_b[i] = value_dist(rng);
+        categories[i] = kCategories[static_cast<std::size_t>(cat_dist(rng))];
+    }
+    const std::string header = "id,time,value_a,value_b,category";
+
+    bench.batch(num_rows).minEpochIterations(1).minEpochTime(std::chrono::milliseconds(500));
+    bench.run(std::string("Recorder   ") + label + " [writer] MakeCsvFile + Write per row", [&] {
+        auto recorder = recording::RecorderFactory::MakeCsvFile("bench_csv_writer", path, header);
+        recorder->Enable();
+        for (std::size_t i = 0; i < rows; ++i) {
+            recorder->Write("{},{:.6f},{:.6f},{:.6f},{}", ids[i], times[i], values_a[i], values_b[i], categories[i]);
+        }
+        recorder->Flush();
+    });
+
+    for (const int precision : {6, -1}) {
+        for (const unsigned int threads : {1U, 4U}) {
+            utility::CsvWriterOptions options;
+            options.threads = threads;
+            const std::string name = std::string("CsvWriter  ") + label + " [writer] WriteColumns " +
+                                     (precision < 0 ? "shortest" : "%.6f") + " threads=" + std::to_string(threads);
+            bench.batch(num_rows).minEpochIterations(1).minEpochTime(std::chrono::milliseconds(500));
+            bench.run(name, [&] {
+                utility::CsvWriter writer(path, {"id", "time", "value_a", "value_b", "category"}, options);
+                writer.WriteColumns(
+                    {ids,
+                     utility::CsvColumnView(times, precision),
+                     utility::CsvColumnView(values_a, precision),
+                     utility::CsvColumnView(values_b, precision),
+                     categories}
+                );
+                writer.Close();
+            });
+        }
+    }
+
+    const auto bytes = std::filesystem::file_size(path);
+    std::printf("CsvWriter  %s [writer] output: %ju bytes for %d rows\n", label, static_cast<std::uintmax_t>(bytes),
+                num_rows);
+    std::filesystem::remove(path);
 }
 
 int main() {
@@ -312,6 +1022,39 @@ int main() {
     BenchFiltered(bench, path5.string(), kNumRows5col, "[5col ]",
                   {"value_a", "value_b"}, {2, 3}, /*flag_idx=*/4);
 
+    // 並列スキャン
+    BenchParallel(bench, path5.string(), "[5col ]", {"value_a", "value_b"}, /*flag_idx=*/4);
+
+    // バッチストリーミング
+    BenchStreaming(bench, path5.string(), "[5col ]", {"value_a", "value_b"}, /*flag_idx=*/4);
+
+    // 先読み I/O（mmap / read-ahead、warm / cold）
+    BenchReadAhead(bench, path5.string(), "[5col ]", {"value_a", "value_b"}, /*flag_idx=*/4);
+
+    // 圧縮ファイル入力（非圧縮 / gzip / zstd）
+    BenchCompressed(bench, path5.string(), "[5col ]", {"value_a", "value_b"}, /*flag_idx=*/4);
+
+    // 列指向バイナリキャッシュ（cold / warm）
+    BenchColumnCache(bench, path5.string(), "[5col ]", {"value_a", "value_b"}, /*flag_idx=*/4);
+
+    // 複数問い合わせの一括走査
+    BenchMultiQuery(bench, path5.string(), kNumRows5col, "[5col ]");
+
+    // 行番号による部分読み込み（ReadRange / ReadSample）
+    BenchRowAccess(bench, path5.string(), kNumRows5col, "[5col ]");
+
+    // 列の型の推定（標本 / ファイル全体）
+    BenchSchema(bench, path5.string(), kNumRows5col, "[5col ]");
+
+    // 集計（group-by / ヒストグラム）
+    BenchAggregate(bench, path5.string(), "[5col ]", /*flag_idx=*/4);
+
+    // 文字列列の辞書符号化
+    BenchDictionary(bench, path5.string(), kNumRows5col, "[5col ]");
+
+    // 数値変換コスト（列の型別）
+    BenchConversion(bench, path5.string(), "[5col ]");
+
     // ════════════════════════════════════════════════════════════════
     // 31列 CSV (id, category, val00-val25, value_a, value_b, flag)
     // col: id(0) category(1) val00-val25(2-27) value_a(28) value_b(29) flag(30)
@@ -324,6 +1067,43 @@ int main() {
     BenchFiltered(bench, path30.string(), kNumRows31col, "[31col]",
                   {"value_a", "value_b"}, {28, 29}, /*flag_idx=*/30);
 
+    // 並列スキャン
+    BenchParallel(bench, path30.string(), "[31col]", {"value_a", "value_b"}, /*flag_idx=*/30);
+
+    // バッチストリーミング
+    BenchStreaming(bench, path30.string(), "[31col]", {"value_a", "value_b"}, /*flag_idx=*/30);
+
+    // 先読み I/O（mmap / read-ahead、warm / cold）
+    BenchReadAhead(bench, path30.string(), "[31col]", {"value_a", "value_b"}, /*flag_idx=*/30);
+
+    // 圧縮ファイル入力（非圧縮 / gzip / zstd）
+    BenchCompressed(bench, path30.string(), "[31col]", {"value_a", "value_b"}, /*flag_idx=*/30);
+
+    // 列指向バイナリキャッシュ（cold / warm）
+    BenchColumnCache(bench, path30.string(), "[31col]", {"value_a", "value_b"}, /*flag_idx=*/30);
+
+    // 複数問い合わせの一括走査
+    BenchMultiQuery(bench, path30.string(), kNumRows31col, "[31col]");
+
+    // 行番号による部分読み込み（ReadRange / ReadSample）
+    BenchRowAccess(bench, path30.string(), kNumRows31col, "[31col]");
+
+    // 列の型の推定（標本 / ファイル全体）
+    BenchSchema(bench, path30.string(), kNumRows31col, "[31col]");
+
+    // 集計（group-by / ヒストグラム）
+    BenchAggregate(bench, path30.string(), "[31col]", /*flag_idx=*/30);
+
+    // 文字列列の辞書符号化
+    BenchDictionary(bench, path30.string(), kNumRows31col, "[31col]");
+
+    // ════════════════════════════════════════════════════════════════
+    // CSV 書き出し
+    // ════════════════════════════════════════════════════════════════
+
+    // 1 行ずつのレコーダー出力と列単位の一括書き出し
+    BenchWriter(bench, kNumRows5col, "[5col ]");
+
     // ── 後片付け ──
     std::filesystem::remove(path5);
     std::filesystem::remove(path30);
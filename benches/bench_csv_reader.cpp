@@ -0,0 +1,290 @@
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include <nanobench.h>
+
+#include <csv.hpp>
+
+#include "template_cli_cpp/utility/csv_wrapper.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+// ──────────────────────────────────────────────────────────────
+// utility::CsvReader（出荷している API そのもの）のベンチマーク
+//
+// ファイルの大きさ・列数・選択率（1% / 10% / 90%）・スレッド数を変えて同じ問い合わせを流し、
+// ケースごとに rows/s（入力の全行数 / 所要時間）・bytes/s（ファイルサイズ / 所要時間）・ピーク RSS を表示する。
+// bench_csv が比較用に持つ単独実装（csv_bench::ReadFiltered_*）とは別に、
+// CsvReader 自体の性能の退行を検出するためのもの。
+// ──────────────────────────────────────────────────────────────
+
+namespace {
+
+constexpr std::uint64_t kRandomSeed = 12345;
+constexpr std::array<const char *, 5> kCategories = {"A", "B", "C", "D", "E"};
+
+// 選択率ごとのフラグ列（値が 1 の行の割合）
+struct Selectivity {
+    const char *column;
+    const char *label;
+    double ratio;
+};
+constexpr std::array<Selectivity, 3> kSelectivities = {{
+    {"sel01", " 1%", 0.01},
+    {"sel10", "10%", 0.10},
+    {"sel90", "90%", 0.90},
+}};
+
+// 入力ファイルの形（行数・追加の数値列数）
+struct Shape {
+    const char *label;
+    int num_rows;
+    int extra_cols; // val00.. の数（基本の 7 列に加える）
+};
+constexpr std::array<Shape, 3> kShapes = {{
+    {"[7col  200k]", 200'000, 0},
+    {"[7col    2M]", 2'000'000, 0},
+    {"[31col 200k]", 200'000, 24},
+}};
+
+// ──────────────────────────────────────────────────────────────
+// CSV 生成
+// 列: id, category, value_a, value_b, sel01, sel10, sel90, val00..（extra_cols 個）
+// ──────────────────────────────────────────────────────────────
+
+std::filesystem::path GenerateCsvFile(const Shape &shape, int index) {
+    const auto path = std::filesystem::temp_directory_path() / ("bench_csv_reader_" + std::to_string(index) + ".csv");
+
+    std::mt19937_64 rng(kRandomSeed);
+    std::uniform_real_distribution<double> value_dist(0.0, 1000.0);
+    std::uniform_int_distribution<int> cat_dist(0, static_cast<int>(kCategories.size()) - 1);
+    std::uniform_real_distribution<double> unit_dist(0.0, 1.0);
+
+    std::ofstream ofs(path);
+    ofs << "id,category,value_a,value_b";
+    for (const auto &selectivity : kSelectivities) {
+        ofs << ',' << selectivity.column;
+    }
+    for (int c = 0; c < shape.extra_cols; ++c) {
+        ofs << ",val" << (c < 10 ? "0" : "") << c;
+    }
+    ofs << '\n';
+    for (int i = 0; i < shape.num_rows; ++i) {
+        ofs << i << ',' << kCategories[static_cast<std::size_t>(cat_dist(rng))] << ',' << value_dist(rng) << ','
+            << value_dist(rng);
+        // 1 つの乱数で判定するため sel01 ⊂ sel10 ⊂ sel90 になる
+        const double u = unit_dist(rng);
+        for (const auto &selectivity : kSelectivities) {
+            ofs << ',' << (u < selectivity.ratio ? 1 : 0);
+        }
+        for (int c = 0; c < shape.extra_cols; ++c) {
+            ofs << ',' << value_dist(rng);
+        }
+        ofs << '\n';
+    }
+    return path;
+}
+
+// ──────────────────────────────────────────────────────────────
+// ピーク RSS（Linux の /proc/self/status の VmHWM）
+// ──────────────────────────────────────────────────────────────
+
+// /proc/self/status の key 行の値（kB）。読めなければ -1
+long ReadStatusKb(const char *key) {
+    std::ifstream ifs("/proc/self/status");
+    std::string line;
+    const std::string prefix = std::string(key) + ":";
+    while (std::getline(ifs, line)) {
+        if (line.compare(0, prefix.size(), prefix) == 0) {
+            std::istringstream iss(line.substr(prefix.size()));
+            long kb = -1;
+            iss >> kb;
+            return kb;
+        }
+    }
+    return -1;
+}
+
+// VmHWM を現在の RSS に戻す（Linux 4.0 以降の clear_refs "5"）。戻せなければ false
+// 前のケースで解放したヒープが RSS に残っていると次のケースのピークに混ざるため、先に OS へ返す
+bool ResetPeakRss() {
+#if defined(__GLIBC__)
+    ::malloc_trim(0);
+#endif
+    std::ofstream ofs("/proc/self/clear_refs");
+    ofs << "5";
+    ofs.flush();
+    return static_cast<bool>(ofs);
+}
+
+// ──────────────────────────────────────────────────────────────
+// 1 ケースの計測と結果の表示
+// ──────────────────────────────────────────────────────────────
+
+struct CaseResult {
+    std::string name;
+    double rows_per_sec;
+    double bytes_per_sec;
+    long peak_rss_kb;     ///< ケース実行中の VmHWM（peak_reset が false ならプロセス開始以降の最大）
+    long baseline_rss_kb; ///< ケース開始時の VmRSS
+    bool peak_reset;      ///< ケース開始時に VmHWM をリセットできたか
+    std::size_t matched;  ///< 最後の実行で条件を満たした行数（結果の妥当性確認用）
+};
+
+/**
+ * @brief op を nanobench で計測し、スループットとピーク RSS を記録する
+ * @param op 1 回分の読み込み。条件を満たした行数を返す
+ */
+template <typename Op>
+void RunCase(
+    ankerl::nanobench::Bench &bench,
+    std::vector<CaseResult> &results,
+    const std::string &name,
+    int num_rows,
+    std::uintmax_t file_bytes,
+    Op &&op) {
+    const bool peak_reset = ResetPeakRss();
+    const long baseline = ReadStatusKb("VmRSS");
+    std::size_t matched = 0;
+
+    bench.batch(num_rows).minEpochIterations(3).minEpochTime(std::chrono::milliseconds(300));
+    bench.run(name, [&] {
+        matched = op();
+        ankerl::nanobench::doNotOptimizeAway(matched);
+    });
+
+    // elapsed の中央値は 1 回分（ファイル全体の読み込み 1 回）の秒数
+    const double seconds = bench.results().back().median(ankerl::nanobench::Result::Measure::elapsed);
+    results.push_back(
+        {name,
+         static_cast<double>(num_rows) / seconds,
+         static_cast<double>(file_bytes) / seconds,
+         ReadStatusKb("VmHWM"),
+         baseline,
+         peak_reset,
+         matched}
+    );
+}
+
+void PrintSummary(const std::vector<CaseResult> &results) {
+    std::printf(
+        "\n%-58s %12s %10s %12s %12s %10s\n", "case", "rows/s", "MB/s", "peak RSS MB", "+ over base", "matched"
+    );
+    bool peak_reset = true;
+    for (const auto &result : results) {
+        peak_reset = peak_reset && result.peak_reset;
+        std::printf(
+            "%-58s %12.0f %10.1f %12.1f %12.1f %10zu\n",
+            result.name.c_str(),
+            result.rows_per_sec,
+            result.bytes_per_sec / 1e6,
+            static_cast<double>(result.peak_rss_kb) / 1024.0,
+            static_cast<double>(result.peak_rss_kb - result.baseline_rss_kb) / 1024.0,
+            result.matched
+        );
+    }
+    if (!peak_reset) {
+        std::printf("note: /proc/self/clear_refs is not writable; peak RSS is the maximum since process start\n");
+    }
+}
+
+// 計測するスレッド数（1, 2, 4, ハードウェアスレッド数。重複は除く）
+std::vector<unsigned int> ThreadCounts() {
+    std::vector<unsigned int> counts = {1, 2, 4, std::max(1U, std::thread::hardware_concurrency())};
+    std::sort(counts.begin(), counts.end());
+    counts.erase(std::unique(counts.begin(), counts.end()), counts.end());
+    return counts;
+}
+
+// ──────────────────────────────────────────────────────────────
+// セクション: ReadColumns（フィルタ式）の選択率 × スレッド数
+// 出力は value_a（double）と category（string）
+// ──────────────────────────────────────────────────────────────
+
+void BenchReadColumns(
+    ankerl::nanobench::Bench &bench,
+    std::vector<CaseResult> &results,
+    const std::string &path,
+    const Shape &shape) {
+    const auto file_bytes = std::filesystem::file_size(path);
+    const std::vector<utility::ColumnSpec> specs = {
+        {"value_a", utility::ColumnType::kDouble},
+        {"category", utility::ColumnType::kString},
+    };
+    for (const auto &selectivity : kSelectivities) {
+        for (const unsigned int threads : ThreadCounts()) {
+            utility::CsvReaderOptions options;
+            options.num_threads = threads;
+            const utility::CsvReader reader(path, options);
+            const auto filter = utility::Col(selectivity.column) == 1;
+            const std::string name = std::string("ReadColumns    ") + shape.label + " sel " + selectivity.label +
+                                     " threads=" + std::to_string(threads);
+            RunCase(bench, results, name, shape.num_rows, file_bytes, [&] {
+                return reader.ReadColumns(filter, specs).RowCount();
+            });
+        }
+    }
+}
+
+// ──────────────────────────────────────────────────────────────
+// セクション: その他の読み込み API（選択率 10%・1 スレッド）
+// csv::CSVRow 述語（csv-parser 経由）・ReadFiltered（double 出力）・ReadBatches（ストリーミング）
+// ──────────────────────────────────────────────────────────────
+
+void BenchOtherApis(
+    ankerl::nanobench::Bench &bench,
+    std::vector<CaseResult> &results,
+    const std::string &path,
+    const Shape &shape) {
+    const auto file_bytes = std::filesystem::file_size(path);
+    const utility::CsvReader reader(path);
+    const auto filter = utility::Col("sel10") == 1;
+    const std::vector<utility::ColumnSpec> specs = {{"value_a", utility::ColumnType::kDouble}};
+
+    const auto csv_row_predicate = [](const csv::CSVRow &row) { return row["sel10"].get<int>() == 1; };
+
+    const std::string prefix = std::string(shape.label) + " sel 10%";
+    RunCase(bench, results, "ReadColumns    " + prefix + " CSVRow predicate", shape.num_rows, file_bytes, [&] {
+        return reader.ReadColumns(csv_row_predicate, specs).RowCount();
+    });
+    RunCase(bench, results, "ReadFiltered   " + prefix, shape.num_rows, file_bytes, [&] {
+        return reader.ReadFiltered(filter, {"value_a", "value_b"}).size() / 2; // 行ごとに 2 列分の値が並ぶ
+    });
+    RunCase(bench, results, "ReadBatches    " + prefix, shape.num_rows, file_bytes, [&] {
+        std::size_t rows = 0;
+        reader.ReadBatches(filter, specs, [&](utility::ColumnTable &batch) { rows += batch.RowCount(); });
+        return rows;
+    });
+}
+
+} // namespace
+
+int main() {
+    ankerl::nanobench::Bench bench;
+    bench.title("utility::CsvReader Benchmark").unit("row");
+    std::vector<CaseResult> results;
+
+    for (std::size_t i = 0; i < kShapes.size(); ++i) {
+        const auto path = GenerateCsvFile(kShapes[i], static_cast<int>(i));
+        BenchReadColumns(bench, results, path.string(), kShapes[i]);
+        BenchOtherApis(bench, results, path.string(), kShapes[i]);
+        std::filesystem::remove(path);
+    }
+
+    PrintSummary(results);
+    return 0;
+}
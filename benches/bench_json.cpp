@@ -5,8 +5,48 @@
 #include <nlohmann/json.hpp>
 #include <yyjson.h>
 
+#include "template_cli_cpp/recording/recorder_factory.hpp"
+#include "template_cli_cpp/utility/json_lines_reader.hpp"
+#include "template_cli_cpp/utility/json_lines_writer.hpp"
 #include "template_cli_cpp/utility/yyjson_wrapper.hpp"
 
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// ──────────────────────────────────────────────────────────────
+// ヒープ確保の計数（グローバル operator new を置き換える）
+// std::string・std::vector などの確保はすべてここを通る。yyjson の確保は既定では malloc だが、
+// アリーナ版ではアリーナを通るため、両方を数えれば 1 レコードあたりの確保回数を確認できる
+// ──────────────────────────────────────────────────────────────
+
+namespace {
+std::atomic<std::uint64_t> g_heap_allocations{0};
+} // namespace
+
+// インライン展開されると GCC が malloc と operator delete、new と free の組み合わせを
+// 不一致と誤検出する（-Wmismatched-new-delete）ため、置き換えた関数は展開させない
+[[gnu::noinline]] void *operator new(std::size_t size) {
+    g_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+[[gnu::noinline]] void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
 namespace {
 
 // ──────────────────────────────────────────────────────────────
@@ -130,6 +170,338 @@ void BenchNlohmannComplex(ankerl::nanobench::Bench &bench) {
     });
 }
 
+// ──────────────────────────────────────────────────────────────
+// 計測シナリオ: 1 ステップ 1 レコードの繰り返し（NDJSON 出力のホットループ）
+// 既定のビルダーを毎回作る方式と、アリーナ版ビルダーを Clear() + SerializeTo() で使い回す方式
+// ──────────────────────────────────────────────────────────────
+
+template <typename Builder>
+void AddStepRecord(Builder &builder, int step) {
+    builder.Add("step", step);
+    builder.Add("time", step * 1e-3);
+    builder.Add("energy", 98.6 + step);
+    builder.Add("converged", (step % 2) == 0);
+    builder.Add("id", 12345);
+}
+
+void BenchYyjsonFresh(ankerl::nanobench::Bench &bench) {
+    int step = 0;
+    bench.run("yyjson_wrapper  [arena] fresh builder + Serialize", [&] {
+        utility::JsonBuilder builder;
+        AddStepRecord(builder, step++);
+        std::string s = builder.Serialize();
+        ankerl::nanobench::doNotOptimizeAway(s);
+    });
+}
+
+void BenchYyjsonArena(ankerl::nanobench::Bench &bench) {
+    utility::JsonArena arena;
+    utility::JsonBuilder builder(arena);
+    std::string line;
+    int step = 0;
+    bench.run("yyjson_wrapper  [arena] Clear + SerializeTo (reused)", [&] {
+        builder.Clear();
+        AddStepRecord(builder, step++);
+        line.clear();
+        builder.SerializeTo(line);
+        ankerl::nanobench::doNotOptimizeAway(line);
+    });
+}
+
+// ──────────────────────────────────────────────────────────────
+// 計測シナリオ: 構造体 1 つ分のレコード（6 フィールド + double[16]）
+// Add() でフィールドごとに追加する方式と、JsonField のスキーマで AddFields() する方式
+// ──────────────────────────────────────────────────────────────
+
+struct StepRecord {
+    int step;
+    double time;
+    double energy;
+    bool converged;
+    std::int64_t ticks;
+    std::string label;
+    std::vector<double> forces;
+};
+
+constexpr auto kStepRecordFields = std::make_tuple(
+    utility::JsonField{"step", &StepRecord::step},
+    utility::JsonField{"time", &StepRecord::time},
+    utility::JsonField{"energy", &StepRecord::energy},
+    utility::JsonField{"converged", &StepRecord::converged},
+    utility::JsonField{"ticks", &StepRecord::ticks},
+    utility::JsonField{"label", &StepRecord::label},
+    utility::JsonField{"forces", &StepRecord::forces}
+);
+
+StepRecord MakeStepRecord() {
+    StepRecord record{42, 0.042, 98.6, true, 1'234'567'890'123, "relax", std::vector<double>(16)};
+    for (std::size_t i = 0; i < record.forces.size(); ++i) {
+        record.forces[i] = 0.125 * static_cast<double>(i);
+    }
+    return record;
+}
+
+void BenchStructAdd(ankerl::nanobench::Bench &bench) {
+    const StepRecord record = MakeStepRecord();
+    utility::JsonArena arena;
+    utility::JsonBuilder builder(arena);
+    std::string line;
+    bench.run("yyjson_wrapper  [struct] Add per field + SerializeTo", [&] {
+        builder.Clear();
+        builder.Add("step", record.step);
+        builder.Add("time", record.time);
+        builder.Add("energy", record.energy);
+        builder.Add("converged", record.converged);
+        builder.Add("ticks", record.ticks);
+        builder.Add("label", record.label);
+        builder.Add("forces", record.forces);
+        line.clear();
+        builder.SerializeTo(line);
+        ankerl::nanobench::doNotOptimizeAway(line);
+    });
+}
+
+void BenchStructAddFields(ankerl::nanobench::Bench &bench) {
+    const StepRecord record = MakeStepRecord();
+    utility::JsonArena arena;
+    utility::JsonBuilder builder(arena);
+    std::string line;
+    bench.run("yyjson_wrapper  [struct] AddFields (schema) + SerializeTo", [&] {
+        builder.Clear();
+        builder.AddFields(record, kStepRecordFields);
+        line.clear();
+        builder.SerializeTo(line);
+        ankerl::nanobench::doNotOptimizeAway(line);
+    });
+}
+
+// 定常状態（最初のレコードで領域を確保した後）の 1 レコードあたりの確保回数を表示する
+void ReportArenaAllocations() {
+    constexpr int kRecords = 10'000;
+    utility::JsonArena arena;
+    utility::JsonBuilder builder(arena);
+    std::string line;
+    line.reserve(256);
+    for (int step = 0; step < 2; ++step) { // ブロックと出力バッファを確保させる
+        builder.Clear();
+        AddStepRecord(builder, step);
+        line.clear();
+        builder.SerializeTo(line);
+    }
+
+    const std::uint64_t heap_before = g_heap_allocations.load();
+    const std::size_t blocks_before = arena.BlockAllocations();
+    for (int step = 0; step < kRecords; ++step) {
+        builder.Clear();
+        AddStepRecord(builder, step);
+        line.clear();
+        builder.SerializeTo(line);
+    }
+    const std::uint64_t heap = g_heap_allocations.load() - heap_before;
+    const std::size_t blocks = arena.BlockAllocations() - blocks_before;
+    std::printf(
+        "yyjson_wrapper  [arena] steady state: %d records, operator new %llu, arena blocks %zu (%s)\n",
+        kRecords,
+        static_cast<unsigned long long>(heap),
+        blocks,
+        heap == 0 && blocks == 0 ? "zero allocations" : "ALLOCATES"
+    );
+}
+
+// ──────────────────────────────────────────────────────────────
+// 計測シナリオ: JSON Lines のファイル出力（1 回 = kNdjsonRecords レコード。byte/s で比較）
+// DataRecorder 経由（Serialize → fmt::format → spdlog・BufferedRecorder）と JsonLinesWriter の直接書き出し
+// ──────────────────────────────────────────────────────────────
+
+constexpr int kNdjsonRecords = 1000;
+
+// 1 回分の出力バイト数（各レコード + 改行）
+std::size_t NdjsonBytesPerRun() {
+    std::size_t bytes = 0;
+    for (int step = 0; step < kNdjsonRecords; ++step) {
+        utility::JsonBuilder builder;
+        AddStepRecord(builder, step);
+        bytes += builder.Serialize().size() + 1;
+    }
+    return bytes;
+}
+
+void BenchNdjson() {
+    const auto dir = std::filesystem::temp_directory_path();
+    ankerl::nanobench::Bench bench;
+    bench.title("JSON Lines Output Benchmark").unit("byte").batch(NdjsonBytesPerRun()).minEpochIterations(20);
+
+    {
+        const auto path = (dir / "bench_ndjson_a.jsonl").string();
+        auto recorder = recording::RecorderFactory::MakeJsonLinesFile("bench_ndjson", path);
+        recorder->Enable();
+        utility::JsonArena arena;
+        utility::JsonBuilder builder(arena);
+        bench.run("DataRecorder    Write(\"{}\", Serialize())", [&] {
+            for (int step = 0; step < kNdjsonRecords; ++step) {
+                builder.Clear();
+                AddStepRecord(builder, step);
+                recorder->Write("{}", builder.Serialize());
+            }
+        });
+        recorder->Flush();
+    }
+    {
+        // 書き出しはバックグラウンドスレッド。Flush() まで含めて全レコードがファイルに届くまでを計測する
+        auto recorder = recording::RecorderFactory::MakeBufferedFile((dir / "bench_ndjson_d.jsonl").string());
+        recorder->Enable();
+        utility::JsonArena arena;
+        utility::JsonBuilder builder(arena);
+        bench.run("BufferedRecorder Write(\"{}\", Serialize()) + Flush", [&] {
+            for (int step = 0; step < kNdjsonRecords; ++step) {
+                builder.Clear();
+                AddStepRecord(builder, step);
+                recorder->Write("{}", builder.Serialize());
+            }
+            recorder->Flush();
+        });
+    }
+    {
+        utility::JsonLinesWriter writer((dir / "bench_ndjson_b.jsonl").string());
+        utility::JsonArena arena;
+        utility::JsonBuilder builder(arena);
+        bench.run("JsonLinesWriter Write (arena builder)", [&] {
+            for (int step = 0; step < kNdjsonRecords; ++step) {
+                builder.Clear();
+                AddStepRecord(builder, step);
+                writer.Write(builder);
+            }
+        });
+        writer.Close();
+    }
+    {
+        // ドキュメントは作成済み（書き出しだけを計測する）
+        std::vector<utility::JsonBuilder> batch(kNdjsonRecords);
+        for (int step = 0; step < kNdjsonRecords; ++step) {
+            AddStepRecord(batch[static_cast<std::size_t>(step)], step);
+        }
+        utility::JsonLinesWriter writer((dir / "bench_ndjson_c.jsonl").string());
+        bench.run("JsonLinesWriter WriteBatch (prebuilt documents)", [&] { writer.WriteBatch(batch); });
+        writer.Close();
+    }
+
+    std::filesystem::remove(dir / "bench_ndjson_a.jsonl");
+    std::filesystem::remove(dir / "bench_ndjson_b.jsonl");
+    std::filesystem::remove(dir / "bench_ndjson_c.jsonl");
+    std::filesystem::remove(dir / "bench_ndjson_d.jsonl");
+}
+
+// ──────────────────────────────────────────────────────────────
+// 計測シナリオ: JSON Lines の読み込み（1 回 = ファイル全体。byte/s で比較）
+// nlohmann で 1 行ずつ解析する方式と JsonLinesReader（yyjson in-situ・並列）
+// ──────────────────────────────────────────────────────────────
+
+void BenchNdjsonRead() {
+    constexpr int kRecords = 200'000;
+    const auto path = std::filesystem::temp_directory_path() / "bench_ndjson_read.jsonl";
+    {
+        utility::JsonLinesWriter writer(path.string());
+        utility::JsonArena arena;
+        utility::JsonBuilder builder(arena);
+        for (int step = 0; step < kRecords; ++step) {
+            builder.Clear();
+            AddStepRecord(builder, step);
+            writer.Write(builder);
+        }
+    }
+
+    ankerl::nanobench::Bench bench;
+    bench.title("JSON Lines Read Benchmark").unit("byte").batch(std::filesystem::file_size(path)).minEpochIterations(3);
+
+    bench.run("nlohmann::json  getline + parse (step, energy)", [&] {
+        std::ifstream ifs(path);
+        std::vector<std::int64_t> steps;
+        std::vector<double> energies;
+        std::string line;
+        while (std::getline(ifs, line)) {
+            const auto j = nlohmann::json::parse(line);
+            steps.push_back(j["step"].get<std::int64_t>());
+            energies.push_back(j["energy"].get<double>());
+        }
+        ankerl::nanobench::doNotOptimizeAway(energies);
+    });
+
+    const std::vector<utility::ColumnSpec> specs = {
+        {"/step", utility::ColumnType::kInt64},
+        {"/energy", utility::ColumnType::kDouble},
+    };
+    std::vector<unsigned int> thread_counts = {1, std::max(1U, std::thread::hardware_concurrency())};
+    thread_counts.erase(std::unique(thread_counts.begin(), thread_counts.end()), thread_counts.end());
+    for (const unsigned int threads : thread_counts) {
+        utility::JsonLinesReaderOptions options;
+        options.num_threads = threads;
+        const utility::JsonLinesReader reader(path.string(), options);
+        bench.run("JsonLinesReader ReadColumns (step, energy) threads=" + std::to_string(threads), [&] {
+            const utility::ColumnTable table = reader.ReadColumns(specs);
+            ankerl::nanobench::doNotOptimizeAway(table.RowCount());
+        });
+    }
+
+    std::filesystem::remove(path);
+}
+
+// ──────────────────────────────────────────────────────────────
+// 計測シナリオ: 大きな数値配列（std::vector<double> の状態ベクトル。1 回 = 1 ドキュメント、element/s で比較）
+// 1 要素ずつ yyjson_mut_arr_add_real で追加する方式と JsonArrayView の一括作成（yyjson_mut_arr_with_real）
+// ──────────────────────────────────────────────────────────────
+
+std::vector<double> MakeStateVector(std::size_t size) {
+    std::vector<double> state(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        state[i] = 0.001 * static_cast<double>(i) - 1.5;
+    }
+    return state;
+}
+
+void BenchLargeArray() {
+    for (const std::size_t size : {std::size_t{10'000}, std::size_t{1'000'000}}) {
+        const std::vector<double> state = MakeStateVector(size);
+        const std::string label = "double[" + std::to_string(size) + "]";
+        const std::uint64_t iterations = size >= 1'000'000 ? 3 : 100;
+        ankerl::nanobench::Bench bench;
+        bench.title("Large Array Benchmark " + label).unit("element").batch(size).minEpochIterations(iterations);
+
+        bench.run("yyjson per-element arr_add_real + write", [&] {
+            yyjson_mut_doc *doc = yyjson_mut_doc_new(nullptr);
+            yyjson_mut_val *root = yyjson_mut_obj(doc);
+            yyjson_mut_doc_set_root(doc, root);
+            yyjson_mut_val *arr = yyjson_mut_arr(doc);
+            for (const double value : state) {
+                yyjson_mut_arr_add_real(doc, arr, value);
+            }
+            yyjson_mut_obj_add_val(doc, root, "state", arr);
+            std::size_t len = 0;
+            char *json = yyjson_mut_write(doc, YYJSON_WRITE_NOFLAG, &len);
+            ankerl::nanobench::doNotOptimizeAway(len);
+            std::free(json);
+            yyjson_mut_doc_free(doc);
+        });
+
+        utility::JsonArena arena;
+        utility::JsonBuilder builder(arena);
+        std::string out;
+        bench.run("yyjson_wrapper  Add(JsonArrayView) + SerializeTo", [&] {
+            builder.Clear();
+            builder.Add("state", utility::JsonArrayView(state));
+            out.clear();
+            builder.SerializeTo(out);
+            ankerl::nanobench::doNotOptimizeAway(out);
+        });
+
+        bench.run("nlohmann::json  j[\"state\"] = vector + dump", [&] {
+            nlohmann::json j;
+            j["state"] = state;
+            std::string s = j.dump();
+            ankerl::nanobench::doNotOptimizeAway(s);
+        });
+    }
+}
+
 } // namespace
 
 int main() {
@@ -152,5 +524,21 @@ int main() {
     BenchYyjsonComplex(bench);
     BenchNlohmannComplex(bench);
 
+    // ── 1 レコードずつの繰り返し（アリーナ）──
+    BenchYyjsonFresh(bench);
+    BenchYyjsonArena(bench);
+    ReportArenaAllocations();
+
+    // ── 構造体のスキーマ ──
+    BenchStructAdd(bench);
+    BenchStructAddFields(bench);
+
+    // ── JSON Lines のファイル出力 ──
+    BenchNdjson();
+    BenchNdjsonRead();
+
+    // ── 大きな数値配列 ──
+    BenchLargeArray();
+
     return 0;
 }
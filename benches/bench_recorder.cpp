@@ -0,0 +1,123 @@
+#define ANKERL_NANOBENCH_IMPLEMENT
+
+#include <nanobench.h>
+
+#include "template_cli_cpp/recording/binary_recorder.hpp"
+#include "template_cli_cpp/recording/recorder_factory.hpp"
+#include "template_cli_cpp/utility/csv_wrapper.hpp"
+#include "template_cli_cpp/utility/csv_writer.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// ──────────────────────────────────────────────────────────────
+// 数値時系列の記録と後処理の読み込み（1 回 = kRows 行。row/s で比較）
+// テキスト（DataRecorder::Write → fmt::format、CsvReader で解析）と
+// バイナリ（BinaryRecorder::Append で整形なし、BinaryRecordReader で mmap から memcpy）
+// ──────────────────────────────────────────────────────────────
+
+namespace {
+
+constexpr int kRows = 200'000;
+
+double Energy(int step) { return 0.5 * static_cast<double>(step) + 1.0 / (1.0 + static_cast<double>(step)); }
+
+double Time(int step) { return 1e-3 * static_cast<double>(step); }
+
+const std::vector<utility::ColumnSpec> &Schema() {
+    static const std::vector<utility::ColumnSpec> schema = {
+        {"step", utility::ColumnType::kInt64},
+        {"time", utility::ColumnType::kDouble},
+        {"energy", utility::ColumnType::kDouble},
+    };
+    return schema;
+}
+
+void BenchWrite(ankerl::nanobench::Bench &bench, const std::filesystem::path &csv, const std::filesystem::path &bin) {
+    {
+        auto recorder = recording::RecorderFactory::MakeCsvFile("bench_recorder_csv", csv.string(), "step,time,energy");
+        recorder->Enable();
+        bench.run("SpdlogRecorder  Write(\"{},{:.17g},{:.17g}\")", [&] {
+            for (int step = 0; step < kRows; ++step) {
+                recorder->Write("{},{:.17g},{:.17g}", step, Time(step), Energy(step));
+            }
+            recorder->Flush();
+        });
+    }
+    {
+        auto recorder = recording::RecorderFactory::MakeBinaryFile(bin.string(), Schema());
+        recorder->Enable();
+        bench.run("BinaryRecorder  Append(step, time, energy)", [&] {
+            for (int step = 0; step < kRows; ++step) {
+                recorder->Append(step, Time(step), Energy(step));
+            }
+            recorder->Flush();
+        });
+    }
+}
+
+// 読み込み用のファイルを kRows 行ちょうどで作り直す（書き込みの計測で繰り返し追記されているため）
+void WriteInputs(const std::filesystem::path &csv, const std::filesystem::path &bin) {
+    {
+        utility::CsvWriter writer(csv.string(), {"step", "time", "energy"});
+        std::vector<std::int64_t> steps(kRows);
+        std::vector<double> times(kRows);
+        std::vector<double> energies(kRows);
+        for (int step = 0; step < kRows; ++step) {
+            const auto row = static_cast<std::size_t>(step);
+            steps[row] = step;
+            times[row] = Time(step);
+            energies[row] = Energy(step);
+        }
+        writer.WriteColumns({
+            utility::CsvColumnView(steps.data(), steps.size()),
+            utility::CsvColumnView(times.data(), times.size()),
+            utility::CsvColumnView(energies.data(), energies.size()),
+        });
+        writer.Close();
+    }
+    recording::BinaryRecorder recorder(bin.string(), Schema());
+    recorder.Enable();
+    for (int step = 0; step < kRows; ++step) {
+        recorder.Append(step, Time(step), Energy(step));
+    }
+    recorder.Close();
+}
+
+void BenchRead(ankerl::nanobench::Bench &bench, const std::filesystem::path &csv, const std::filesystem::path &bin) {
+    const utility::CsvReader csv_reader(csv.string());
+    const auto all_rows = utility::Col("step") >= 0;
+    bench.run("CsvReader          ReadColumns (parse text)", [&] {
+        const auto table = csv_reader.ReadColumns(all_rows, Schema());
+        ankerl::nanobench::doNotOptimizeAway(table.RowCount());
+    });
+    bench.run("BinaryRecordReader ReadColumns (mmap + memcpy)", [&] {
+        const recording::BinaryRecordReader reader(bin.string());
+        const auto table = reader.ReadColumns();
+        ankerl::nanobench::doNotOptimizeAway(table.RowCount());
+    });
+}
+
+} // namespace
+
+int main() {
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto csv = dir / "bench_recorder.csv";
+    const auto bin = dir / "bench_recorder.bin";
+
+    ankerl::nanobench::Bench bench;
+    bench.title("Recorder Benchmark (text vs binary)").unit("row").batch(kRows).minEpochIterations(5);
+
+    // ── 記録（シミュレーション側の書き込み）──
+    BenchWrite(bench, csv, bin);
+
+    // ── 後処理の読み込み ──
+    WriteInputs(csv, bin);
+    BenchRead(bench, csv, bin);
+
+    std::filesystem::remove(csv);
+    std::filesystem::remove(bin);
+    return 0;
+}
@@ -32,3 +32,39 @@ if(TARGET doctest)
         )
     endif()
 endif()
+
+# zlib / zstd - 圧縮 CSV（.csv.gz / .csv.zst）入力（任意。システムにある場合のみ有効化）
+# csv_compression をリンクしたターゲットでは TEMPLATE_CLI_CPP_HAS_ZLIB / TEMPLATE_CLI_CPP_HAS_ZSTD が定義される
+add_library(csv_compression INTERFACE)
+
+find_package(ZLIB QUIET)
+if(ZLIB_FOUND)
+    message(STATUS "zlib          : ${ZLIB_VERSION_STRING} (gzip CSV input enabled)")
+    target_link_libraries(csv_compression INTERFACE ZLIB::ZLIB)
+    target_compile_definitions(csv_compression INTERFACE TEMPLATE_CLI_CPP_HAS_ZLIB=1)
+else()
+    message(STATUS "zlib          : not found (gzip CSV input disabled)")
+endif()
+
+find_package(zstd CONFIG QUIET)
+if(TARGET zstd::libzstd_shared)
+    set(_zstd_target zstd::libzstd_shared)
+elseif(TARGET zstd::libzstd_static)
+    set(_zstd_target zstd::libzstd_static)
+else()
+    find_package(PkgConfig QUIET)
+    if(PkgConfig_FOUND)
+        pkg_check_modules(ZSTD QUIET IMPORTED_TARGET libzstd)
+        if(ZSTD_FOUND)
+            set(_zstd_target PkgConfig::ZSTD)
+        endif()
+    endif()
+endif()
+if(_zstd_target)
+    message(STATUS "zstd          : ${_zstd_target} (zstd CSV input enabled)")
+    target_link_libraries(csv_compression INTERFACE ${_zstd_target})
+    target_compile_definitions(csv_compression INTERFACE TEMPLATE_CLI_CPP_HAS_ZSTD=1)
+else()
+    message(STATUS "zstd          : not found (zstd CSV input disabled)")
+endif()
+unset(_zstd_target)
@@ -1,9 +1,27 @@
 #include <template_cli_cpp/utility/yyjson_wrapper.hpp>
 
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <string>
+#include <tuple>
 #include <vector>
 
+// 結果の構造体と JSON キーの対応（構造体ごとに 1 度だけ記述する）
+struct StepResult {
+    int step;
+    double energy;
+    std::uint64_t checksum;
+    std::vector<double> forces;
+};
+
+constexpr auto kStepResultFields = std::make_tuple(
+    utility::JsonField{"step", &StepResult::step},
+    utility::JsonField{"energy", &StepResult::energy},
+    utility::JsonField{"checksum", &StepResult::checksum},
+    utility::JsonField{"forces", &StepResult::forces}
+);
+
 int main() {
     // ── フラットオブジェクト ──────────────────────────────────────
     {
@@ -62,6 +80,45 @@ int main() {
         std::cout << builder.Serialize() << "\n\n";
     }
 
+    // ── アリーナで使い回す（1 ステップ 1 レコードのホットループ向け）──
+    {
+        utility::JsonArena arena;
+        utility::JsonBuilder builder(arena);
+        std::string line;
+        std::cout << "[arena]\n";
+        for (int step = 0; step < 3; ++step) {
+            builder.Clear(); // アリーナを先頭に戻すだけ（解放・再確保なし）
+            builder.Add("step", step);
+            builder.Add("value", step * 0.5);
+            line.clear();
+            builder.SerializeTo(line); // line の容量を使い回す
+            std::cout << line << "\n";
+        }
+        std::cout << "\n";
+    }
+
+    // ── 構造体をスキーマで一括追加 ────────────────────────────────
+    {
+        const StepResult result{10, -1.5, 0xFFFF'FFFF'FFFFULL, {0.1, 0.2, 0.3}};
+        utility::JsonBuilder builder;
+        builder.AddFields(result, kStepResultFields); // 数値配列はまとめて追加される
+        std::cout << "[struct fields]\n";
+        std::cout << builder.Serialize() << "\n\n";
+    }
+
+    // ── 大きな数値配列をビューで一括追加 ──────────────────────────
+    {
+        std::vector<double> state(8);
+        for (std::size_t i = 0; i < state.size(); ++i) {
+            state[i] = 0.25 * static_cast<double>(i);
+        }
+        utility::JsonBuilder builder;
+        builder.Add("state", utility::JsonArrayView(state)); // コピーせずに参照する
+        builder.Add("head", utility::JsonArrayView(state.data(), 3)); // ポインタ + 要素数
+        std::cout << "[array view]\n";
+        std::cout << builder.Serialize() << "\n\n";
+    }
+
     // ── コンパクト vs プリティ ────────────────────────────────────
     {
         utility::JsonBuilder builder;
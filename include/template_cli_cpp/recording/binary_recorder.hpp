@@ -0,0 +1,423 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "template_cli_cpp/utility/column_table.hpp"
+#include "template_cli_cpp/utility/mapped_file.hpp"
+#include "template_cli_cpp/utility/output_file.hpp"
+
+// 値はホストのバイト順のまま書き、リトルエンディアンとして読む
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "recording::BinaryRecorder: the binary record format requires a little-endian host"
+#endif
+
+namespace recording {
+
+/**
+ * @brief BinaryRecorder のファイル形式（すべてリトルエンディアン・8 バイト境界）
+ *
+ * ```
+ * ヘッダ:   magic "TCBREC01"(8) | version u32 | 列数 u32
+ *           列ごとに: 型 u8（0: int64、1: double）| 予約 u8 | 列名の長さ u16 | 列名
+ *           8 バイト境界まで 0 埋め
+ * ブロック: 行数 u64 | 列 0 の値 × 行数 | 列 1 の値 × 行数 | ...（値はすべて 8 バイト）
+ * ```
+ *
+ * ブロックはファイル末尾まで続く。各列ブロックは 8 バイト境界に揃うため、mmap した領域を直接配列として読める。
+ */
+namespace binary_format {
+
+constexpr char kMagic[8] = {'T', 'C', 'B', 'R', 'E', 'C', '0', '1'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kAlignment = 8;
+
+inline std::uint8_t TypeCode(utility::ColumnType type) {
+    switch (type) {
+        case utility::ColumnType::kInt64:
+            return 0;
+        case utility::ColumnType::kDouble:
+            return 1;
+        default:
+            throw std::invalid_argument("recording::BinaryRecorder: only kInt64 and kDouble columns are supported");
+    }
+}
+
+} // namespace binary_format
+
+/**
+ * @brief 型付きの固定長レコードをバイナリ形式（列ブロック）でファイルに書き出すレコーダー
+ *
+ * DataRecorder::Write() は値をテキストに整形して出力するため、大量の数値時系列では整形と読み込み時の解析が
+ * 処理時間の大半を占める。BinaryRecorder は生成時に列の名前と型（kInt64 / kDouble）を宣言し、
+ * Append() で渡した値をそのまま列ごとのブロックバッファに格納する（書き込み経路での整形はない）。
+ * block_rows 行溜まるごとに 1 回の write でブロックを書き出す。結果は BinaryRecordReader で読む。
+ *
+ * テキストのレコードを受け取らないため DataRecorder は継承しない（RecorderManager には登録できない）。
+ * Enable/Disable・Flush は DataRecorder と同じ名前・動作で、初期状態は disabled。
+ *
+ * @code
+ * auto rec = recording::RecorderFactory::MakeBinaryFile(
+ *     "trace.bin", {{"step", utility::ColumnType::kInt64}, {"energy", utility::ColumnType::kDouble}}
+ * );
+ * rec->Enable();
+ * rec->Append(step, energy); // 列の順に値を渡す
+ * rec->Close();              // 書き込みエラーを例外で受け取る（デストラクタでも閉じる）
+ * @endcode
+ */
+class BinaryRecorder {
+public:
+    static constexpr std::size_t kDefaultBlockRows = 4096;
+
+    /**
+     * @brief ファイルを作成し（既存のファイルは切り詰める）、ヘッダを書く
+     * @param schema     列の名前と型（kInt64 / kDouble。列名は 65535 バイト以下）
+     * @param block_rows 1 ブロックの行数（この行数ごとに write する）
+     * @throws std::invalid_argument 列がない・列の型が kInt64 / kDouble 以外・列名が長すぎる場合
+     * @throws std::runtime_error ファイルを作成できない・ヘッダを書けない場合
+     */
+    BinaryRecorder(
+        const std::string &file_path, std::vector<utility::ColumnSpec> schema,
+        std::size_t block_rows = kDefaultBlockRows
+    )
+        : schema_(std::move(schema)),
+          block_rows_(std::max<std::size_t>(block_rows, 1)),
+          header_(EncodeHeader(schema_)),
+          file_(file_path) {
+        // block_[0] は行数、列 c の値は block_[1 + c * block_rows_] から
+        block_.resize(1 + schema_.size() * block_rows_);
+        file_.Write(header_.data(), header_.size());
+    }
+
+    BinaryRecorder(const BinaryRecorder &) = delete;
+    BinaryRecorder &operator=(const BinaryRecorder &) = delete;
+
+    ~BinaryRecorder() {
+        try {
+            Close();
+        } catch (...) {
+            // デストラクタでは報告できない（エラーを知りたい場合は Close() を呼ぶ）
+        }
+    }
+
+    /**
+     * @brief 記録を有効化する
+     */
+    void Enable() { enabled_ = true; }
+
+    /**
+     * @brief 記録を無効化する
+     */
+    void Disable() { enabled_ = false; }
+
+    /**
+     * @brief 記録が有効かを返す
+     */
+    bool IsEnabled() const noexcept { return enabled_; }
+
+    /**
+     * @brief 1 行分の値を列の順に追加する（disabled の場合は何もしない）
+     *
+     * 整数は kInt64 列・kDouble 列のどちらにも渡せる（kDouble 列では double に変換する）。
+     * 浮動小数点数は kDouble 列にだけ渡せる。
+     *
+     * @throws std::invalid_argument 値の個数が列数と異なる・浮動小数点数を kInt64 列に渡した場合
+     * @throws std::runtime_error ブロックの書き込みに失敗した・Close() 済みの場合
+     */
+    template <typename... Values>
+    void Append(Values... values) {
+        static_assert(
+            (std::is_arithmetic_v<Values> && ...), "recording::BinaryRecorder::Append: values must be arithmetic"
+        );
+        if (!enabled_) {
+            return;
+        }
+        if (sizeof...(Values) != schema_.size()) {
+            throw std::invalid_argument(
+                "recording::BinaryRecorder: expected " + std::to_string(schema_.size()) + " values, got " +
+                std::to_string(sizeof...(Values))
+            );
+        }
+        if (!file_.IsOpen()) {
+            throw std::runtime_error("recording::BinaryRecorder: file already closed: " + file_.Path());
+        }
+        std::size_t col = 0;
+        (Store(col++, values), ...);
+        if (++rows_ == block_rows_) {
+            WriteBlock();
+        }
+    }
+
+    /**
+     * @brief 溜まっている行を 1 ブロックとして書き出す
+     * @throws std::runtime_error 書き込みに失敗した場合
+     */
+    void Flush() {
+        if (file_.IsOpen()) {
+            WriteBlock();
+        }
+    }
+
+    /**
+     * @brief 残りを書き出してファイルを閉じる（2 回目以降は何もしない）
+     * @throws std::runtime_error 書き込み・クローズに失敗した場合
+     */
+    void Close() {
+        if (!file_.IsOpen()) {
+            return;
+        }
+        const std::size_t bytes = PackBlock();
+        const std::size_t rows = rows_;
+        rows_ = 0;
+        file_.Close(reinterpret_cast<const char *>(block_.data()), bytes);
+        rows_written_ += rows;
+    }
+
+    const std::vector<utility::ColumnSpec> &Schema() const noexcept { return schema_; }
+
+    /// これまでに書いた行数（バッファに溜まっている分を含む）
+    std::uint64_t RowsWritten() const noexcept { return rows_written_ + rows_; }
+
+private:
+    std::vector<utility::ColumnSpec> schema_;
+    std::size_t block_rows_;
+    std::string header_;
+    utility::OutputFile file_;
+    std::vector<std::uint64_t> block_; // 8 バイトの値を列ごとに並べたブロック（先頭は行数）
+    std::size_t rows_ = 0;             // block_ に溜まっている行数
+    std::uint64_t rows_written_ = 0;
+    bool enabled_ = false;
+
+    static std::string EncodeHeader(const std::vector<utility::ColumnSpec> &schema) {
+        if (schema.empty()) {
+            throw std::invalid_argument("recording::BinaryRecorder: schema has no columns");
+        }
+        std::string header(binary_format::kMagic, sizeof(binary_format::kMagic));
+        AppendRaw(header, binary_format::kVersion);
+        AppendRaw(header, static_cast<std::uint32_t>(schema.size()));
+        for (const auto &spec : schema) {
+            if (spec.name.size() > 0xFFFF) {
+                throw std::invalid_argument("recording::BinaryRecorder: column name too long: " + spec.name);
+            }
+            AppendRaw(header, binary_format::TypeCode(spec.type));
+            AppendRaw(header, std::uint8_t{0});
+            AppendRaw(header, static_cast<std::uint16_t>(spec.name.size()));
+            header += spec.name;
+        }
+        header.resize((header.size() + binary_format::kAlignment - 1) / binary_format::kAlignment *
+                      binary_format::kAlignment);
+        return header;
+    }
+
+    template <typename T>
+    static void AppendRaw(std::string &out, T value) {
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        out.append(bytes, sizeof(T));
+    }
+
+    template <typename T>
+    void Store(std::size_t col, T value) {
+        std::uint64_t &slot = block_[1 + col * block_rows_ + rows_];
+        if (schema_[col].type == utility::ColumnType::kDouble) {
+            const auto converted = static_cast<double>(value);
+            std::memcpy(&slot, &converted, sizeof(slot));
+        } else if constexpr (std::is_integral_v<T>) {
+            const auto converted = static_cast<std::int64_t>(value);
+            std::memcpy(&slot, &converted, sizeof(slot));
+        } else {
+            throw std::invalid_argument(
+                "recording::BinaryRecorder: floating-point value for kInt64 column: " + schema_[col].name
+            );
+        }
+    }
+
+    // 溜まっている行をブロックとして 1 回の write で書く（途中までのブロックは列を詰めてから書く）
+    void WriteBlock() {
+        if (rows_ == 0) {
+            return;
+        }
+        const std::size_t bytes = PackBlock();
+        const std::size_t rows = rows_;
+        rows_ = 0;
+        file_.Write(reinterpret_cast<const char *>(block_.data()), bytes);
+        rows_written_ += rows;
+    }
+
+    // 溜まっている rows_ 行を書き出す形（行数 + 列ごとに詰めた値）に整え、そのバイト数を返す（0 行なら 0）
+    std::size_t PackBlock() {
+        if (rows_ == 0) {
+            return 0;
+        }
+        block_[0] = rows_;
+        if (rows_ < block_rows_) {
+            for (std::size_t col = 1; col < schema_.size(); ++col) {
+                std::memmove(&block_[1 + col * rows_], &block_[1 + col * block_rows_], rows_ * sizeof(std::uint64_t));
+            }
+        }
+        return (1 + schema_.size() * rows_) * sizeof(std::uint64_t);
+    }
+};
+
+/**
+ * @brief BinaryRecorder が書いたファイルを mmap して読むリーダー
+ *
+ * 生成時にヘッダを解析してブロックの位置を索引する。値はマップした領域を直接参照するため、
+ * Int64Block() / DoubleBlock() はコピーなしで列ブロックを返す（参照先はリーダーの生存期間中有効）。
+ * ReadColumns() は全ブロックを連結した ColumnTable を返す（ブロックごとに memcpy するだけで解析はない）。
+ *
+ * @code
+ * const recording::BinaryRecordReader reader("trace.bin");
+ * const utility::ColumnTable table = reader.ReadColumns();
+ * const auto &energy = table.DoubleColumn("energy");
+ * @endcode
+ */
+class BinaryRecordReader {
+public:
+    /**
+     * @throws std::runtime_error ファイルを開けない・形式が不正な場合（マジック・バージョン・切り詰められたブロック）
+     */
+    explicit BinaryRecordReader(const std::string &path)
+        : file_(utility::MappedFile::Open(path)) {
+        ParseHeader(path);
+        IndexBlocks(path);
+    }
+
+    const std::vector<utility::ColumnSpec> &Schema() const noexcept { return schema_; }
+
+    std::size_t RowCount() const noexcept { return row_count_; }
+
+    std::size_t BlockCount() const noexcept { return blocks_.size(); }
+
+    std::size_t BlockRows(std::size_t block) const { return blocks_.at(block).rows; }
+
+    /**
+     * @brief ブロック block の int64 列 col の値（BlockRows(block) 個）
+     * @throws std::invalid_argument 列の型が kInt64 でない場合
+     */
+    const std::int64_t *Int64Block(std::size_t block, std::size_t col) const {
+        return reinterpret_cast<const std::int64_t *>(ColumnData(block, col, utility::ColumnType::kInt64));
+    }
+
+    /**
+     * @brief ブロック block の double 列 col の値（BlockRows(block) 個）
+     * @throws std::invalid_argument 列の型が kDouble でない場合
+     */
+    const double *DoubleBlock(std::size_t block, std::size_t col) const {
+        return reinterpret_cast<const double *>(ColumnData(block, col, utility::ColumnType::kDouble));
+    }
+
+    /**
+     * @brief 全ブロックを連結したテーブルを返す（列名・型はファイルのスキーマのとおり）
+     */
+    utility::ColumnTable ReadColumns() const {
+        utility::ColumnTable table(schema_);
+        table.Reserve(row_count_);
+        for (std::size_t block = 0; block < blocks_.size(); ++block) {
+            const std::size_t rows = blocks_[block].rows;
+            for (std::size_t col = 0; col < schema_.size(); ++col) {
+                if (schema_[col].type == utility::ColumnType::kInt64) {
+                    table.AppendInt64s(col, Int64Block(block, col), rows);
+                } else {
+                    table.AppendDoubles(col, DoubleBlock(block, col), rows);
+                }
+            }
+            table.CommitRows(rows);
+        }
+        return table;
+    }
+
+private:
+    struct Block {
+        std::size_t offset; // 最初の列ブロックの位置
+        std::size_t rows;
+    };
+
+    std::shared_ptr<const utility::MappedFile> file_;
+    std::vector<utility::ColumnSpec> schema_;
+    std::vector<Block> blocks_;
+    std::size_t data_begin_ = 0;
+    std::size_t row_count_ = 0;
+
+    template <typename T>
+    T ReadRaw(std::size_t offset) const {
+        T value;
+        std::memcpy(&value, file_->Data() + offset, sizeof(T));
+        return value;
+    }
+
+    void ParseHeader(const std::string &path) {
+        const std::size_t size = file_->Size();
+        std::size_t pos = sizeof(binary_format::kMagic) + 2 * sizeof(std::uint32_t);
+        if (size < pos || std::memcmp(file_->Data(), binary_format::kMagic, sizeof(binary_format::kMagic)) != 0) {
+            throw std::runtime_error("recording::BinaryRecordReader: not a binary record file: " + path);
+        }
+        const auto version = ReadRaw<std::uint32_t>(sizeof(binary_format::kMagic));
+        if (version != binary_format::kVersion) {
+            throw std::runtime_error(
+                "recording::BinaryRecordReader: unsupported version " + std::to_string(version) + ": " + path
+            );
+        }
+        const auto columns = ReadRaw<std::uint32_t>(sizeof(binary_format::kMagic) + sizeof(std::uint32_t));
+        for (std::uint32_t col = 0; col < columns; ++col) {
+            if (size - pos < 4) {
+                throw std::runtime_error("recording::BinaryRecordReader: truncated header: " + path);
+            }
+            const auto type = ReadRaw<std::uint8_t>(pos);
+            const auto name_length = ReadRaw<std::uint16_t>(pos + 2);
+            pos += 4;
+            if (type > 1 || size - pos < name_length) {
+                throw std::runtime_error("recording::BinaryRecordReader: invalid column header: " + path);
+            }
+            schema_.push_back(
+                {std::string(file_->Data() + pos, name_length),
+                 type == 0 ? utility::ColumnType::kInt64 : utility::ColumnType::kDouble}
+            );
+            pos += name_length;
+        }
+        data_begin_ = (pos + binary_format::kAlignment - 1) / binary_format::kAlignment * binary_format::kAlignment;
+        if (schema_.empty() || data_begin_ > size) {
+            throw std::runtime_error("recording::BinaryRecordReader: invalid header: " + path);
+        }
+    }
+
+    void IndexBlocks(const std::string &path) {
+        const std::size_t size = file_->Size();
+        const std::size_t row_bytes = schema_.size() * sizeof(std::uint64_t);
+        std::size_t pos = data_begin_;
+        while (pos < size) {
+            if (size - pos < sizeof(std::uint64_t)) {
+                throw std::runtime_error(
+                    "recording::BinaryRecordReader: truncated block at byte " + std::to_string(pos) + ": " + path
+                );
+            }
+            const auto rows = ReadRaw<std::uint64_t>(pos);
+            pos += sizeof(std::uint64_t);
+            if (rows > (size - pos) / row_bytes) {
+                throw std::runtime_error(
+                    "recording::BinaryRecordReader: truncated block at byte " + std::to_string(pos) + ": " + path
+                );
+            }
+            blocks_.push_back({pos, static_cast<std::size_t>(rows)});
+            row_count_ += static_cast<std::size_t>(rows);
+            pos += static_cast<std::size_t>(rows) * row_bytes;
+        }
+    }
+
+    const char *ColumnData(std::size_t block, std::size_t col, utility::ColumnType expected) const {
+        const Block &entry = blocks_.at(block);
+        if (schema_.at(col).type != expected) {
+            throw std::invalid_argument("recording::BinaryRecordReader: column type mismatch: " + schema_[col].name);
+        }
+        return file_->Data() + entry.offset + col * entry.rows * sizeof(std::uint64_t);
+    }
+};
+
+} // namespace recording
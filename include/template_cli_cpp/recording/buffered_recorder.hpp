@@ -0,0 +1,350 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "template_cli_cpp/recording/data_recorder.hpp"
+#include "template_cli_cpp/utility/output_file.hpp"
+
+namespace recording {
+
+/**
+ * @brief キューが満杯のときの Output() の動作
+ */
+enum class OverflowPolicy {
+    kBlock, ///< 空きができるまで待つ（データ欠落なし）
+    kDrop,  ///< レコードを捨てて DroppedCount() を増やす（呼び出し側を止めない）
+};
+
+/**
+ * @brief BufferedRecorder の動作設定
+ */
+struct BufferedRecorderOptions {
+    /// キューに溜められるレコード数（2 のべき乗に切り上げる）
+    std::size_t queue_capacity = 8192;
+    /// 書き出しスレッドの出力バッファがこの大きさを超えたら write する
+    std::size_t buffer_bytes = std::size_t{1} * 1024 * 1024;
+    /// キューが満杯のときの動作
+    OverflowPolicy overflow = OverflowPolicy::kBlock;
+};
+
+/**
+ * @brief 書き出しをバックグラウンドスレッドで行う解析データレコーダー
+ *
+ * SpdlogRecorder は Output() のたびに呼び出し側のスレッドでシンクのロックを取りファイルへ書く。
+ * BufferedRecorder は Output() でレコードを固定長のロックフリーキュー（複数生産者・単一消費者のリングバッファ）に
+ * コピーするだけで戻り、書き出しスレッドがキューから取り出して buffer_bytes 単位の write でファイルに書く。
+ * 各スロットの文字列は再利用するため、定常状態では Output() で malloc は発生しない。
+ *
+ * - レコードは Output() がキューの位置を確保した順にファイルへ書かれる（1 スレッドからの出力順は保たれる）
+ * - キューが満杯のときは options.overflow に従い、待つ（kBlock）か捨てて数える（kDrop）
+ * - Flush() はそれまでに受け付けたレコードがファイルに書かれるまで待つ
+ * - 書き出しスレッドでの書き込みエラーは次の Flush() で std::runtime_error として送出する
+ *
+ * 各レコードの末尾に改行を付ける（SpdlogRecorder の "%v" パターンと同じ出力になる）。
+ * 初期状態は disabled。
+ *
+ * @code
+ * recording::BufferedRecorderOptions options;
+ * options.overflow = recording::OverflowPolicy::kDrop;
+ * auto rec = recording::RecorderFactory::MakeBufferedFile("trace.csv", options);
+ * rec->Enable();
+ * rec->Write("{},{:.6f}", step, value);
+ * rec->Flush();
+ * @endcode
+ */
+class BufferedRecorder : public DataRecorder {
+public:
+    /**
+     * @brief ファイルを作成し（既存のファイルは切り詰める）、書き出しスレッドを開始する
+     * @param header 空でなければ先頭行として即時書き込む（CSV のヘッダ行等。Enable() 不要）
+     * @throws std::runtime_error ファイルを作成できない・ヘッダ行を書けない場合
+     */
+    explicit BufferedRecorder(
+        const std::string &file_path, BufferedRecorderOptions options = {}, std::string_view header = {}
+    )
+        : file_(file_path),
+          overflow_(options.overflow),
+          buffer_bytes_(std::max<std::size_t>(options.buffer_bytes, 1)),
+          mask_(RoundUpToPowerOfTwo(options.queue_capacity) - 1),
+          cells_(std::make_unique<Cell[]>(mask_ + 1)) {
+        for (std::size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        if (!header.empty()) {
+            const std::string line = std::string(header) + '\n';
+            file_.Write(line.data(), line.size());
+        }
+        buffer_.reserve(buffer_bytes_ + utility::OutputFile::kLineReserve);
+        writer_ = std::thread([this] { WriterLoop(); });
+    }
+
+    /**
+     * @brief 残りのレコードを書き出してファイルを閉じる（エラーは報告できないため Flush() で確認する）
+     */
+    ~BufferedRecorder() override {
+        {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        writer_.join();
+    }
+
+    void Enable() override { enabled_.store(true, std::memory_order_relaxed); }
+
+    void Disable() override { enabled_.store(false, std::memory_order_relaxed); }
+
+    bool IsEnabled() const override { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief message をキューに入れる（disabled の場合は何もしない）
+     *
+     * キューが満杯の場合、kBlock では書き出しスレッドがスロットを空けるまで条件変数で待ち（スピンしない）、
+     * kDrop では捨てて DroppedCount() を増やす。
+     */
+    void Output(std::string_view message) override {
+        if (!IsEnabled()) {
+            return;
+        }
+        while (!TryPush(message)) {
+            if (overflow_ == OverflowPolicy::kDrop) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            WaitForSpace();
+        }
+        // 待機中の書き出しスレッドを起こす（見逃しても kIdleWait 後には取り出される）
+        if (writer_idle_.load(std::memory_order_relaxed)) {
+            WakeWriter();
+        }
+    }
+
+    /**
+     * @brief それまでに受け付けたレコードがすべてファイルに書かれるまで待つ
+     * @throws std::runtime_error 書き出しスレッドで書き込みに失敗していた場合（1 度だけ報告する）
+     */
+    void Flush() override {
+        const std::uint64_t target = enqueue_pos_.load(std::memory_order_acquire);
+        std::unique_lock<std::mutex> lock(mutex_);
+        ++flush_waiters_;
+        wake_.notify_one();
+        flushed_.wait(lock, [&] { return written_pos_ >= target || error_ != nullptr; });
+        --flush_waiters_;
+        if (error_ != nullptr && !error_reported_) {
+            error_reported_ = true;
+            std::rethrow_exception(error_);
+        }
+    }
+
+    /// kDrop でキューが満杯のため捨てたレコード数
+    std::uint64_t DroppedCount() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+    /// キューに溜められるレコード数（2 のべき乗に切り上げた値）
+    std::size_t QueueCapacity() const noexcept { return mask_ + 1; }
+
+private:
+    // リングバッファのスロット（D. Vyukov の bounded MPMC キューの方式）
+    // sequence == 位置: 空き（生産者が書ける）、sequence == 位置 + 1: 書き込み済み（消費者が読める）
+    struct alignas(64) Cell {
+        std::atomic<std::uint64_t> sequence{0};
+        std::string data;
+    };
+
+    // キューが空の状態がこの時間続いたら、溜まっている分を書き出す
+    static constexpr std::chrono::milliseconds kIdleWait{50};
+
+    utility::OutputFile file_;
+    OverflowPolicy overflow_;
+    std::size_t buffer_bytes_;
+    std::uint64_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    alignas(64) std::atomic<std::uint64_t> enqueue_pos_{0};
+    alignas(64) std::atomic<bool> enabled_{false};
+    std::atomic<bool> writer_idle_{false};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<int> space_waiters_{0}; // キューの空きを待っている生産者の数
+
+    // 以下は書き出しスレッドだけが触る
+    std::uint64_t dequeue_pos_ = 0;
+    std::string buffer_;
+
+    // 書き出しスレッドとの同期（待機・Flush・終了）
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable flushed_;
+    std::condition_variable space_; // Drain() がスロットを空けたら kBlock で待つ生産者に通知する
+    std::uint64_t written_pos_ = 0; // この位置より前のレコードはファイルに書いた
+    int flush_waiters_ = 0;
+    bool stopping_ = false;
+    std::exception_ptr error_;
+    bool error_reported_ = false;
+
+    std::thread writer_;
+
+    static std::uint64_t RoundUpToPowerOfTwo(std::size_t value) {
+        std::uint64_t capacity = 2;
+        while (capacity < value) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    bool TryPush(std::string_view message) {
+        std::uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell *cell = nullptr;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const std::uint64_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::int64_t>(seq - pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // 満杯（消費者がまだこのスロットを空けていない）
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data.assign(message.data(), message.size());
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 書き込み済みのレコードを出力バッファへ移す（キューが空になるか、バッファが満ちたら戻る）
+    bool Drain() {
+        bool drained = false;
+        while (buffer_.size() < buffer_bytes_) {
+            Cell &cell = cells_[dequeue_pos_ & mask_];
+            if (cell.sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1) {
+                break;
+            }
+            buffer_ += cell.data;
+            buffer_ += '\n';
+            cell.sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+            ++dequeue_pos_;
+            drained = true;
+        }
+        if (drained) {
+            NotifySpace();
+        }
+        return drained;
+    }
+
+    void WakeWriter() { wake_.notify_one(); }
+
+    // 次に確保する位置のスロットが空いているか（kBlock の待機条件）
+    bool HasSpace() const {
+        const std::uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        const std::uint64_t seq = cells_[pos & mask_].sequence.load(std::memory_order_acquire);
+        return static_cast<std::int64_t>(seq - pos) >= 0;
+    }
+
+    // キューが満杯の間、書き出しスレッドを起こして空きを待つ（見逃しても kIdleWait ごとに確かめ直す）
+    void WaitForSpace() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        space_waiters_.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        WakeWriter();
+        while (!HasSpace()) {
+            space_.wait_for(lock, kIdleWait);
+        }
+        space_waiters_.fetch_sub(1);
+    }
+
+    // スロットを空けたことを待っている生産者に知らせる（待っている生産者がいなければロックを取らない）
+    void NotifySpace() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (space_waiters_.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        {
+            // 待機条件の確認と wait の間に通知が割り込まないようにする
+            const std::lock_guard<std::mutex> lock(mutex_);
+        }
+        space_.notify_all();
+    }
+
+    void WriterLoop() {
+        bool idle_timeout = false;
+        for (;;) {
+            const bool drained = Drain();
+            bool flush_requested = false;
+            bool stopping = false;
+            {
+                const std::lock_guard<std::mutex> lock(mutex_);
+                flush_requested = flush_waiters_ > 0;
+                stopping = stopping_;
+            }
+            if (buffer_.size() >= buffer_bytes_ ||
+                (!drained && (flush_requested || stopping || idle_timeout) && !buffer_.empty())) {
+                WriteBuffer();
+            }
+            if (buffer_.empty()) {
+                PublishWritten();
+            }
+            if (drained) {
+                idle_timeout = false;
+                continue;
+            }
+            if (stopping) {
+                break;
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            writer_idle_.store(true, std::memory_order_relaxed);
+            idle_timeout = !wake_.wait_for(lock, kIdleWait, [&] {
+                return stopping_ || flush_waiters_ > 0 || HasPending();
+            });
+            writer_idle_.store(false, std::memory_order_relaxed);
+        }
+        CloseFile();
+    }
+
+    bool HasPending() const {
+        return cells_[dequeue_pos_ & mask_].sequence.load(std::memory_order_acquire) == dequeue_pos_ + 1;
+    }
+
+    void WriteBuffer() {
+        // 書き込みに失敗した後は捨てる（キューを空け続けて生産者を止めない）
+        if (error_ == nullptr) {
+            try {
+                file_.Write(buffer_.data(), buffer_.size());
+            } catch (...) {
+                const std::lock_guard<std::mutex> lock(mutex_);
+                error_ = std::current_exception();
+            }
+        }
+        buffer_.clear();
+    }
+
+    void PublishWritten() {
+        {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            written_pos_ = dequeue_pos_;
+        }
+        flushed_.notify_all();
+    }
+
+    void CloseFile() {
+        try {
+            file_.Close();
+        } catch (...) {
+            // デストラクタからは報告できない
+        }
+    }
+};
+
+} // namespace recording
@@ -2,11 +2,14 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
 
+#include "template_cli_cpp/recording/binary_recorder.hpp"
+#include "template_cli_cpp/recording/buffered_recorder.hpp"
 #include "template_cli_cpp/recording/data_recorder.hpp"
 #include "template_cli_cpp/recording/null_recorder.hpp"
 #include "template_cli_cpp/recording/spdlog_recorder.hpp"
@@ -14,7 +17,7 @@
 namespace recording {
 
 /**
- * @brief DataRecorder インスタンスを生成するファクトリ
+ * @brief DataRecorder インスタンス（と BinaryRecorder）を生成するファクトリ
  *
  * 出力先・フォーマットの選択を一箇所に集約し、呼び出し側が
  * spdlog の詳細を知らなくてもよくする。
@@ -32,6 +35,17 @@ namespace recording {
  * auto jl = RecorderFactory::MakeJsonLinesFile("results", "results.jsonl");
  * jl->Enable();
  * jl->Write("{}", builder.Serialize(false));
+ *
+ * // 非同期: 書き出しはバックグラウンドスレッドが行う（大量出力向け）
+ * auto trace = RecorderFactory::MakeBufferedCsvFile("trace.csv", "step,value");
+ * trace->Enable();
+ * trace->Write("{},{:.6f}", step, value);
+ *
+ * // バイナリ: 列の型を宣言し、値を整形せずに列ブロックで書く
+ * auto bin = RecorderFactory::MakeBinaryFile("trace.bin", {{"step", utility::ColumnType::kInt64},
+ *                                                          {"value", utility::ColumnType::kDouble}});
+ * bin->Enable();
+ * bin->Append(step, value);
  * @endcode
  */
 struct RecorderFactory {
@@ -89,6 +103,55 @@ struct RecorderFactory {
         return std::make_unique<SpdlogRecorder>(inner);
     }
 
+    /**
+     * @brief ファイルに書き込む非同期レコーダーを生成する
+     *
+     * Write() はレコードを固定長のキューに入れるだけで戻り、バックグラウンドスレッドがまとめて書き出す。
+     * 出力順はキューに入った順に保たれる。Flush() はそれまでのレコードが書かれるまで待つ。
+     * DroppedCount() 等を参照できるよう BufferedRecorder として返す。初期状態は disabled。
+     *
+     * @param file_path 出力ファイルパス（既存のファイルは切り詰める）
+     * @param options   キュー容量・書き出し単位・満杯時の動作（kBlock: 待つ、kDrop: 捨てて数える）
+     */
+    static std::unique_ptr<BufferedRecorder>
+    MakeBufferedFile(const std::string &file_path, const BufferedRecorderOptions &options = {}) {
+        return std::make_unique<BufferedRecorder>(file_path, options);
+    }
+
+    /**
+     * @brief CSV ファイルに書き込む非同期レコーダーを生成する
+     *
+     * ファクトリ生成時にヘッダ行を即時書き込む。以降は MakeBufferedFile() と同じ。
+     * 初期状態は disabled（Enable() 後に Write() すること）。
+     *
+     * @param file_path 出力ファイルパス（例: "results.csv"）
+     * @param header    CSVヘッダ行（例: "step,value,label"）
+     * @param options   キュー容量・書き出し単位・満杯時の動作
+     */
+    static std::unique_ptr<BufferedRecorder> MakeBufferedCsvFile(
+        const std::string &file_path, const std::string &header, const BufferedRecorderOptions &options = {}
+    ) {
+        return std::make_unique<BufferedRecorder>(file_path, options, header);
+    }
+
+    /**
+     * @brief 型付きのレコードをバイナリ形式で書き込むレコーダーを生成する
+     *
+     * 列の名前と型（kInt64 / kDouble）をここで宣言し、Append() で渡した値を整形せずに列ブロックとして書く。
+     * 結果は BinaryRecordReader で読む。DataRecorder ではないため BinaryRecorder として返す。初期状態は disabled。
+     *
+     * @param file_path  出力ファイルパス（例: "trace.bin"）
+     * @param schema     列の名前と型（列の順に Append() へ値を渡す）
+     * @param block_rows 1 ブロックの行数（この行数ごとに write する）
+     * @throws std::invalid_argument 列がない・列の型が kInt64 / kDouble 以外の場合
+     */
+    static std::unique_ptr<BinaryRecorder> MakeBinaryFile(
+        const std::string &file_path, std::vector<utility::ColumnSpec> schema,
+        std::size_t block_rows = BinaryRecorder::kDefaultBlockRows
+    ) {
+        return std::make_unique<BinaryRecorder>(file_path, std::move(schema), block_rows);
+    }
+
     /**
      * @brief 標準出力（カラー付き）に書き込む同期レコーダーを生成する
      *
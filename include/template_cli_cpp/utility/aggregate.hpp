@@ -0,0 +1,218 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace utility {
+
+/**
+ * @brief 1 つの数値列の集計値（件数・合計・最小・最大）
+ *
+ * 値を 1 つずつ Add() し、並列集計では部分集計を Merge() で合成する。平均は Mean() で求める。
+ */
+struct AggregateStats {
+    std::uint64_t count = 0;
+    double sum = 0.0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    void Add(double value) noexcept {
+        ++count;
+        sum += value;
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+    void Merge(const AggregateStats &other) noexcept {
+        count += other.count;
+        sum += other.sum;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+
+    /**
+     * @brief 平均値（値が 1 つもなければ NaN）
+     */
+    double Mean() const noexcept {
+        return count == 0 ? std::numeric_limits<double>::quiet_NaN() : sum / static_cast<double>(count);
+    }
+};
+
+/**
+ * @brief グループ（キー文字列）ごとの集計結果
+ *
+ * グループは最初に現れた順に番号が振られる。各グループについて行数と、
+ * 集計対象の列（ValueNames() の順）ごとの AggregateStats を持つ。
+ *
+ * @code
+ * auto result = reader.ReadAggregates(utility::Col("flag") == 1, "category", {"value_a"});
+ * for (std::size_t g = 0; g < result.GroupCount(); ++g) {
+ *     std::cout << result.Key(g) << ": " << result.Stats(g, 0).Mean() << '\n';
+ * }
+ * @endcode
+ */
+class GroupedAggregates {
+public:
+    GroupedAggregates() = default;
+
+    explicit GroupedAggregates(std::vector<std::string> value_names)
+        : value_names_(std::move(value_names)) {}
+
+    const std::vector<std::string> &ValueNames() const noexcept { return value_names_; }
+    std::size_t GroupCount() const noexcept { return keys_.size(); }
+    const std::string &Key(std::size_t group) const { return keys_.at(group); }
+    std::uint64_t RowCount(std::size_t group) const { return row_counts_.at(group); }
+
+    /**
+     * @brief group 番目のグループの value 番目の列の集計値
+     */
+    const AggregateStats &Stats(std::size_t group, std::size_t value) const {
+        if (group >= keys_.size() || value >= value_names_.size()) {
+            throw std::out_of_range("utility::GroupedAggregates: index out of range");
+        }
+        return stats_[group * value_names_.size() + value];
+    }
+
+    /**
+     * @brief キーと列名で集計値を取得する
+     * @throws std::invalid_argument キーまたは列名が存在しない場合
+     */
+    const AggregateStats &Stats(std::string_view key, std::string_view value_name) const {
+        const int group = Find(key);
+        if (group < 0) {
+            throw std::invalid_argument("utility::GroupedAggregates: group not found: " + std::string(key));
+        }
+        const auto it = std::find(value_names_.begin(), value_names_.end(), value_name);
+        if (it == value_names_.end()) {
+            throw std::invalid_argument("utility::GroupedAggregates: column not found: " + std::string(value_name));
+        }
+        return Stats(static_cast<std::size_t>(group), static_cast<std::size_t>(it - value_names_.begin()));
+    }
+
+    /**
+     * @brief キーのグループ番号を返す（存在しなければ -1）
+     */
+    int Find(std::string_view key) const {
+        const auto it = index_.find(std::string(key));
+        return it == index_.end() ? -1 : static_cast<int>(it->second);
+    }
+
+    /**
+     * @brief キーのグループ番号を返す（存在しなければ末尾にグループを追加する）
+     */
+    std::size_t AddGroup(std::string_view key) {
+        // 既存キーの検索ではメモリ確保しないよう、検索用の文字列を使い回す
+        lookup_.assign(key.begin(), key.end());
+        const auto it = index_.find(lookup_);
+        if (it != index_.end()) {
+            return it->second;
+        }
+        const std::size_t group = keys_.size();
+        index_.emplace(lookup_, group);
+        keys_.push_back(lookup_);
+        row_counts_.push_back(0);
+        stats_.resize(stats_.size() + value_names_.size());
+        return group;
+    }
+
+    void CountRow(std::size_t group) noexcept { ++row_counts_[group]; }
+
+    void Add(std::size_t group, std::size_t value, double v) noexcept {
+        stats_[group * value_names_.size() + value].Add(v);
+    }
+
+    /**
+     * @brief other の集計を合成する（other にだけあるグループは other での出現順に末尾へ追加する）
+     */
+    void Merge(const GroupedAggregates &other) {
+        for (std::size_t g = 0; g < other.keys_.size(); ++g) {
+            const std::size_t group = AddGroup(other.keys_[g]);
+            row_counts_[group] += other.row_counts_[g];
+            for (std::size_t v = 0; v < value_names_.size(); ++v) {
+                stats_[group * value_names_.size() + v].Merge(other.stats_[g * value_names_.size() + v]);
+            }
+        }
+    }
+
+private:
+    std::vector<std::string> value_names_;
+    std::vector<std::string> keys_;
+    std::vector<std::uint64_t> row_counts_;
+    std::vector<AggregateStats> stats_; // [group * value_names_.size() + value]
+    std::unordered_map<std::string, std::size_t> index_;
+    std::string lookup_; // AddGroup() の検索用（使い回す）
+};
+
+/**
+ * @brief 等幅ビンのヒストグラム
+ *
+ * [lower, upper) を bins 個の等幅ビンに分けて数える。範囲外の値は Underflow() / Overflow() に数え、
+ * NaN はどこにも数えない。
+ */
+class Histogram {
+public:
+    Histogram() = default;
+
+    /**
+     * @throws std::invalid_argument bins が 0、または lower < upper でない場合
+     */
+    Histogram(double lower, double upper, std::size_t bins)
+        : lower_(lower),
+          upper_(upper),
+          counts_(bins, 0) {
+        if (bins == 0 || !(lower < upper)) {
+            throw std::invalid_argument("utility::Histogram: requires bins > 0 and lower < upper");
+        }
+        scale_ = static_cast<double>(bins) / (upper - lower);
+    }
+
+    void Add(double value) noexcept {
+        if (value < lower_) {
+            ++underflow_;
+        } else if (value >= upper_) {
+            ++overflow_;
+        } else if (value == value) {
+            // 丸めで bins になりうるため最後のビンに収める
+            const auto bin = static_cast<std::size_t>((value - lower_) * scale_);
+            ++counts_[std::min(bin, counts_.size() - 1)];
+        }
+    }
+
+    /**
+     * @brief 同じ範囲・ビン数のヒストグラムを合成する
+     */
+    void Merge(const Histogram &other) noexcept {
+        for (std::size_t i = 0; i < counts_.size() && i < other.counts_.size(); ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        underflow_ += other.underflow_;
+        overflow_ += other.overflow_;
+    }
+
+    std::size_t BinCount() const noexcept { return counts_.size(); }
+    const std::vector<std::uint64_t> &Counts() const noexcept { return counts_; }
+    std::uint64_t Underflow() const noexcept { return underflow_; }
+    std::uint64_t Overflow() const noexcept { return overflow_; }
+
+    /// bin 番目のビンの下限（bin == BinCount() で上限）
+    double BinLower(std::size_t bin) const noexcept {
+        return lower_ + (upper_ - lower_) * static_cast<double>(bin) / static_cast<double>(counts_.size());
+    }
+
+private:
+    double lower_ = 0.0;
+    double upper_ = 0.0;
+    double scale_ = 0.0;
+    std::vector<std::uint64_t> counts_;
+    std::uint64_t underflow_ = 0;
+    std::uint64_t overflow_ = 0;
+};
+
+} // namespace utility
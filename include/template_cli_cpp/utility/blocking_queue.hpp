@@ -0,0 +1,89 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace utility {
+
+/**
+ * @brief 容量制限付きのブロッキングキュー（スレッド間の受け渡し用）
+ *
+ * 満杯のときの Push() と空のときの Pop() は待機する。Close() 後は Push() が失敗し、
+ * Pop() は残りの要素を取り出し終えると false を返す。
+ * 生産者と消費者の間に置き、先行できる量を容量で制限する（メモリ使用量の上限を決める）。
+ *
+ * @code
+ * utility::BoundedBlockingQueue<Chunk> queue(2);
+ * std::thread producer([&] {
+ *     while (auto chunk = ReadNext()) {
+ *         if (!queue.Push(std::move(*chunk))) break;  // 消費者が中断した
+ *     }
+ *     queue.Close();
+ * });
+ * Chunk chunk;
+ * while (queue.Pop(chunk)) { Consume(chunk); }
+ * producer.join();
+ * @endcode
+ */
+template <typename T>
+class BoundedBlockingQueue {
+public:
+    explicit BoundedBlockingQueue(std::size_t capacity)
+        : capacity_(capacity == 0 ? 1 : capacity) {}
+
+    BoundedBlockingQueue(const BoundedBlockingQueue &) = delete;
+    BoundedBlockingQueue &operator=(const BoundedBlockingQueue &) = delete;
+
+    /**
+     * @brief 要素を追加する（満杯なら空きができるまで待つ）
+     * @return 追加できた場合 true、Close() 済みの場合 false（value は変更しない）
+     */
+    bool Push(T &&value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+        if (closed_) {
+            return false;
+        }
+        items_.push_back(std::move(value));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief 先頭の要素を取り出す（空なら要素が来るか Close() されるまで待つ）
+     * @return 取り出せた場合 true、Close() 済みで空の場合 false
+     */
+    bool Pop(T &out) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+        if (items_.empty()) {
+            return false;
+        }
+        out = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief 以降の Push() を失敗させ、待機中のスレッドをすべて起こす
+     */
+    void Close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+private:
+    std::size_t capacity_;
+    std::deque<T> items_;
+    bool closed_ = false;
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+};
+
+} // namespace utility
@@ -0,0 +1,533 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace utility {
+
+/**
+ * @brief ColumnTable の列の型
+ */
+enum class ColumnType : std::uint8_t {
+    kInt64,
+    kDouble,
+    kString,
+    kDictionary, ///< 辞書符号化した文字列（種類の少ない列向け。文字列は種類ごとに 1 つだけ保持する）
+};
+
+/**
+ * @brief 取得したい列の指定（列名と格納型）
+ */
+struct ColumnSpec {
+    std::string name; ///< 列名
+    ColumnType type;  ///< 格納型
+};
+
+/**
+ * @brief 64 バイト境界に揃えた連続バッファ
+ *
+ * 列データの格納先。先頭アドレスがキャッシュライン境界に揃うため、
+ * 列ごとの集計ループがアラインされたベクトルロードで処理できる。
+ * trivially copyable な型のみを対象とし、再確保は memcpy で行う。
+ *
+ * @tparam T 要素型（trivially copyable であること）
+ */
+template <typename T>
+class AlignedBuffer {
+    static_assert(std::is_trivially_copyable_v<T>, "AlignedBuffer requires a trivially copyable element type");
+
+public:
+    static constexpr std::size_t kAlignment = 64;
+
+    AlignedBuffer() = default;
+
+    // コピー禁止、ムーブ許可
+    AlignedBuffer(const AlignedBuffer &) = delete;
+    AlignedBuffer &operator=(const AlignedBuffer &) = delete;
+
+    AlignedBuffer(AlignedBuffer &&other) noexcept
+        : data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0)),
+          capacity_(std::exchange(other.capacity_, 0)) {}
+
+    AlignedBuffer &operator=(AlignedBuffer &&other) noexcept {
+        if (this != &other) {
+            Deallocate(data_);
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            capacity_ = std::exchange(other.capacity_, 0);
+        }
+        return *this;
+    }
+
+    ~AlignedBuffer() { Deallocate(data_); }
+
+    /**
+     * @brief 少なくとも capacity 要素分の領域を確保する
+     */
+    void Reserve(std::size_t capacity) {
+        if (capacity <= capacity_) {
+            return;
+        }
+        T *fresh = Allocate(capacity);
+        if (size_ > 0) {
+            std::memcpy(fresh, data_, size_ * sizeof(T));
+        }
+        Deallocate(data_);
+        data_ = fresh;
+        capacity_ = capacity;
+    }
+
+    void PushBack(const T &value) {
+        if (size_ == capacity_) {
+            Reserve(std::max<std::size_t>(16, capacity_ * 2));
+        }
+        data_[size_++] = value;
+    }
+
+    /**
+     * @brief count 要素をまとめて末尾に追加する
+     */
+    void Append(const T *values, std::size_t count) {
+        if (count == 0) {
+            return;
+        }
+        if (size_ + count > capacity_) {
+            Reserve(std::max(size_ + count, capacity_ * 2));
+        }
+        std::memcpy(data_ + size_, values, count * sizeof(T));
+        size_ += count;
+    }
+
+    void Clear() noexcept { size_ = 0; }
+
+    const T *Data() const noexcept { return data_; }
+    T *Data() noexcept { return data_; }
+    std::size_t Size() const noexcept { return size_; }
+    std::size_t Capacity() const noexcept { return capacity_; }
+    bool Empty() const noexcept { return size_ == 0; }
+
+    const T &operator[](std::size_t i) const noexcept { return data_[i]; }
+    T &operator[](std::size_t i) noexcept { return data_[i]; }
+
+    // range-for 用
+    const T *begin() const noexcept { return data_; }
+    const T *end() const noexcept { return data_ + size_; }
+
+private:
+    T *data_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t capacity_ = 0;
+
+    static T *Allocate(std::size_t count) {
+        return static_cast<T *>(::operator new(count * sizeof(T), std::align_val_t{kAlignment}));
+    }
+
+    static void Deallocate(T *ptr) noexcept {
+        if (ptr != nullptr) {
+            ::operator delete(ptr, std::align_val_t{kAlignment});
+        }
+    }
+};
+
+/**
+ * @brief 文字列データをまとめて保持するアリーナ
+ *
+ * 64KB 単位のチャンクに文字列を詰めて格納し、格納先を指す string_view を返す。
+ * チャンクは解放されるまで移動しないため、返した string_view はアリーナ（または
+ * Merge() でチャンクを引き取った側）が生存している間有効である。
+ */
+class StringArena {
+public:
+    static constexpr std::size_t kChunkSize = std::size_t{64} * 1024;
+
+    StringArena() = default;
+    StringArena(const StringArena &) = delete;
+    StringArena &operator=(const StringArena &) = delete;
+
+    StringArena(StringArena &&other) noexcept
+        : chunks_(std::move(other.chunks_)),
+          cursor_(std::exchange(other.cursor_, nullptr)),
+          remaining_(std::exchange(other.remaining_, 0)) {}
+
+    StringArena &operator=(StringArena &&other) noexcept {
+        if (this != &other) {
+            chunks_ = std::move(other.chunks_);
+            cursor_ = std::exchange(other.cursor_, nullptr);
+            remaining_ = std::exchange(other.remaining_, 0);
+        }
+        return *this;
+    }
+
+    ~StringArena() = default;
+
+    /**
+     * @brief 文字列をアリーナにコピーし、コピー先を指す string_view を返す
+     */
+    std::string_view Store(std::string_view text) {
+        if (text.empty()) {
+            return {};
+        }
+        if (text.size() > remaining_) {
+            // チャンクより大きい文字列は専用チャンクに置き、現在のチャンクは使い続ける
+            if (text.size() > kChunkSize / 4) {
+                chunks_.push_back(std::make_unique<char[]>(text.size()));
+                std::memcpy(chunks_.back().get(), text.data(), text.size());
+                return {chunks_.back().get(), text.size()};
+            }
+            chunks_.push_back(std::make_unique<char[]>(kChunkSize));
+            cursor_ = chunks_.back().get();
+            remaining_ = kChunkSize;
+        }
+        std::memcpy(cursor_, text.data(), text.size());
+        const std::string_view stored{cursor_, text.size()};
+        cursor_ += text.size();
+        remaining_ -= text.size();
+        return stored;
+    }
+
+    /**
+     * @brief 他のアリーナのチャンクを引き取る（格納済み string_view は有効なまま）
+     */
+    void Merge(StringArena &&other) {
+        for (auto &chunk : other.chunks_) {
+            chunks_.push_back(std::move(chunk));
+        }
+        other.chunks_.clear();
+        other.cursor_ = nullptr;
+        other.remaining_ = 0;
+    }
+
+private:
+    std::vector<std::unique_ptr<char[]>> chunks_;
+    char *cursor_ = nullptr;
+    std::size_t remaining_ = 0;
+};
+
+/**
+ * @brief 辞書符号化された文字列列（ColumnTable の kDictionary 列）
+ *
+ * 異なる文字列を出現順に 1 つずつ辞書（Values()）に保持し、各行は辞書内の位置（コード）だけを持つ。
+ * category のように種類の少ない列では、行ごとに文字列を持つ kString 列よりメモリが小さく、
+ * コードの比較・集計で文字列比較を避けられる。コードは 32 bit のため、異なる文字列は 2^32 種類まで
+ * （超える追加は std::runtime_error）。
+ *
+ * @code
+ * const auto &category = table.DictionaryColumn("category");
+ * std::vector<std::size_t> counts(category.Values().size());
+ * for (std::uint32_t code : category.Codes()) {
+ *     ++counts[code];
+ * }
+ * std::string_view first = category[0];
+ * @endcode
+ */
+class DictionaryColumn {
+public:
+    /// 各行のコード（Values() 内の位置）
+    const AlignedBuffer<std::uint32_t> &Codes() const noexcept { return codes_; }
+
+    /// 辞書（最初に現れた順）
+    const std::vector<std::string_view> &Values() const noexcept { return values_; }
+
+    std::size_t Size() const noexcept { return codes_.Size(); }
+
+    /// row 行目の文字列
+    std::string_view operator[](std::size_t row) const noexcept { return values_[codes_[row]]; }
+
+    /**
+     * @brief 文字列のコードを返す（辞書になければ -1）
+     */
+    std::int64_t CodeOf(std::string_view value) const {
+        const auto it = index_.find(value);
+        return it == index_.end() ? -1 : static_cast<std::int64_t>(it->second);
+    }
+
+private:
+    friend class ColumnTable;
+
+    AlignedBuffer<std::uint32_t> codes_;
+    std::vector<std::string_view> values_;
+    std::unordered_map<std::string_view, std::uint32_t> index_;
+
+    static constexpr std::size_t kMaxValues = std::size_t{std::numeric_limits<std::uint32_t>::max()} + 1;
+
+    // 辞書にない文字列は owned（呼び出し側が所有権を保証した string_view）として追加する
+    // 辞書が満杯（次のコードを 32 bit で表せない）なら std::runtime_error
+    std::uint32_t Encode(std::string_view owned) {
+        if (values_.size() >= kMaxValues) {
+            const auto it = index_.find(owned);
+            if (it == index_.end()) {
+                throw std::runtime_error("utility::DictionaryColumn: too many distinct values (max 2^32)");
+            }
+            return it->second;
+        }
+        const auto [it, inserted] = index_.emplace(owned, static_cast<std::uint32_t>(values_.size()));
+        if (inserted) {
+            values_.push_back(owned);
+        }
+        return it->second;
+    }
+};
+
+/**
+ * @brief 列指向（struct-of-arrays）の読み込み結果
+ *
+ * 要求された列ごとに 64 バイト境界に揃えた連続バッファを 1 本ずつ持つ。
+ * 列の型は ColumnSpec で指定し、int64 / double / string / 辞書符号化文字列を混在できる。
+ * string 列は string_view の配列で、参照先の文字列はテーブル自身が保持する
+ * （内部アリーナ、または Retain() で登録した所有者）。
+ * 辞書符号化列（kDictionary）は異なる文字列だけを内部アリーナに保持し、行ごとには 32 bit のコードを持つ。
+ *
+ * 使用例:
+ * @code
+ * utility::ColumnTable table({{"id", utility::ColumnType::kInt64},
+ *                             {"value_a", utility::ColumnType::kDouble}});
+ * table.AppendInt64(0, 42);
+ * table.AppendDouble(1, 1.5);
+ * table.CommitRow();
+ *
+ * double sum = 0.0;
+ * for (double v : table.DoubleColumn("value_a")) {
+ *     sum += v;
+ * }
+ * @endcode
+ */
+class ColumnTable {
+public:
+    ColumnTable() = default;
+
+    /**
+     * @brief コンストラクタ
+     * @param specs 列の指定（格納順）
+     */
+    explicit ColumnTable(const std::vector<ColumnSpec> &specs) {
+        columns_.reserve(specs.size());
+        for (const auto &spec : specs) {
+            columns_.push_back(Column{spec, {}, {}, {}, {}});
+        }
+    }
+
+    /**
+     * @brief 全列について rows 行分の領域を事前確保する
+     */
+    void Reserve(std::size_t rows) {
+        for (auto &column : columns_) {
+            switch (column.spec.type) {
+                case ColumnType::kInt64:
+                    column.int64s.Reserve(rows);
+                    break;
+                case ColumnType::kDouble:
+                    column.doubles.Reserve(rows);
+                    break;
+                case ColumnType::kString:
+                    column.strings.Reserve(rows);
+                    break;
+                case ColumnType::kDictionary:
+                    column.dictionary.codes_.Reserve(rows);
+                    break;
+            }
+        }
+    }
+
+    /**
+     * @brief 行数を取得
+     */
+    std::size_t RowCount() const noexcept { return row_count_; }
+
+    /**
+     * @brief 列数を取得
+     */
+    std::size_t ColumnCount() const noexcept { return columns_.size(); }
+
+    /**
+     * @brief 列の指定を取得
+     */
+    const ColumnSpec &Spec(std::size_t col) const { return columns_.at(col).spec; }
+
+    /**
+     * @brief 列名から列位置を取得
+     * @throws std::invalid_argument 列名が存在しない場合
+     */
+    std::size_t IndexOf(std::string_view name) const {
+        for (std::size_t i = 0; i < columns_.size(); ++i) {
+            if (columns_[i].spec.name == name) {
+                return i;
+            }
+        }
+        throw std::invalid_argument("utility::ColumnTable: column not found: " + std::string(name));
+    }
+
+    /**
+     * @brief int64 列を取得
+     * @throws std::invalid_argument 列の型が kInt64 でない場合
+     */
+    const AlignedBuffer<std::int64_t> &Int64Column(std::size_t col) const {
+        return CheckedColumn(col, ColumnType::kInt64).int64s;
+    }
+    const AlignedBuffer<std::int64_t> &Int64Column(std::string_view name) const { return Int64Column(IndexOf(name)); }
+
+    /**
+     * @brief double 列を取得
+     * @throws std::invalid_argument 列の型が kDouble でない場合
+     */
+    const AlignedBuffer<double> &DoubleColumn(std::size_t col) const {
+        return CheckedColumn(col, ColumnType::kDouble).doubles;
+    }
+    const AlignedBuffer<double> &DoubleColumn(std::string_view name) const { return DoubleColumn(IndexOf(name)); }
+
+    /**
+     * @brief string 列を取得（参照先はテーブルの生存期間中有効）
+     * @throws std::invalid_argument 列の型が kString でない場合
+     */
+    const AlignedBuffer<std::string_view> &StringColumn(std::size_t col) const {
+        return CheckedColumn(col, ColumnType::kString).strings;
+    }
+    const AlignedBuffer<std::string_view> &StringColumn(std::string_view name) const {
+        return StringColumn(IndexOf(name));
+    }
+
+    /**
+     * @brief 辞書符号化列を取得（参照先はテーブルの生存期間中有効）
+     * @throws std::invalid_argument 列の型が kDictionary でない場合
+     */
+    const utility::DictionaryColumn &DictionaryColumn(std::size_t col) const {
+        return CheckedColumn(col, ColumnType::kDictionary).dictionary;
+    }
+    const utility::DictionaryColumn &DictionaryColumn(std::string_view name) const {
+        return DictionaryColumn(IndexOf(name));
+    }
+
+    // ──────────────────────────────────────────────────────────
+    // 構築用 API（リーダー実装が使用する）
+    // 1 行分の値を各列に追加したあと CommitRow() を呼ぶ
+    // ──────────────────────────────────────────────────────────
+
+    void AppendInt64(std::size_t col, std::int64_t value) { columns_[col].int64s.PushBack(value); }
+
+    void AppendDouble(std::size_t col, double value) { columns_[col].doubles.PushBack(value); }
+
+    /**
+     * @brief 文字列を内部アリーナにコピーして追加する
+     */
+    void AppendString(std::size_t col, std::string_view value) { columns_[col].strings.PushBack(arena_.Store(value)); }
+
+    /**
+     * @brief 文字列をコピーせずに追加する（参照先の所有者は Retain() で登録すること）
+     */
+    void AppendStringView(std::size_t col, std::string_view value) { columns_[col].strings.PushBack(value); }
+
+    /**
+     * @brief 辞書符号化列に文字列を追加する（辞書にない文字列だけを内部アリーナにコピーする）
+     * @throws std::runtime_error 辞書が満杯（異なる文字列が 2^32 種類）の場合
+     */
+    void AppendDictionary(std::size_t col, std::string_view value) {
+        auto &dictionary = columns_[col].dictionary;
+        const auto it = dictionary.index_.find(value);
+        const std::uint32_t code = it != dictionary.index_.end() ? it->second : dictionary.Encode(arena_.Store(value));
+        dictionary.codes_.PushBack(code);
+    }
+
+    void CommitRow() noexcept { ++row_count_; }
+
+    /**
+     * @brief 連続した値をまとめて追加する（列ごとに同じ件数を追加したあと CommitRows() を呼ぶ）
+     */
+    void AppendInt64s(std::size_t col, const std::int64_t *values, std::size_t count) {
+        columns_[col].int64s.Append(values, count);
+    }
+
+    void AppendDoubles(std::size_t col, const double *values, std::size_t count) {
+        columns_[col].doubles.Append(values, count);
+    }
+
+    void CommitRows(std::size_t count) noexcept { row_count_ += count; }
+
+    /**
+     * @brief 参照先バッファの所有者をテーブルに保持させる
+     *
+     * AppendStringView() で追加した string_view の参照先を、テーブルの生存期間中維持する。
+     */
+    void Retain(std::shared_ptr<const void> owner) { owners_.push_back(std::move(owner)); }
+
+    /**
+     * @brief 同じ列構成のテーブルを末尾に連結する（並列スキャンの結果結合用）
+     * @throws std::invalid_argument 列構成が異なる場合
+     * @throws std::runtime_error 連結した辞書符号化列の異なる文字列が 2^32 種類を超える場合
+     */
+    void AppendTable(ColumnTable &&other) {
+        if (other.columns_.size() != columns_.size()) {
+            throw std::invalid_argument("utility::ColumnTable: column layout mismatch");
+        }
+        for (std::size_t i = 0; i < columns_.size(); ++i) {
+            auto &dst = columns_[i];
+            const auto &src = other.columns_[i];
+            if (dst.spec.type != src.spec.type) {
+                throw std::invalid_argument("utility::ColumnTable: column layout mismatch: " + dst.spec.name);
+            }
+            dst.int64s.Append(src.int64s.Data(), src.int64s.Size());
+            dst.doubles.Append(src.doubles.Data(), src.doubles.Size());
+            dst.strings.Append(src.strings.Data(), src.strings.Size());
+            AppendDictionaryCodes(dst.dictionary, src.dictionary);
+        }
+        row_count_ += other.row_count_;
+        arena_.Merge(std::move(other.arena_));
+        for (auto &owner : other.owners_) {
+            owners_.push_back(std::move(owner));
+        }
+        other = ColumnTable{};
+    }
+
+private:
+    struct Column {
+        ColumnSpec spec;
+        AlignedBuffer<std::int64_t> int64s;
+        AlignedBuffer<double> doubles;
+        AlignedBuffer<std::string_view> strings;
+        utility::DictionaryColumn dictionary;
+    };
+
+    std::vector<Column> columns_;
+    std::size_t row_count_ = 0;
+    StringArena arena_;
+    std::vector<std::shared_ptr<const void>> owners_;
+
+    // src のコードを dst の辞書のコードに付け替えて追加する
+    // src の辞書の文字列は src のアリーナ（AppendTable() で引き取る）を指すためコピーしない
+    static void AppendDictionaryCodes(utility::DictionaryColumn &dst, const utility::DictionaryColumn &src) {
+        std::vector<std::uint32_t> remap(src.values_.size());
+        bool identity = true;
+        for (std::size_t code = 0; code < src.values_.size(); ++code) {
+            remap[code] = dst.Encode(src.values_[code]);
+            identity = identity && remap[code] == code;
+        }
+        if (identity) {
+            dst.codes_.Append(src.codes_.Data(), src.codes_.Size());
+            return;
+        }
+        dst.codes_.Reserve(dst.codes_.Size() + src.codes_.Size());
+        for (std::uint32_t code : src.codes_) {
+            dst.codes_.PushBack(remap[code]);
+        }
+    }
+
+    const Column &CheckedColumn(std::size_t col, ColumnType expected) const {
+        const auto &column = columns_.at(col);
+        if (column.spec.type != expected) {
+            throw std::invalid_argument("utility::ColumnTable: column type mismatch: " + column.spec.name);
+        }
+        return column;
+    }
+};
+
+} // namespace utility
@@ -0,0 +1,393 @@
+#pragma once
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <istream>
+#include <memory>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "template_cli_cpp/utility/mapped_file.hpp"
+#include "template_cli_cpp/utility/read_ahead_file.hpp"
+
+// zlib / zstd はビルド時に見つかった場合のみ有効（CMake の csv_compression ターゲットが定義する）
+#if TEMPLATE_CLI_CPP_HAS_ZLIB
+#include <zlib.h>
+#endif
+#if TEMPLATE_CLI_CPP_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+namespace utility {
+
+/**
+ * @brief 入力ファイルの圧縮形式
+ */
+enum class CompressionFormat : std::uint8_t {
+    kNone, ///< 非圧縮
+    kGzip, ///< gzip（.gz。複数メンバーの連結を含む）
+    kZstd, ///< Zstandard（.zst。複数フレームの連結を含む）
+};
+
+/**
+ * @brief ファイル先頭のマジックバイトから圧縮形式を判定する（拡張子は見ない）
+ * @throws std::runtime_error ファイルを開けない場合
+ */
+inline CompressionFormat DetectCompression(const std::string &path) {
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs) {
+        throw std::runtime_error("utility::DetectCompression: cannot open file: " + path);
+    }
+    unsigned char magic[4] = {};
+    ifs.read(reinterpret_cast<char *>(magic), sizeof(magic));
+    const auto got = ifs.gcount();
+    if (got >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) {
+        return CompressionFormat::kGzip;
+    }
+    if (got == 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd) {
+        return CompressionFormat::kZstd;
+    }
+    return CompressionFormat::kNone;
+}
+
+#if TEMPLATE_CLI_CPP_HAS_ZLIB
+
+/**
+ * @brief gzip ファイルを先頭から伸長して読む ByteSource（zlib）
+ *
+ * 入力は mmap し、連結された複数のメンバー（`cat a.gz b.gz` 形式）は続けて伸長する。
+ */
+class GzipSource : public ByteSource {
+public:
+    /**
+     * @throws std::runtime_error ファイルを開けない・zlib を初期化できない場合
+     */
+    explicit GzipSource(const std::string &path)
+        : input_(MappedFile::Open(path)),
+          next_(input_->Data()),
+          remaining_(input_->Size()) {
+        // 15 + 32: 最大ウィンドウ、gzip / zlib ヘッダを自動判定
+        if (inflateInit2(&stream_, 15 + 32) != Z_OK) {
+            throw std::runtime_error("utility::GzipSource: cannot initialize zlib: " + path);
+        }
+    }
+
+    GzipSource(const GzipSource &) = delete;
+    GzipSource &operator=(const GzipSource &) = delete;
+
+    ~GzipSource() override { inflateEnd(&stream_); }
+
+    /**
+     * @throws std::runtime_error 入力が壊れている・途中で切れている場合
+     */
+    std::size_t Read(char *out, std::size_t size) override {
+        std::size_t done = 0;
+        while (done < size && !finished_) {
+            Refill();
+            const auto room = static_cast<uInt>(std::min<std::size_t>(size - done, UINT_MAX));
+            stream_.next_out = reinterpret_cast<Bytef *>(out + done);
+            stream_.avail_out = room;
+            const int rc = inflate(&stream_, Z_NO_FLUSH);
+            done += room - stream_.avail_out;
+            if (rc == Z_STREAM_END) {
+                // 後ろに別のメンバーが続く場合は伸長をやり直す
+                Refill();
+                if (stream_.avail_in == 0) {
+                    finished_ = true;
+                } else if (inflateReset(&stream_) != Z_OK) {
+                    throw std::runtime_error("utility::GzipSource: cannot reset zlib stream");
+                }
+            } else if (rc == Z_BUF_ERROR && stream_.avail_in == 0 && remaining_ == 0) {
+                throw std::runtime_error("utility::GzipSource: truncated input");
+            } else if (rc != Z_OK && rc != Z_BUF_ERROR) {
+                throw std::runtime_error(
+                    std::string("utility::GzipSource: corrupt input: ") + (stream_.msg != nullptr ? stream_.msg : "")
+                );
+            }
+        }
+        return done;
+    }
+
+private:
+    std::shared_ptr<const MappedFile> input_;
+    const char *next_;      // まだ zlib に渡していない入力の先頭
+    std::size_t remaining_; // まだ zlib に渡していない入力のバイト数
+    z_stream stream_{};
+    bool finished_ = false;
+
+    // avail_in は 32 bit のため、4GB を超える入力は分けて渡す
+    void Refill() noexcept {
+        if (stream_.avail_in != 0 || remaining_ == 0) {
+            return;
+        }
+        const auto chunk = static_cast<uInt>(std::min<std::size_t>(remaining_, UINT_MAX));
+        stream_.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(next_));
+        stream_.avail_in = chunk;
+        next_ += chunk;
+        remaining_ -= chunk;
+    }
+};
+
+#endif // TEMPLATE_CLI_CPP_HAS_ZLIB
+
+#if TEMPLATE_CLI_CPP_HAS_ZSTD
+
+/**
+ * @brief zstd ファイルを先頭から伸長して読む ByteSource
+ *
+ * 入力は mmap する。複数フレームからなるファイル（`zstd -B` / `--rsyncable` や、フレームごとに
+ * 圧縮して連結したもの）は、フレームを最大 threads 個まで並列に伸長し、先頭から順に返す。
+ * 単一フレームのファイルは 1 スレッドでストリーム伸長する。
+ */
+class ZstdSource : public ByteSource {
+public:
+    /**
+     * @param threads 並列に伸長するフレーム数の上限（1 なら逐次）
+     * @throws std::runtime_error ファイルを開けない・フレーム境界を解析できない場合
+     */
+    explicit ZstdSource(const std::string &path, unsigned int threads = 1)
+        : input_(MappedFile::Open(path)),
+          threads_(std::max(1U, threads)) {
+        const char *data = input_->Data();
+        const std::size_t size = input_->Size();
+        for (std::size_t pos = 0; pos < size;) {
+            const std::size_t frame = ZSTD_findFrameCompressedSize(data + pos, size - pos);
+            if (ZSTD_isError(frame)) {
+                throw std::runtime_error(
+                    "utility::ZstdSource: corrupt input: " + path + ": " + ZSTD_getErrorName(frame)
+                );
+            }
+            frames_.push_back({pos, frame});
+            pos += frame;
+        }
+        if (frames_.size() <= 1 || threads_ == 1) {
+            stream_ = ZSTD_createDStream();
+            if (stream_ == nullptr) {
+                throw std::runtime_error("utility::ZstdSource: cannot create zstd stream");
+            }
+            input_buffer_ = {data, size, 0};
+        }
+    }
+
+    ZstdSource(const ZstdSource &) = delete;
+    ZstdSource &operator=(const ZstdSource &) = delete;
+
+    ~ZstdSource() override {
+        // 伸長中のフレームの完了を待ってから入力のマップを解除する
+        pending_.clear();
+        if (stream_ != nullptr) {
+            ZSTD_freeDStream(stream_);
+        }
+    }
+
+    /**
+     * @throws std::runtime_error 入力が壊れている・途中で切れている場合
+     */
+    std::size_t Read(char *out, std::size_t size) override {
+        return stream_ != nullptr ? ReadStream(out, size) : ReadFrames(out, size);
+    }
+
+private:
+    struct Frame {
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    std::shared_ptr<const MappedFile> input_;
+    unsigned int threads_;
+    std::vector<Frame> frames_;
+
+    // 逐次伸長
+    ZSTD_DStream *stream_ = nullptr;
+    ZSTD_inBuffer input_buffer_{};
+    std::size_t last_result_ = 0; // 直前の ZSTD_decompressStream の戻り値（0 ならフレームの終端）
+
+    // フレーム並列伸長
+    std::size_t next_frame_ = 0;                   // 次に伸長を始めるフレーム
+    std::deque<std::future<std::string>> pending_; // 伸長中のフレーム（フレーム順）
+    std::string current_;                          // 返している途中のフレーム
+    std::size_t current_pos_ = 0;
+
+    std::size_t ReadStream(char *out, std::size_t size) {
+        ZSTD_outBuffer output{out, size, 0};
+        while (output.pos < output.size) {
+            const std::size_t before_in = input_buffer_.pos;
+            const std::size_t before_out = output.pos;
+            const std::size_t result = ZSTD_decompressStream(stream_, &output, &input_buffer_);
+            if (ZSTD_isError(result)) {
+                throw std::runtime_error(
+                    std::string("utility::ZstdSource: corrupt input: ") + ZSTD_getErrorName(result)
+                );
+            }
+            last_result_ = result;
+            if (input_buffer_.pos == before_in && output.pos == before_out) {
+                // 入力を使い切り、出力も進まない: 末尾
+                if (last_result_ != 0) {
+                    throw std::runtime_error("utility::ZstdSource: truncated input");
+                }
+                break;
+            }
+        }
+        return output.pos;
+    }
+
+    std::size_t ReadFrames(char *out, std::size_t size) {
+        std::size_t done = 0;
+        while (done < size) {
+            if (current_pos_ == current_.size()) {
+                LaunchFrames();
+                if (pending_.empty()) {
+                    break;
+                }
+                current_ = pending_.front().get();
+                pending_.pop_front();
+                current_pos_ = 0;
+                LaunchFrames();
+                continue;
+            }
+            const std::size_t n = std::min(size - done, current_.size() - current_pos_);
+            std::memcpy(out + done, current_.data() + current_pos_, n);
+            done += n;
+            current_pos_ += n;
+        }
+        return done;
+    }
+
+    // 伸長中のフレームが threads_ 個になるまで次のフレームの伸長を始める
+    void LaunchFrames() {
+        while (pending_.size() < threads_ && next_frame_ < frames_.size()) {
+            const Frame frame = frames_[next_frame_++];
+            pending_.push_back(std::async(std::launch::async, [this, frame] { return DecompressFrame(frame); }));
+        }
+    }
+
+    std::string DecompressFrame(const Frame &frame) const {
+        const char *src = input_->Data() + frame.offset;
+        const unsigned long long content_size = ZSTD_getFrameContentSize(src, frame.size);
+        std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> context(ZSTD_createDCtx(), &ZSTD_freeDCtx);
+        if (!context) {
+            throw std::runtime_error("utility::ZstdSource: cannot create zstd context");
+        }
+        std::string out;
+        if (content_size != ZSTD_CONTENTSIZE_UNKNOWN && content_size != ZSTD_CONTENTSIZE_ERROR) {
+            out.resize(static_cast<std::size_t>(content_size));
+            const std::size_t got = ZSTD_decompressDCtx(context.get(), out.data(), out.size(), src, frame.size);
+            if (ZSTD_isError(got)) {
+                throw std::runtime_error(std::string("utility::ZstdSource: corrupt input: ") + ZSTD_getErrorName(got));
+            }
+            out.resize(got);
+            return out;
+        }
+        // 伸長後のサイズがヘッダにないフレームはストリームで伸長する
+        ZSTD_inBuffer input{src, frame.size, 0};
+        std::size_t result = 1;
+        while (input.pos < input.size || result != 0) {
+            const std::size_t used = out.size();
+            out.resize(used + ZSTD_DStreamOutSize());
+            ZSTD_outBuffer output{out.data() + used, out.size() - used, 0};
+            result = ZSTD_decompressStream(context.get(), &output, &input);
+            if (ZSTD_isError(result)) {
+                throw std::runtime_error(
+                    std::string("utility::ZstdSource: corrupt input: ") + ZSTD_getErrorName(result)
+                );
+            }
+            out.resize(used + output.pos);
+            if (input.pos == input.size && output.pos == 0 && result != 0) {
+                throw std::runtime_error("utility::ZstdSource: truncated input");
+            }
+        }
+        return out;
+    }
+};
+
+#endif // TEMPLATE_CLI_CPP_HAS_ZSTD
+
+/**
+ * @brief 圧縮ファイルを伸長しながら先頭から読む ByteSource を作る
+ * @param threads 並列伸長に使うスレッド数（複数フレームの zstd のみ有効）
+ * @throws std::runtime_error ファイルを開けない・その形式に対応せずにビルドされた場合
+ */
+inline std::unique_ptr<ByteSource> OpenDecompressed(
+    const std::string &path,
+    CompressionFormat format,
+    [[maybe_unused]] unsigned int threads = 1) {
+    switch (format) {
+        case CompressionFormat::kNone:
+            return std::make_unique<FileSource>(path);
+        case CompressionFormat::kGzip:
+#if TEMPLATE_CLI_CPP_HAS_ZLIB
+            return std::make_unique<GzipSource>(path);
+#else
+            throw std::runtime_error("utility::OpenDecompressed: built without zlib (gzip) support: " + path);
+#endif
+        case CompressionFormat::kZstd:
+#if TEMPLATE_CLI_CPP_HAS_ZSTD
+            return std::make_unique<ZstdSource>(path, threads);
+#else
+            throw std::runtime_error("utility::OpenDecompressed: built without zstd support: " + path);
+#endif
+    }
+    throw std::invalid_argument("utility::OpenDecompressed: unknown compression format");
+}
+
+/**
+ * @brief ByteSource を先頭から読む std::istream（csv-parser など istream を受け取る解析器に伸長結果を渡す）
+ *
+ * ByteSource の所有権を持ち、kBufferBytes ずつ読み込んで供給する。シーク・書き込みはできない。
+ * ByteSource::Read が投げた例外は istream の状態にせずそのまま呼び出し元へ伝える。
+ *
+ * @code
+ * utility::ByteSourceStream stream(utility::OpenDecompressed(path, utility::DetectCompression(path)));
+ * csv::CSVReader reader(stream, csv::CSVFormat());
+ * @endcode
+ */
+class ByteSourceStream : public std::istream {
+public:
+    static constexpr std::size_t kBufferBytes = std::size_t{1} << 20;
+
+    explicit ByteSourceStream(std::unique_ptr<ByteSource> source)
+        : std::istream(nullptr),
+          buffer_(std::move(source)) {
+        rdbuf(&buffer_);
+        exceptions(std::ios::badbit); // streambuf の例外を握りつぶさない
+    }
+
+    ByteSourceStream(const ByteSourceStream &) = delete;
+    ByteSourceStream &operator=(const ByteSourceStream &) = delete;
+
+private:
+    class Buffer : public std::streambuf {
+    public:
+        explicit Buffer(std::unique_ptr<ByteSource> source)
+            : source_(std::move(source)),
+              data_(kBufferBytes) {}
+
+    protected:
+        int_type underflow() override {
+            if (gptr() < egptr()) {
+                return traits_type::to_int_type(*gptr());
+            }
+            const std::size_t got = source_->Read(data_.data(), data_.size());
+            if (got == 0) {
+                return traits_type::eof();
+            }
+            setg(data_.data(), data_.data(), data_.data() + got);
+            return traits_type::to_int_type(*gptr());
+        }
+
+    private:
+        std::unique_ptr<ByteSource> source_;
+        std::vector<char> data_;
+    };
+
+    Buffer buffer_;
+};
+
+} // namespace utility
@@ -0,0 +1,628 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "template_cli_cpp/utility/csv_row_view.hpp"
+#include "template_cli_cpp/utility/csv_tokenizer.hpp"
+#include "template_cli_cpp/utility/mapped_file.hpp"
+#include "template_cli_cpp/utility/numeric_parse.hpp"
+#include "template_cli_cpp/utility/sidecar_file.hpp"
+
+namespace utility {
+
+
+/**
+ * @brief CSV ファイルの列指向バイナリキャッシュ（サイドカーファイル）
+ *
+ * CSV を一度だけトークナイズし、列ごとに型付きの配列として保存する。以降はキャッシュを mmap するだけで
+ * 任意の行・列のフィールドを取り出せるため、同じファイルへの繰り返しクエリでトークナイズ
+ * （区切り文字・クォート・改行の走査）と数値の解析が不要になる。
+ * 列指向なので、フィルタ式のように参照列が決まっている場合は必要な列のページだけを読む。
+ *
+ * 列の保存形式（ColumnKind）は作成時に列ごとに決める:
+ * - kInt64: 空でないフィールドがすべて整数で、書式化し直すと元の文字列と一致する列。int64 配列のみ（空は kNullInt64）
+ * - kDouble: 同じく固定小数点表記（最短表記、または列内で揃った小数点以下の桁数）で元の文字列に戻せる列。
+ *   double 配列のみ（空は NaN）
+ * - kString: それ以外。アンエスケープ済みのバイト列 + フィールド境界のオフセット配列
+ *   （バイト列が 4GiB 未満なら uint32、それ以上なら uint64）
+ *
+ * 数値列は元の文字列を持たないが、元の表記を値から復元できる列だけを数値列にするため
+ * Field() は CSV と同じ文字列を返す（"1.50" と "1.5" が混在するような列は kString になる）。
+ *
+ * キャッシュは元ファイルの正規化したパス・サイズ・更新時刻を記録し、どれかが変わっていれば
+ * 無効（再作成が必要）とする（cache_dir を共有する別のファイルのキャッシュを誤って開かない）。
+ *
+ * ファイル形式（ネイティブエンディアン、各セクションは 64 バイト境界に整列）:
+ * - ヘッダ: マジック（8 バイト）、元ファイルのサイズ・更新時刻、行数、列数、元ファイルのパスの位置・長さ
+ * - 列ディレクトリ: 列ごとに列名の位置・長さ、保存形式、小数点以下の桁数、配列の位置、バイト列の位置・長さ、
+ *   オフセットの幅
+ * - 列名、元ファイルのパス
+ * - 列データ: 数値列は int64 / double 配列（× 行数）、文字列列はオフセット配列（× (行数 + 1)）とバイト列
+ * - 末尾: マジック（8 バイト。書き込みが最後まで終わったことの確認）
+ *
+ * @code
+ * const auto cache_path = utility::CsvColumnCache::PathFor("data.csv", "");
+ * auto cache = utility::CsvColumnCache::OpenOrBuild("data.csv", cache_path);
+ * utility::CsvTypedValue scratch;
+ * std::string_view first = cache->Field(0, 0, scratch);
+ * @endcode
+ */
+class CsvColumnCache {
+public:
+    /// キャッシュファイル名の拡張子（元ファイル名の後ろに付ける）
+    static constexpr const char *kExtension = ".colcache";
+
+    /// 列の保存形式
+    enum class ColumnKind : std::uint8_t { kString, kInt64, kDouble };
+
+    /// 整数列の空フィールドを表す値（この値そのものを含む列は整数列にしない）
+    static constexpr std::int64_t kNullInt64 = std::numeric_limits<std::int64_t>::min();
+
+    /**
+     * @brief csv_path に対応するキャッシュファイルのパスを返す
+     * @param cache_dir キャッシュを置くディレクトリ（空なら CSV と同じディレクトリ）。
+     *        指定した場合はファイル名に CSV の正規化したパスのハッシュを含める（SidecarPath()）
+     */
+    static std::string PathFor(const std::string &csv_path, const std::string &cache_dir) {
+        return SidecarPath(csv_path, cache_dir, kExtension);
+    }
+
+    /**
+     * @brief 有効なキャッシュを開く
+     * @return キャッシュがない・元ファイルと一致しない・壊れている場合は nullptr
+     */
+    static std::shared_ptr<const CsvColumnCache> Open(const std::string &csv_path, const std::string &cache_path) {
+        std::error_code ec;
+        if (!std::filesystem::is_regular_file(cache_path, ec)) {
+            return nullptr;
+        }
+        const SourceStamp stamp = StampOf(csv_path, kOwner);
+        std::shared_ptr<CsvColumnCache> cache(new CsvColumnCache(MappedFile::Open(cache_path)));
+        if (!cache->Load(stamp)) {
+            return nullptr;
+        }
+        return cache;
+    }
+
+    /**
+     * @brief CSV を解析してキャッシュファイルを作る（既存のファイルは置き換える）
+     *
+     * CSV を 2 回走査する。1 回目で行数と列ごとの保存形式・大きさを決めて各セクションの位置を確定し、
+     * 2 回目で kBuildBlockRows 行ずつ列ごとの配列に変換して一時ファイルの各セクションに書き足す
+     * （作成中に保持するのは 1 ブロック分の配列だけで、ファイル全体を展開しない）。
+     * 一時ファイルに書き出してから rename するため、読み込み中のプロセスが中途半端な
+     * キャッシュを見ることはない。列数がヘッダより少ない行は空フィールドで補い、多い行は切り詰める。
+     *
+     * @throws std::runtime_error CSV の読み込み、またはキャッシュの書き込みに失敗した場合
+     */
+    static void Build(const std::string &csv_path, const std::string &cache_path, char delimiter = ',') {
+        // 読み込み前に記録する（作成中に元ファイルが更新されれば次回の Open() で無効になる）
+        const SourceStamp stamp = StampOf(csv_path, kOwner);
+        const auto source = MappedFile::Open(csv_path);
+
+        std::vector<std::string> names;
+        std::vector<ColumnLayout> columns;
+        const std::uint64_t row_count = ScanLayout(source->View(), delimiter, names, columns);
+
+        // 全セクションの位置を決める
+        std::uint64_t pos = kHeaderSize + kDirectoryEntrySize * columns.size();
+        for (std::size_t col = 0; col < columns.size(); ++col) {
+            columns[col].name_pos = pos;
+            pos += names[col].size();
+        }
+        const std::uint64_t path_pos = pos;
+        pos += stamp.path.size();
+        for (auto &column : columns) {
+            column.values_pos = pos = AlignUp(pos);
+            if (column.kind == ColumnKind::kString) {
+                pos += column.OffsetBytes() * (row_count + 1);
+                column.data_pos = pos = AlignUp(pos);
+                pos += column.text_bytes;
+            } else {
+                pos += sizeof(std::uint64_t) * row_count;
+            }
+        }
+        const std::uint64_t footer_pos = AlignUp(pos);
+
+        WriteFileAtomically(cache_path, kOwner, [&](std::ofstream &ofs) {
+            std::string head(kMagic, sizeof(kMagic));
+            auto put = [&head](auto value) { head.append(reinterpret_cast<const char *>(&value), sizeof(value)); };
+            put(stamp.size);
+            put(stamp.mtime);
+            put(row_count);
+            put(static_cast<std::uint64_t>(columns.size()));
+            put(path_pos);
+            put(static_cast<std::uint64_t>(stamp.path.size()));
+            for (std::size_t col = 0; col < columns.size(); ++col) {
+                const ColumnLayout &column = columns[col];
+                put(column.name_pos);
+                put(static_cast<std::uint64_t>(names[col].size()));
+                put(static_cast<std::uint64_t>(column.kind));
+                put(static_cast<std::int64_t>(column.precision));
+                put(column.values_pos);
+                put(column.data_pos);
+                put(column.kind == ColumnKind::kString ? column.text_bytes : std::uint64_t{0});
+                put(static_cast<std::uint64_t>(column.kind == ColumnKind::kString ? column.OffsetBytes() : 0));
+            }
+            for (const auto &name : names) {
+                head += name;
+            }
+            head += stamp.path;
+            WriteAt(ofs, 0, head.data(), head.size());
+
+            WriteColumnData(ofs, source->View(), delimiter, columns, row_count);
+            WriteAt(ofs, footer_pos, kMagic, sizeof(kMagic));
+        });
+    }
+
+    /**
+     * @brief 有効なキャッシュを開き、なければ作成してから開く
+     * @throws std::runtime_error CSV の読み込み、またはキャッシュの作成に失敗した場合
+     */
+    static std::shared_ptr<const CsvColumnCache> OpenOrBuild(
+        const std::string &csv_path,
+        const std::string &cache_path,
+        char delimiter = ',') {
+        if (auto cache = Open(csv_path, cache_path)) {
+            return cache;
+        }
+        Build(csv_path, cache_path, delimiter);
+        auto cache = Open(csv_path, cache_path);
+        if (!cache) {
+            // 作成直後に元ファイルが更新された
+            throw std::runtime_error("utility::CsvColumnCache: source changed while building cache: " + csv_path);
+        }
+        return cache;
+    }
+
+    const CsvHeader &Header() const noexcept { return header_; }
+    std::size_t RowCount() const noexcept { return row_count_; }
+    std::size_t ColumnCount() const noexcept { return columns_.size(); }
+
+    /// 元 CSV ファイルのバイト数（1 行あたりのバイト数の見積もりに使う）
+    std::uint64_t SourceSize() const noexcept { return source_size_; }
+
+    /// col 列の保存形式
+    ColumnKind Kind(std::size_t col) const noexcept { return columns_[col].kind; }
+
+    /**
+     * @brief col 列の int64 配列（要素数は RowCount()）
+     * @return 整数列でなければ nullptr。空フィールドの要素は kNullInt64
+     */
+    const std::int64_t *Int64s(std::size_t col) const noexcept { return columns_[col].int64s; }
+
+    /**
+     * @brief col 列の double 配列（要素数は RowCount()）
+     * @return 浮動小数点列でなければ nullptr。空フィールドの要素は NaN
+     */
+    const double *Doubles(std::size_t col) const noexcept { return columns_[col].doubles; }
+
+    /**
+     * @brief col 列 row 行目を、文字列列は text に、数値列は typed に取り出す
+     *
+     * 文字列列と空フィールドでは typed を Reset() し、text にフィールド（キャッシュのマップ領域を指す）を設定する。
+     * 数値列の空でないフィールドでは typed に値を設定し、text は空にする。
+     */
+    void ReadField(std::size_t col, std::size_t row, std::string_view &text, CsvTypedValue &typed) const noexcept {
+        const Column &column = columns_[col];
+        text = {};
+        typed.Reset();
+        switch (column.kind) {
+            case ColumnKind::kInt64:
+                if (column.int64s[row] != kNullInt64) {
+                    typed.SetInt64(column.int64s[row]);
+                }
+                return;
+            case ColumnKind::kDouble:
+                if (!std::isnan(column.doubles[row])) {
+                    typed.SetDouble(column.doubles[row], column.precision);
+                }
+                return;
+            case ColumnKind::kString: {
+                const bool narrow = column.offsets32 != nullptr;
+                const std::uint64_t begin = narrow ? column.offsets32[row] : column.offsets[row];
+                const std::uint64_t end = narrow ? column.offsets32[row + 1] : column.offsets[row + 1];
+                text = {column.data + begin, static_cast<std::size_t>(end - begin)};
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief col 列 row 行目のフィールドの文字列
+     * @param scratch 数値列の値を書式化する作業領域（戻り値はこの領域を指しうる）
+     */
+    std::string_view Field(std::size_t col, std::size_t row, CsvTypedValue &scratch) const noexcept {
+        std::string_view text;
+        ReadField(col, row, text, scratch);
+        return scratch.GetKind() == CsvTypedValue::Kind::kNone ? text : scratch.Text();
+    }
+
+    /**
+     * @brief col 列 row 行目を数値として取り出す（CsvFieldView::TryGet<double> と同じ結果）
+     * @return 数値として解釈できた場合 true
+     */
+    bool TryGetNumber(std::size_t col, std::size_t row, double &out) const noexcept {
+        const Column &column = columns_[col];
+        switch (column.kind) {
+            case ColumnKind::kInt64:
+                if (column.int64s[row] == kNullInt64) {
+                    return false;
+                }
+                out = static_cast<double>(column.int64s[row]);
+                return true;
+            case ColumnKind::kDouble:
+                if (std::isnan(column.doubles[row])) {
+                    return false;
+                }
+                out = column.doubles[row];
+                return true;
+            case ColumnKind::kString:
+                break;
+        }
+        std::string_view text;
+        CsvTypedValue unused;
+        ReadField(col, row, text, unused);
+        return ParseNumber(text, out);
+    }
+
+    /**
+     * @brief キャッシュファイルのマップ（ReadField() が返す文字列の所有者）
+     */
+    const std::shared_ptr<const MappedFile> &Mapping() const noexcept { return mapping_; }
+
+private:
+    static constexpr const char *kOwner = "utility::CsvColumnCache";
+    static constexpr char kMagic[8] = {'T', 'C', 'C', 'S', 'V', 'C', '0', '3'};
+    static constexpr std::uint64_t kAlignment = 64;
+    // マジック・元ファイルのサイズ・更新時刻・行数・列数・元ファイルのパスの位置・長さ
+    static constexpr std::uint64_t kHeaderSize = 8 + 8 * 6;
+    // 列名の位置・長さ、保存形式、小数点以下の桁数、配列の位置、バイト列の位置・長さ、オフセットの幅
+    // （バイト列・オフセットの幅は文字列列以外は 0）
+    static constexpr std::uint64_t kDirectoryEntrySize = 8 * 8;
+    // 作成時に一度に変換して書き出す行数
+    static constexpr std::size_t kBuildBlockRows = 4096;
+
+    struct Column {
+        ColumnKind kind;
+        int precision;                  // kDouble の小数点以下の桁数（CsvTypedValue::kShortest は最短表記）
+        const std::uint64_t *offsets;   // kString のみ（バイト列が 4GiB 以上の場合）
+        const std::uint32_t *offsets32; // kString のみ（バイト列が 4GiB 未満の場合）
+        const char *data;               // kString のみ
+        const std::int64_t *int64s;     // kInt64 のみ
+        const double *doubles;          // kDouble のみ
+    };
+
+    // 作成時の列の保存形式と各セクションの位置
+    struct ColumnLayout {
+        ColumnKind kind = ColumnKind::kString;
+        int precision = CsvTypedValue::kShortest;
+        std::uint64_t text_bytes = 0; // フィールドの長さの合計（kString のバイト列の長さ）
+        std::uint64_t name_pos = 0;
+        std::uint64_t values_pos = 0; // 数値配列、または kString のオフセット配列
+        std::uint64_t data_pos = 0;   // kString のバイト列
+
+        std::uint64_t OffsetBytes() const noexcept {
+            return text_bytes <= std::numeric_limits<std::uint32_t>::max() ? sizeof(std::uint32_t)
+                                                                           : sizeof(std::uint64_t);
+        }
+    };
+
+    // 列を数値列として保存できるか（空でないフィールドの文字列を値から復元できるか）を調べる
+    struct KindCandidates {
+        bool int64 = true;
+        bool shortest = true; // 最短の固定小数点表記で復元できる
+        bool fixed = true;    // 小数点以下の桁数をそろえた固定小数点表記で復元できる
+        int precision = -1;   // fixed の桁数（最初の空でないフィールドで決める）
+
+        void Check(std::string_view field) {
+            if (field.empty()) {
+                return;
+            }
+            char text[CsvTypedValue::kMaxText];
+            if (int64) {
+                std::int64_t value = 0;
+                const auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+                int64 = ec == std::errc{} && ptr == field.data() + field.size() && value != kNullInt64 &&
+                        Same(text, CsvTypedValue::FormatInt64(value, text), field);
+            }
+            if (!shortest && !fixed) {
+                return;
+            }
+            // NaN は空フィールドの印に使うため、値そのものが NaN になる列は数値列にしない
+            double value = 0.0;
+            if (!ParseNumber(field, value) || std::isnan(value)) {
+                shortest = fixed = false;
+                return;
+            }
+            if (shortest) {
+                shortest = Same(text, CsvTypedValue::FormatDouble(value, CsvTypedValue::kShortest, text), field);
+            }
+            if (fixed) {
+                if (precision < 0) {
+                    const std::size_t dot = field.find('.');
+                    precision = dot == std::string_view::npos ? 0 : static_cast<int>(field.size() - dot - 1);
+                }
+                fixed = Same(text, CsvTypedValue::FormatDouble(value, precision, text), field);
+            }
+        }
+
+        void Decide(ColumnLayout &column) const {
+            if (int64) {
+                column.kind = ColumnKind::kInt64;
+            } else if (shortest || fixed) {
+                column.kind = ColumnKind::kDouble;
+                column.precision = shortest ? CsvTypedValue::kShortest : precision;
+            } else {
+                column.kind = ColumnKind::kString;
+            }
+        }
+
+        static bool Same(const char *text, std::size_t size, std::string_view field) {
+            return size != 0 && std::string_view(text, size) == field;
+        }
+    };
+
+    // 作成時に書き出し待ちの 1 ブロック分の列データ
+    struct PendingColumn {
+        std::vector<std::int64_t> int64s;
+        std::vector<double> doubles;
+        std::vector<std::uint64_t> offsets;
+        std::vector<std::uint32_t> offsets32;
+        std::string data;
+        std::uint64_t values_pos = 0; // 次に書く位置
+        std::uint64_t data_pos = 0;
+        std::uint64_t text_end = 0; // これまでに書いたバイト列の長さ
+    };
+
+    std::shared_ptr<const MappedFile> mapping_;
+    CsvHeader header_;
+    std::size_t row_count_ = 0;
+    std::uint64_t source_size_ = 0;
+    std::vector<Column> columns_;
+
+    explicit CsvColumnCache(std::shared_ptr<const MappedFile> mapping)
+        : mapping_(std::move(mapping)) {}
+
+    static std::uint64_t AlignUp(std::uint64_t pos) { return (pos + kAlignment - 1) / kAlignment * kAlignment; }
+
+    static void WriteAt(std::ofstream &out, std::uint64_t pos, const void *data, std::size_t size) {
+        if (size == 0) {
+            return;
+        }
+        out.seekp(static_cast<std::streamoff>(pos));
+        out.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+    }
+
+    static void AppendOffset(PendingColumn &pending, const ColumnLayout &column, std::uint64_t offset) {
+        if (column.OffsetBytes() == sizeof(std::uint32_t)) {
+            pending.offsets32.push_back(static_cast<std::uint32_t>(offset));
+        } else {
+            pending.offsets.push_back(offset);
+        }
+    }
+
+    // 1 回目の走査: 列名と行数を読み、列ごとに保存形式とバイト列の長さを決める
+    static std::uint64_t ScanLayout(
+        std::string_view bytes,
+        char delimiter,
+        std::vector<std::string> &names,
+        std::vector<ColumnLayout> &columns) {
+        CsvTokenizer tokenizer(bytes, delimiter);
+        std::vector<std::string_view> fields;
+        tokenizer.NextRow(fields);
+        names.assign(fields.begin(), fields.end());
+        columns.assign(names.size(), ColumnLayout{});
+        std::vector<KindCandidates> candidates(names.size());
+        std::uint64_t row_count = 0;
+        while (tokenizer.NextRow(fields)) {
+            for (std::size_t col = 0; col < std::min(fields.size(), names.size()); ++col) {
+                columns[col].text_bytes += fields[col].size();
+                candidates[col].Check(fields[col]);
+            }
+            ++row_count;
+        }
+        for (std::size_t col = 0; col < columns.size(); ++col) {
+            candidates[col].Decide(columns[col]);
+        }
+        return row_count;
+    }
+
+    // 2 回目の走査: kBuildBlockRows 行ずつ列ごとの配列に変換し、各列のセクションの続きに書く
+    static void WriteColumnData(
+        std::ofstream &out,
+        std::string_view bytes,
+        char delimiter,
+        const std::vector<ColumnLayout> &columns,
+        std::uint64_t row_count) {
+        std::vector<PendingColumn> pending(columns.size());
+        for (std::size_t col = 0; col < columns.size(); ++col) {
+            pending[col].values_pos = columns[col].values_pos;
+            pending[col].data_pos = columns[col].data_pos;
+            if (columns[col].kind == ColumnKind::kString) {
+                AppendOffset(pending[col], columns[col], 0);
+            }
+        }
+        auto flush = [&] {
+            for (auto &column : pending) {
+                auto write_values = [&](auto &values) {
+                    const std::size_t size = sizeof(values[0]) * values.size();
+                    WriteAt(out, column.values_pos, values.data(), size);
+                    column.values_pos += size;
+                    values.clear();
+                };
+                write_values(column.int64s);
+                write_values(column.doubles);
+                write_values(column.offsets);
+                write_values(column.offsets32);
+                WriteAt(out, column.data_pos, column.data.data(), column.data.size());
+                column.data_pos += column.data.size();
+                column.data.clear();
+            }
+        };
+
+        CsvTokenizer tokenizer(bytes, delimiter);
+        std::vector<std::string_view> fields;
+        tokenizer.NextRow(fields);
+        std::uint64_t row = 0;
+        while (tokenizer.NextRow(fields)) {
+            for (std::size_t col = 0; col < columns.size(); ++col) {
+                const std::string_view field = col < fields.size() ? fields[col] : std::string_view();
+                PendingColumn &column = pending[col];
+                bool parsed = true;
+                switch (columns[col].kind) {
+                    case ColumnKind::kInt64: {
+                        std::int64_t value = kNullInt64;
+                        parsed = field.empty() || ParseNumber(field, value);
+                        column.int64s.push_back(value);
+                        break;
+                    }
+                    case ColumnKind::kDouble: {
+                        double value = std::numeric_limits<double>::quiet_NaN();
+                        parsed = field.empty() || ParseNumber(field, value);
+                        column.doubles.push_back(value);
+                        break;
+                    }
+                    case ColumnKind::kString:
+                        column.data.append(field);
+                        column.text_end += field.size();
+                        AppendOffset(column, columns[col], column.text_end);
+                        break;
+                }
+                if (!parsed) {
+                    throw std::runtime_error("utility::CsvColumnCache: source changed while building cache");
+                }
+            }
+            if (++row % kBuildBlockRows == 0) {
+                flush();
+            }
+        }
+        if (row != row_count) {
+            throw std::runtime_error("utility::CsvColumnCache: source changed while building cache");
+        }
+        flush();
+    }
+
+    // ヘッダと列ディレクトリを検証して列を解決する（不一致・破損なら false）
+    bool Load(const SourceStamp &stamp) {
+        const char *base = mapping_->Data();
+        const std::uint64_t size = mapping_->Size();
+        if (size < kHeaderSize + sizeof(kMagic) || std::memcmp(base, kMagic, sizeof(kMagic)) != 0 ||
+            std::memcmp(base + size - sizeof(kMagic), kMagic, sizeof(kMagic)) != 0) {
+            return false;
+        }
+        auto read_u64 = [base](std::uint64_t pos) {
+            std::uint64_t value = 0;
+            std::memcpy(&value, base + pos, sizeof(value));
+            return value;
+        };
+        const std::uint64_t source_size = read_u64(8);
+        const auto source_mtime = static_cast<std::int64_t>(read_u64(16));
+        const std::uint64_t row_count = read_u64(24);
+        const std::uint64_t column_count = read_u64(32);
+        const std::uint64_t path_pos = read_u64(40);
+        const std::uint64_t path_len = read_u64(48);
+        if (source_size != stamp.size || source_mtime != stamp.mtime) {
+            return false;
+        }
+        if (column_count > (size - kHeaderSize) / kDirectoryEntrySize || row_count >= size / sizeof(std::uint64_t)) {
+            return false;
+        }
+
+        // 範囲 [pos, pos + length) がファイル内に収まるか（オーバーフローしない形で判定）
+        auto in_bounds = [size](std::uint64_t pos, std::uint64_t length) {
+            return pos <= size && length <= size - pos;
+        };
+        // 8 バイト要素の配列 count 個が整列してファイル内に収まるか
+        auto array_in_bounds = [&](std::uint64_t pos, std::uint64_t count) {
+            return pos % alignof(std::uint64_t) == 0 && in_bounds(pos, sizeof(std::uint64_t) * count);
+        };
+        // 別のファイル（cache_dir を共有する同名のファイル等）のキャッシュ
+        if (!in_bounds(path_pos, path_len) ||
+            std::string_view(base + path_pos, static_cast<std::size_t>(path_len)) != stamp.path) {
+            return false;
+        }
+        std::vector<std::string> names;
+        names.reserve(column_count);
+        columns_.reserve(column_count);
+        for (std::uint64_t col = 0; col < column_count; ++col) {
+            const std::uint64_t entry = kHeaderSize + kDirectoryEntrySize * col;
+            const std::uint64_t name_pos = read_u64(entry);
+            const std::uint64_t name_len = read_u64(entry + 8);
+            const std::uint64_t kind = read_u64(entry + 16);
+            const auto precision = static_cast<std::int64_t>(read_u64(entry + 24));
+            const std::uint64_t values_pos = read_u64(entry + 32);
+            const std::uint64_t data_pos = read_u64(entry + 40);
+            const std::uint64_t data_size = read_u64(entry + 48);
+            const std::uint64_t offset_bytes = read_u64(entry + 56);
+            const bool valid_precision =
+                precision >= CsvTypedValue::kShortest && precision < static_cast<std::int64_t>(CsvTypedValue::kMaxText);
+            if (!in_bounds(name_pos, name_len) || kind > static_cast<std::uint64_t>(ColumnKind::kDouble) ||
+                !valid_precision) {
+                return false;
+            }
+            Column column{};
+            column.kind = static_cast<ColumnKind>(kind);
+            column.precision = static_cast<int>(precision);
+            switch (column.kind) {
+                case ColumnKind::kInt64:
+                    if (!array_in_bounds(values_pos, row_count)) {
+                        return false;
+                    }
+                    column.int64s = reinterpret_cast<const std::int64_t *>(base + values_pos);
+                    break;
+                case ColumnKind::kDouble:
+                    if (!array_in_bounds(values_pos, row_count)) {
+                        return false;
+                    }
+                    column.doubles = reinterpret_cast<const double *>(base + values_pos);
+                    break;
+                case ColumnKind::kString:
+                    if (!in_bounds(data_pos, data_size)) {
+                        return false;
+                    }
+                    column.data = base + data_pos;
+                    if (offset_bytes == sizeof(std::uint32_t)) {
+                        if (values_pos % alignof(std::uint32_t) != 0 ||
+                            !in_bounds(values_pos, sizeof(std::uint32_t) * (row_count + 1))) {
+                            return false;
+                        }
+                        column.offsets32 = reinterpret_cast<const std::uint32_t *>(base + values_pos);
+                        if (column.offsets32[row_count] != data_size) {
+                            return false;
+                        }
+                    } else {
+                        if (offset_bytes != sizeof(std::uint64_t) || !array_in_bounds(values_pos, row_count + 1)) {
+                            return false;
+                        }
+                        column.offsets = reinterpret_cast<const std::uint64_t *>(base + values_pos);
+                        if (column.offsets[row_count] != data_size) {
+                            return false;
+                        }
+                    }
+                    break;
+            }
+            names.emplace_back(base + name_pos, static_cast<std::size_t>(name_len));
+            columns_.push_back(column);
+        }
+        header_ = CsvHeader(std::move(names));
+        row_count_ = static_cast<std::size_t>(row_count);
+        source_size_ = source_size;
+        return true;
+    }
+};
+
+} // namespace utility
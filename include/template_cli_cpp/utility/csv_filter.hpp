@@ -0,0 +1,464 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "template_cli_cpp/utility/csv_row_view.hpp"
+#include "template_cli_cpp/utility/numeric_parse.hpp"
+
+namespace utility {
+
+/**
+ * @brief 比較演算子の種類
+ */
+enum class CompareOp : std::uint8_t { kEq, kNe, kLt, kLe, kGt, kGe };
+
+class CsvFilter;
+
+/**
+ * @brief ヘッダで列を解決済みのフィルタ（CsvFilter::Compile() で作る）
+ *
+ * 比較に必要なフィールドだけを呼び出し側から受け取って評価する。
+ * && / || は短絡評価し、評価に不要なフィールドは要求しない。
+ */
+class CompiledCsvFilter {
+public:
+    /**
+     * @brief フィルタを評価する
+     *
+     * @param field_at `bool(std::size_t index, std::string_view &out)` として呼び出せる関数。
+     *                 index 列のフィールドを out に設定して true を返す（行にその列がなければ false）
+     */
+    template <typename FieldAt>
+    bool EvaluateWith(FieldAt &&field_at) const {
+        return EvaluateWith(field_at, [&field_at](std::size_t index, double &out) {
+            std::string_view text;
+            return field_at(index, text) && ParseNumber(text, out);
+        });
+    }
+
+    /**
+     * @brief 数値比較の値を number_at から受け取ってフィルタを評価する（解析済みの数値列がある場合）
+     *
+     * @param field_at  文字列比較に使う。EvaluateWith(FieldAt &&) と同じ
+     * @param number_at `bool(std::size_t index, double &out)` として呼び出せる関数。
+     *                  index 列の値を out に設定して true を返す（列がない・数値でなければ false）
+     */
+    template <typename FieldAt, typename NumberAt>
+    bool EvaluateWith(FieldAt &&field_at, NumberAt &&number_at) const {
+        return EvaluateNode(nodes_.size() - 1, field_at, number_at);
+    }
+
+    /**
+     * @brief 列指向の入力の行 [begin, end) をまとめて評価する
+     *
+     * ノードごとに全行を評価して結果を合成する（短絡評価はしない）。数値配列がある列の比較は
+     * 行ごとの関数呼び出しを伴わない単純なループになり、コンパイラがベクトル化できる。
+     *
+     * @param source  `Field(col, row, scratch)`・`Doubles(col)`・`Int64s(col)`・`TryGetNumber(col, row, out)` と
+     *                `kNullInt64` を持つ列指向の入力（CsvColumnCache）
+     * @param scratch 作業領域（呼び出し間で使い回す）
+     * @return end - begin 要素の配列。i 番目が begin + i 行目の評価結果（0 / 1）。scratch 内を指す
+     */
+    template <typename ColumnSource>
+    const std::uint8_t *EvaluateRows(
+        const ColumnSource &source,
+        std::size_t begin,
+        std::size_t end,
+        std::vector<std::uint8_t> &scratch) const {
+        const std::size_t count = end - begin;
+        scratch.resize(nodes_.size() * count);
+        // 後置順なので先頭から順に評価すれば子ノードの結果は必ず揃っている
+        for (std::size_t i = 0; i < nodes_.size(); ++i) {
+            const Node &node = nodes_[i];
+            std::uint8_t *out = scratch.data() + i * count;
+            const std::uint8_t *lhs = scratch.data() + node.lhs * count;
+            const std::uint8_t *rhs = scratch.data() + node.rhs * count;
+            switch (node.kind) {
+                case Kind::kAnd:
+                    for (std::size_t r = 0; r < count; ++r) {
+                        out[r] = lhs[r] & rhs[r];
+                    }
+                    break;
+                case Kind::kOr:
+                    for (std::size_t r = 0; r < count; ++r) {
+                        out[r] = lhs[r] | rhs[r];
+                    }
+                    break;
+                case Kind::kNot:
+                    for (std::size_t r = 0; r < count; ++r) {
+                        out[r] = lhs[r] ^ 1U;
+                    }
+                    break;
+                case Kind::kNumber:
+                    if (const double *numbers = source.Doubles(node.field)) {
+                        CompareNumbers(numbers + begin, count, node.number, node.op, out);
+                    } else if (const std::int64_t *integers = source.Int64s(node.field)) {
+                        CompareIntegers(integers + begin, count, ColumnSource::kNullInt64, node.number, node.op, out);
+                    } else {
+                        for (std::size_t r = 0; r < count; ++r) {
+                            double value = 0.0;
+                            out[r] = source.TryGetNumber(node.field, begin + r, value) &&
+                                     Compare(value, node.number, node.op);
+                        }
+                    }
+                    break;
+                case Kind::kString: {
+                    CsvTypedValue field_scratch;
+                    for (std::size_t r = 0; r < count; ++r) {
+                        const std::string_view field = source.Field(node.field, begin + r, field_scratch);
+                        out[r] = Compare(field, std::string_view(node.text), node.op);
+                    }
+                    break;
+                }
+            }
+        }
+        return scratch.data() + (nodes_.size() - 1) * count;
+    }
+
+    /**
+     * @brief 行を CsvRowView として評価する
+     */
+    bool Evaluate(const CsvRowView &row) const {
+        return EvaluateWith([&row](std::size_t index, std::string_view &out) {
+            if (index >= row.Size()) {
+                return false;
+            }
+            out = row[index].get<std::string_view>();
+            return true;
+        });
+    }
+
+    /**
+     * @brief 評価に必要な列数（参照する最大の列インデックス + 1）
+     */
+    std::size_t RequiredFields() const noexcept { return required_fields_; }
+
+private:
+    friend class CsvFilter;
+
+    enum class Kind : std::uint8_t { kNumber, kString, kAnd, kOr, kNot };
+
+    struct Node {
+        Kind kind;
+        CompareOp op;
+        std::size_t field;
+        double number;
+        std::string text;
+        std::size_t lhs;
+        std::size_t rhs;
+    };
+
+    // 後置順に並べたノード（根は末尾）
+    std::vector<Node> nodes_;
+    std::size_t required_fields_ = 0;
+
+    template <typename T>
+    static bool Compare(const T &lhs, const T &rhs, CompareOp op) noexcept {
+        switch (op) {
+            case CompareOp::kEq:
+                return lhs == rhs;
+            case CompareOp::kNe:
+                return lhs != rhs;
+            case CompareOp::kLt:
+                return lhs < rhs;
+            case CompareOp::kLe:
+                return lhs <= rhs;
+            case CompareOp::kGt:
+                return lhs > rhs;
+            case CompareOp::kGe:
+                return lhs >= rhs;
+        }
+        return false;
+    }
+
+    // values[r] と rhs の比較結果を out[r] に書く（NaN は数値でない値としてどの比較も 0）
+    static void CompareNumbers(const double *values, std::size_t count, double rhs, CompareOp op, std::uint8_t *out) {
+        auto compare_all = [&](auto compare) {
+            for (std::size_t r = 0; r < count; ++r) {
+                out[r] = compare(values[r]);
+            }
+        };
+        switch (op) {
+            case CompareOp::kEq:
+                compare_all([rhs](double v) { return v == rhs; });
+                return;
+            case CompareOp::kNe:
+                compare_all([rhs](double v) { return v == v && v != rhs; }); // v == v は NaN を除く
+                return;
+            case CompareOp::kLt:
+                compare_all([rhs](double v) { return v < rhs; });
+                return;
+            case CompareOp::kLe:
+                compare_all([rhs](double v) { return v <= rhs; });
+                return;
+            case CompareOp::kGt:
+                compare_all([rhs](double v) { return v > rhs; });
+                return;
+            case CompareOp::kGe:
+                compare_all([rhs](double v) { return v >= rhs; });
+                return;
+        }
+    }
+
+    // CompareNumbers の整数配列版（null の要素はどの比較も 0。値は double に変換して比べる）
+    static void CompareIntegers(
+        const std::int64_t *values,
+        std::size_t count,
+        std::int64_t null,
+        double rhs,
+        CompareOp op,
+        std::uint8_t *out) {
+        auto compare_all = [&](auto compare) {
+            for (std::size_t r = 0; r < count; ++r) {
+                out[r] = values[r] != null && compare(static_cast<double>(values[r]));
+            }
+        };
+        switch (op) {
+            case CompareOp::kEq:
+                compare_all([rhs](double v) { return v == rhs; });
+                return;
+            case CompareOp::kNe:
+                compare_all([rhs](double v) { return v != rhs; });
+                return;
+            case CompareOp::kLt:
+                compare_all([rhs](double v) { return v < rhs; });
+                return;
+            case CompareOp::kLe:
+                compare_all([rhs](double v) { return v <= rhs; });
+                return;
+            case CompareOp::kGt:
+                compare_all([rhs](double v) { return v > rhs; });
+                return;
+            case CompareOp::kGe:
+                compare_all([rhs](double v) { return v >= rhs; });
+                return;
+        }
+    }
+
+    template <typename FieldAt, typename NumberAt>
+    bool EvaluateNode(std::size_t i, FieldAt &field_at, NumberAt &number_at) const {
+        const Node &node = nodes_[i];
+        switch (node.kind) {
+            case Kind::kAnd:
+                return EvaluateNode(node.lhs, field_at, number_at) && EvaluateNode(node.rhs, field_at, number_at);
+            case Kind::kOr:
+                return EvaluateNode(node.lhs, field_at, number_at) || EvaluateNode(node.rhs, field_at, number_at);
+            case Kind::kNot:
+                return !EvaluateNode(node.lhs, field_at, number_at);
+            case Kind::kNumber: {
+                double value = 0.0;
+                // 列がない・数値でないフィールドとの比較は常に false
+                if (!number_at(node.field, value)) {
+                    return false;
+                }
+                return Compare(value, node.number, node.op);
+            }
+            case Kind::kString: {
+                std::string_view text;
+                if (!field_at(node.field, text)) {
+                    return false;
+                }
+                return Compare(text, std::string_view(node.text), node.op);
+            }
+        }
+        return false;
+    }
+};
+
+/**
+ * @brief 宣言的な CSV 行フィルタ式
+ *
+ * Col() と比較演算子・論理演算子で組み立て、CsvReader の Read 系メソッドに渡す。
+ * 述語（std::function）と異なり参照する列が事前にわかるため、mmap バックエンドでは
+ * 比較に必要な列までしかフィールドを分割せず、条件を満たさない行は残りを分割せずに読み飛ばす。
+ *
+ * - 数値との比較はフィールドを double として比較する（数値として解釈できなければ false）
+ * - 文字列との比較はバイト列の辞書順で比較する
+ * - 行に列が存在しない場合の比較は false
+ *
+ * @code
+ * using utility::Col;
+ * auto filter = Col("flag") == 1 && (Col("value_a") > 10.0 || Col("category") == "A");
+ * auto values = reader.ReadFiltered(filter, {"value_a", "value_b"});
+ * @endcode
+ */
+class CsvFilter {
+public:
+    /**
+     * @brief 列名をヘッダで解決して評価用の形式に変換する
+     * @throws std::invalid_argument フィルタが参照する列がヘッダにない場合
+     */
+    CompiledCsvFilter Compile(const CsvHeader &header) const {
+        CompiledCsvFilter compiled;
+        CompileNode(*root_, header, compiled);
+        return compiled;
+    }
+
+    friend CsvFilter operator&&(const CsvFilter &lhs, const CsvFilter &rhs) {
+        return CsvFilter(MakeNode(Kind::kAnd, lhs.root_, rhs.root_));
+    }
+
+    friend CsvFilter operator||(const CsvFilter &lhs, const CsvFilter &rhs) {
+        return CsvFilter(MakeNode(Kind::kOr, lhs.root_, rhs.root_));
+    }
+
+    friend CsvFilter operator!(const CsvFilter &operand) {
+        return CsvFilter(MakeNode(Kind::kNot, operand.root_, nullptr));
+    }
+
+private:
+    friend class CsvColumn;
+
+    using Kind = CompiledCsvFilter::Kind;
+
+    struct Node {
+        Kind kind = Kind::kNumber;
+        CompareOp op = CompareOp::kEq;
+        std::string column;
+        double number = 0.0;
+        std::string text;
+        std::shared_ptr<const Node> lhs;
+        std::shared_ptr<const Node> rhs;
+    };
+
+    // 部分式は複数の式から共有されうるため shared_ptr で保持する（不変）
+    std::shared_ptr<const Node> root_;
+
+    explicit CsvFilter(std::shared_ptr<const Node> root)
+        : root_(std::move(root)) {}
+
+    static std::shared_ptr<const Node> MakeNode(
+        Kind kind,
+        std::shared_ptr<const Node> lhs,
+        std::shared_ptr<const Node> rhs) {
+        auto node = std::make_shared<Node>();
+        node->kind = kind;
+        node->lhs = std::move(lhs);
+        node->rhs = std::move(rhs);
+        return node;
+    }
+
+    static CsvFilter Comparison(std::string column, CompareOp op, double number) {
+        auto node = std::make_shared<Node>();
+        node->kind = Kind::kNumber;
+        node->op = op;
+        node->column = std::move(column);
+        node->number = number;
+        return CsvFilter(std::move(node));
+    }
+
+    static CsvFilter Comparison(std::string column, CompareOp op, std::string_view text) {
+        auto node = std::make_shared<Node>();
+        node->kind = Kind::kString;
+        node->op = op;
+        node->column = std::move(column);
+        node->text = std::string(text);
+        return CsvFilter(std::move(node));
+    }
+
+    // 後置順で nodes_ に追加し、追加したノードの位置を返す
+    static std::size_t CompileNode(const Node &node, const CsvHeader &header, CompiledCsvFilter &out) {
+        CompiledCsvFilter::Node compiled{node.kind, node.op, 0, node.number, node.text, 0, 0};
+        switch (node.kind) {
+            case Kind::kNumber:
+            case Kind::kString: {
+                const int index = header.IndexOf(node.column);
+                if (index < 0) {
+                    throw std::invalid_argument("utility::CsvFilter: column not found: " + node.column);
+                }
+                compiled.field = static_cast<std::size_t>(index);
+                out.required_fields_ = std::max(out.required_fields_, compiled.field + 1);
+                break;
+            }
+            case Kind::kAnd:
+            case Kind::kOr:
+                compiled.lhs = CompileNode(*node.lhs, header, out);
+                compiled.rhs = CompileNode(*node.rhs, header, out);
+                break;
+            case Kind::kNot:
+                compiled.lhs = CompileNode(*node.lhs, header, out);
+                break;
+        }
+        out.nodes_.push_back(std::move(compiled));
+        return out.nodes_.size() - 1;
+    }
+};
+
+/**
+ * @brief フィルタ式中の列参照（Col() で作る）
+ *
+ * 数値（算術型）または文字列と比較すると CsvFilter になる。
+ */
+class CsvColumn {
+    // 比較相手は算術型（bool を除く）または string_view に変換できる型
+    template <typename T>
+    using EnableIfComparable = std::enable_if_t<
+        (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) || std::is_convertible_v<const T &, std::string_view>>;
+
+public:
+    explicit CsvColumn(std::string name)
+        : name_(std::move(name)) {}
+
+    const std::string &Name() const noexcept { return name_; }
+
+    template <typename T, typename = EnableIfComparable<T>>
+    friend CsvFilter operator==(const CsvColumn &column, const T &value) {
+        return column.Compare(CompareOp::kEq, value);
+    }
+
+    template <typename T, typename = EnableIfComparable<T>>
+    friend CsvFilter operator!=(const CsvColumn &column, const T &value) {
+        return column.Compare(CompareOp::kNe, value);
+    }
+
+    template <typename T, typename = EnableIfComparable<T>>
+    friend CsvFilter operator<(const CsvColumn &column, const T &value) {
+        return column.Compare(CompareOp::kLt, value);
+    }
+
+    template <typename T, typename = EnableIfComparable<T>>
+    friend CsvFilter operator<=(const CsvColumn &column, const T &value) {
+        return column.Compare(CompareOp::kLe, value);
+    }
+
+    template <typename T, typename = EnableIfComparable<T>>
+    friend CsvFilter operator>(const CsvColumn &column, const T &value) {
+        return column.Compare(CompareOp::kGt, value);
+    }
+
+    template <typename T, typename = EnableIfComparable<T>>
+    friend CsvFilter operator>=(const CsvColumn &column, const T &value) {
+        return column.Compare(CompareOp::kGe, value);
+    }
+
+private:
+    std::string name_;
+
+    template <typename T>
+    CsvFilter Compare(CompareOp op, const T &value) const {
+        if constexpr (std::is_arithmetic_v<T>) {
+            return CsvFilter::Comparison(name_, op, static_cast<double>(value));
+        } else {
+            return CsvFilter::Comparison(name_, op, std::string_view(value));
+        }
+    }
+};
+
+/**
+ * @brief フィルタ式の列参照を作る
+ *
+ * @code
+ * auto filter = utility::Col("flag") == 1 && utility::Col("value_a") > 10.0;
+ * @endcode
+ */
+inline CsvColumn Col(std::string name) { return CsvColumn(std::move(name)); }
+
+} // namespace utility
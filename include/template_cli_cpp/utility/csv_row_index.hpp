@@ -0,0 +1,255 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "template_cli_cpp/utility/csv_tokenizer.hpp"
+#include "template_cli_cpp/utility/mapped_file.hpp"
+#include "template_cli_cpp/utility/sidecar_file.hpp"
+
+namespace utility {
+
+/**
+ * @brief CSV ファイルの疎な行位置インデックス（行番号 → バイト位置）
+ *
+ * データ行（ヘッダ行を除く、0 始まり）のうち Stride() 行ごとに先頭のバイト位置を記録する。
+ * 任意の行へは直前の記録位置から高々 Stride() - 1 行を読み飛ばすだけで到達できるため、
+ * ファイル先頭から走査せずに「100 万行目から 100 行」や標本抽出の行を読める。
+ * 大きさは 8 バイト × (行数 / Stride()) で、既定の間隔では 1 億行でも約 800KB。
+ *
+ * 行の区切りは内蔵トークナイザ（CsvTokenizer）と同じ規則で数える（空行は数えず、
+ * クォート内の改行は行の区切りにならない）。
+ *
+ * Save() でサイドカーファイルに保存でき、Open() は元ファイルの正規化したパス・サイズ・更新時刻が
+ * 記録と一致する場合だけ読み込む（CsvColumnCache と同じ方針）。
+ *
+ * ファイル形式（ネイティブエンディアン）:
+ * - ヘッダ: マジック（8 バイト）、元ファイルのサイズ・更新時刻、行数、記録間隔、記録数、元ファイルのパスの長さ
+ * - 元ファイルのパス
+ * - 記録位置: uint64 × 記録数
+ *
+ * @code
+ * auto index = utility::CsvRowIndex::OpenOrBuild("data.csv", utility::CsvRowIndex::PathFor("data.csv", ""));
+ * const auto checkpoint = index->Locate(1'000'000);
+ * // checkpoint.offset から checkpoint.skip 行読み飛ばすと 1'000'000 行目
+ * @endcode
+ */
+class CsvRowIndex {
+public:
+    /// インデックスファイル名の拡張子（元ファイル名の後ろに付ける）
+    static constexpr const char *kExtension = ".rowidx";
+    /// 既定の記録間隔（行）
+    static constexpr std::uint64_t kDefaultStride = 1024;
+
+    /**
+     * @brief Locate() の結果: 行へ到達するための読み始め位置
+     */
+    struct Checkpoint {
+        std::uint64_t row;    ///< offset から始まる行の行番号
+        std::uint64_t offset; ///< ファイル内のバイト位置
+        std::uint64_t skip;   ///< 目的の行までに読み飛ばす行数
+    };
+
+    /**
+     * @brief csv_path に対応するインデックスファイルのパスを返す
+     * @param cache_dir インデックスを置くディレクトリ（空なら CSV と同じディレクトリ）。
+     *        指定した場合はファイル名に CSV の正規化したパスのハッシュを含める（SidecarPath()）
+     */
+    static std::string PathFor(const std::string &csv_path, const std::string &cache_dir) {
+        return SidecarPath(csv_path, cache_dir, kExtension);
+    }
+
+    /**
+     * @brief CSV を先頭から走査してインデックスを作る（メモリ上のみ。保存は Save()）
+     * @param stride 記録間隔（行）。0 は 1 として扱う
+     * @throws std::runtime_error CSV を読み込めない場合
+     */
+    static std::shared_ptr<const CsvRowIndex> Build(
+        const std::string &csv_path,
+        std::uint64_t stride = kDefaultStride,
+        char delimiter = ',') {
+        // 読み込み前に記録する（作成中に元ファイルが更新されれば Matches() が false になる）
+        std::shared_ptr<CsvRowIndex> index(new CsvRowIndex(StampOf(csv_path, kOwner), stride == 0 ? 1 : stride));
+        const auto source = MappedFile::Open(csv_path);
+        CsvTokenizer tokenizer(source->View(), delimiter);
+        std::vector<std::string_view> fields;
+        if (tokenizer.BeginRow(fields)) {
+            tokenizer.SkipRow(); // ヘッダ行
+        }
+        std::uint64_t row = 0;
+        while (true) {
+            const std::uint64_t offset = tokenizer.Position();
+            if (!tokenizer.BeginRow(fields)) {
+                break;
+            }
+            if (row % index->stride_ == 0) {
+                index->offsets_.push_back(offset);
+            }
+            tokenizer.SkipRow();
+            ++row;
+        }
+        index->row_count_ = row;
+        return index;
+    }
+
+    /**
+     * @brief 保存済みのインデックスを開く
+     * @return ファイルがない・元ファイルと一致しない・壊れている場合は nullptr
+     */
+    static std::shared_ptr<const CsvRowIndex> Open(const std::string &csv_path, const std::string &index_path) {
+        std::ifstream ifs(index_path, std::ios::binary);
+        if (!ifs) {
+            return nullptr;
+        }
+        char magic[sizeof(kMagic)] = {};
+        std::uint64_t source_size = 0;
+        std::int64_t source_mtime = 0;
+        std::uint64_t row_count = 0;
+        std::uint64_t stride = 0;
+        std::uint64_t checkpoint_count = 0;
+        std::uint64_t path_len = 0;
+        ifs.read(magic, sizeof(magic));
+        ReadValue(ifs, source_size);
+        ReadValue(ifs, source_mtime);
+        ReadValue(ifs, row_count);
+        ReadValue(ifs, stride);
+        ReadValue(ifs, checkpoint_count);
+        ReadValue(ifs, path_len);
+        if (!ifs || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || stride == 0 ||
+            checkpoint_count != (row_count + stride - 1) / stride) {
+            return nullptr;
+        }
+        const SourceStamp stamp = StampOf(csv_path, kOwner);
+        if (source_size != stamp.size || source_mtime != stamp.mtime || path_len != stamp.path.size()) {
+            return nullptr;
+        }
+        // 記録数がファイルの大きさと合わなければ壊れている（巨大な確保を避けるため先に確認する）
+        std::error_code ec;
+        const auto index_size = std::filesystem::file_size(index_path, ec);
+        if (ec || index_size != kHeaderSize + path_len + sizeof(std::uint64_t) * checkpoint_count) {
+            return nullptr;
+        }
+        // 別のファイル（cache_dir を共有する同名のファイル等）のインデックス
+        std::string source_path(static_cast<std::size_t>(path_len), '\0');
+        ifs.read(source_path.data(), static_cast<std::streamsize>(path_len));
+        if (!ifs || source_path != stamp.path) {
+            return nullptr;
+        }
+        std::shared_ptr<CsvRowIndex> index(new CsvRowIndex(stamp, stride));
+        index->row_count_ = row_count;
+        index->offsets_.resize(static_cast<std::size_t>(checkpoint_count));
+        ifs.read(
+            reinterpret_cast<char *>(index->offsets_.data()),
+            static_cast<std::streamsize>(sizeof(std::uint64_t) * checkpoint_count)
+        );
+        if (!ifs) {
+            return nullptr;
+        }
+        return index;
+    }
+
+    /**
+     * @brief 有効なインデックスを開き、なければ作成・保存してから返す
+     * @throws std::runtime_error CSV の読み込み、またはインデックスの保存に失敗した場合
+     */
+    static std::shared_ptr<const CsvRowIndex> OpenOrBuild(
+        const std::string &csv_path,
+        const std::string &index_path,
+        std::uint64_t stride = kDefaultStride,
+        char delimiter = ',') {
+        if (auto index = Open(csv_path, index_path)) {
+            return index;
+        }
+        auto index = Build(csv_path, stride, delimiter);
+        index->Save(index_path);
+        return index;
+    }
+
+    /**
+     * @brief インデックスをファイルに保存する（既存のファイルは置き換える）
+     *
+     * 一時ファイルに書き出してから rename するため、読み込み中のプロセスが中途半端な
+     * インデックスを見ることはない。
+     *
+     * @throws std::runtime_error 書き込みに失敗した場合
+     */
+    void Save(const std::string &index_path) const {
+        WriteFileAtomically(index_path, kOwner, [this](std::ofstream &ofs) {
+            ofs.write(kMagic, sizeof(kMagic));
+            WriteValue(ofs, stamp_.size);
+            WriteValue(ofs, stamp_.mtime);
+            WriteValue(ofs, row_count_);
+            WriteValue(ofs, stride_);
+            WriteValue(ofs, static_cast<std::uint64_t>(offsets_.size()));
+            WriteValue(ofs, static_cast<std::uint64_t>(stamp_.path.size()));
+            ofs.write(stamp_.path.data(), static_cast<std::streamsize>(stamp_.path.size()));
+            ofs.write(
+                reinterpret_cast<const char *>(offsets_.data()),
+                static_cast<std::streamsize>(sizeof(std::uint64_t) * offsets_.size())
+            );
+        });
+    }
+
+    /// データ行数（ヘッダ行・空行を除く）
+    std::uint64_t RowCount() const noexcept { return row_count_; }
+
+    /// 記録間隔（行）
+    std::uint64_t Stride() const noexcept { return stride_; }
+
+    /**
+     * @brief row 行目へ到達するための読み始め位置（row 以前で最も近い記録位置）
+     * @throws std::out_of_range row が RowCount() 以上の場合
+     */
+    Checkpoint Locate(std::uint64_t row) const {
+        if (row >= row_count_) {
+            throw std::out_of_range("utility::CsvRowIndex: row out of range: " + std::to_string(row));
+        }
+        const std::uint64_t k = row / stride_;
+        return {k * stride_, offsets_[static_cast<std::size_t>(k)], row - k * stride_};
+    }
+
+    /**
+     * @brief csv_path が作成時と同じファイルで、サイズ・更新時刻も一致するか（ファイルが変わっていないか）
+     */
+    bool Matches(const std::string &csv_path) const {
+        SourceStamp now{};
+        std::error_code ec;
+        return StatSource(csv_path, now, ec) && now.SameContent(stamp_) && CanonicalSourcePath(csv_path) == stamp_.path;
+    }
+
+private:
+    static constexpr const char *kOwner = "utility::CsvRowIndex";
+    static constexpr char kMagic[8] = {'T', 'C', 'C', 'S', 'V', 'I', '0', '2'};
+    // マジック・元ファイルのサイズ・更新時刻・行数・記録間隔・記録数・元ファイルのパスの長さ
+    static constexpr std::uint64_t kHeaderSize = 8 + 8 * 6;
+
+    SourceStamp stamp_;
+    std::uint64_t stride_;
+    std::uint64_t row_count_ = 0;
+    std::vector<std::uint64_t> offsets_; // offsets_[k] は k * stride_ 行目の先頭位置
+
+    CsvRowIndex(SourceStamp stamp, std::uint64_t stride)
+        : stamp_(std::move(stamp)),
+          stride_(stride) {}
+
+    template <typename T>
+    static void ReadValue(std::ifstream &ifs, T &value) {
+        ifs.read(reinterpret_cast<char *>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    static void WriteValue(std::ofstream &ofs, T value) {
+        ofs.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+};
+
+} // namespace utility
@@ -0,0 +1,302 @@
+#pragma once
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "template_cli_cpp/utility/numeric_parse.hpp"
+
+namespace utility {
+
+/**
+ * @brief CSV ヘッダ（列名と列名→インデックスの対応表）
+ */
+class CsvHeader {
+public:
+    CsvHeader() = default;
+
+    explicit CsvHeader(std::vector<std::string> names)
+        : names_(std::move(names)) {
+        for (std::size_t i = 0; i < names_.size(); ++i) {
+            index_.emplace(names_[i], static_cast<int>(i));
+        }
+    }
+
+    const std::vector<std::string> &Names() const noexcept { return names_; }
+
+    std::size_t Size() const noexcept { return names_.size(); }
+
+    /**
+     * @brief 列名からインデックスを取得
+     * @return 列インデックス（存在しない場合は -1）
+     */
+    int IndexOf(std::string_view name) const {
+        const auto it = index_.find(name);
+        return it == index_.end() ? -1 : it->second;
+    }
+
+private:
+    std::vector<std::string> names_;
+    std::map<std::string, int, std::less<>> index_;
+};
+
+/**
+ * @brief 数値として保持しているフィールド値（列指向キャッシュの数値列など）
+ *
+ * 元の文字列を持たず、数値のまま CsvFieldView に渡して解析し直さずに取り出せるようにする。
+ * 文字列が必要になった場合は Text() が初回だけ書式化する（元の文字列と同じ表記になる値だけを保持する前提。
+ * CsvColumnCache は作成時にこれを確かめた列だけを数値列にする）。
+ */
+class CsvTypedValue {
+public:
+    enum class Kind : std::uint8_t { kNone, kInt64, kDouble };
+
+    /// SetDouble() の precision に指定すると、値を復元できる最短の固定小数点表記で書式化する
+    static constexpr int kShortest = -1;
+    /// Text() が書式化できる最大の文字数
+    static constexpr std::size_t kMaxText = 48;
+
+    Kind GetKind() const noexcept { return kind_; }
+
+    void Reset() noexcept { kind_ = Kind::kNone; }
+
+    void SetInt64(std::int64_t value) noexcept {
+        kind_ = Kind::kInt64;
+        int64_ = value;
+        text_size_ = 0;
+    }
+
+    /**
+     * @param precision 小数点以下の桁数（kShortest なら最短表記）
+     */
+    void SetDouble(double value, int precision) noexcept {
+        kind_ = Kind::kDouble;
+        double_ = value;
+        precision_ = precision;
+        text_size_ = 0;
+    }
+
+    /**
+     * @brief 値を文字列にする（結果は次の Set*() まで有効）
+     */
+    std::string_view Text() const noexcept {
+        if (text_size_ == 0) {
+            text_size_ = static_cast<std::uint8_t>(
+                kind_ == Kind::kInt64 ? FormatInt64(int64_, text_) : FormatDouble(double_, precision_, text_)
+            );
+        }
+        return {text_, text_size_};
+    }
+
+    /**
+     * @brief 値を T として取り出す（Text() を ParseNumber で変換した場合と同じ結果）
+     *
+     * 整数値は整数型・浮動小数点型とも直接変換する。double 値を double 以外で取り出す場合は
+     * 丸め方を ParseNumber と揃えるため Text() を変換する。
+     */
+    template <typename T>
+    bool TryGet(T &out) const noexcept {
+        if (kind_ == Kind::kInt64) {
+            if constexpr (std::is_floating_point_v<T>) {
+                out = static_cast<T>(int64_);
+                return true;
+            } else if constexpr (std::is_signed_v<T>) {
+                if (int64_ < std::numeric_limits<T>::min() || int64_ > std::numeric_limits<T>::max()) {
+                    return false;
+                }
+                out = static_cast<T>(int64_);
+                return true;
+            } else {
+                if (int64_ < 0 || static_cast<std::uint64_t>(int64_) > std::numeric_limits<T>::max()) {
+                    return false;
+                }
+                out = static_cast<T>(int64_);
+                return true;
+            }
+        }
+        if constexpr (std::is_same_v<T, double>) {
+            if (kind_ == Kind::kDouble) {
+                out = double_;
+                return true;
+            }
+        }
+        return ParseNumber(Text(), out);
+    }
+
+    /**
+     * @brief value を 10 進の文字列にして out に書く
+     * @param out kMaxText バイト以上の領域
+     * @return 書いた文字数
+     */
+    static std::size_t FormatInt64(std::int64_t value, char *out) noexcept {
+        return static_cast<std::size_t>(std::to_chars(out, out + kMaxText, value).ptr - out);
+    }
+
+    /**
+     * @brief value を固定小数点表記の文字列にして out に書く
+     * @param precision 小数点以下の桁数（kShortest なら値を復元できる最短表記）
+     * @param out kMaxText バイト以上の領域
+     * @return 書いた文字数（kMaxText に収まらない場合、浮動小数点版 to_chars がない場合は 0）
+     */
+    static std::size_t FormatDouble(
+        [[maybe_unused]] double value,
+        [[maybe_unused]] int precision,
+        [[maybe_unused]] char *out) noexcept {
+#if defined(__cpp_lib_to_chars)
+        const auto result = precision == kShortest
+                                ? std::to_chars(out, out + kMaxText, value, std::chars_format::fixed)
+                                : std::to_chars(out, out + kMaxText, value, std::chars_format::fixed, precision);
+        return result.ec == std::errc{} ? static_cast<std::size_t>(result.ptr - out) : 0;
+#else
+        return 0;
+#endif
+    }
+
+private:
+    Kind kind_ = Kind::kNone;
+    mutable std::uint8_t text_size_ = 0; // 0 は未書式化（数値の文字列は空にならない）
+    int precision_ = kShortest;
+    std::int64_t int64_ = 0;
+    double double_ = 0.0;
+    mutable char text_[kMaxText];
+};
+
+/**
+ * @brief CSV の 1 フィールドへの読み取り専用ビュー
+ *
+ * csv::CSVField と同様に get<T>() で型変換して取り出す。
+ * 参照先は行の走査中のみ有効（コピーが必要なら get<std::string>() を使う）。
+ */
+class CsvFieldView {
+public:
+    explicit CsvFieldView(std::string_view text) noexcept
+        : text_(text) {}
+
+    /**
+     * @brief 数値として保持している値のビュー（数値型への変換で文字列を解析しない）
+     */
+    explicit CsvFieldView(const CsvTypedValue &typed) noexcept
+        : typed_(&typed) {}
+
+    /**
+     * @brief フィールド値を T として取得する
+     *
+     * サポート型: std::string_view, std::string, 整数型（bool を除く）, float, double
+     * 数値は utility::ParseNumber（from_chars・ロケール非依存）で変換する。
+     *
+     * @throws std::runtime_error 数値型への変換に失敗した場合
+     */
+    template <typename T>
+    T get() const {
+        if constexpr (std::is_same_v<T, std::string_view>) {
+            return Text();
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            return std::string(Text());
+        } else {
+            T value{};
+            if (!TryGet(value)) {
+                throw std::runtime_error("utility::CsvFieldView: not a number: " + std::string(Text()));
+            }
+            return value;
+        }
+    }
+
+    /**
+     * @brief フィールド値を数値として取得する（例外なし）
+     *
+     * 空フィールドや数値以外を含む行を読み飛ばす述語など、変換失敗が想定内の場合に使う。
+     *
+     * @param out 変換結果（失敗時は変更しない）
+     * @return 変換に成功した場合 true
+     */
+    template <typename T>
+    bool TryGet(T &out) const noexcept {
+        return typed_ != nullptr ? typed_->TryGet(out) : ParseNumber(text_, out);
+    }
+
+    /**
+     * @brief 空フィールドか
+     */
+    bool IsEmpty() const noexcept { return typed_ == nullptr && text_.empty(); }
+
+private:
+    std::string_view text_;
+    const CsvTypedValue *typed_ = nullptr; // 設定されていれば text_ の代わりに使う
+
+    std::string_view Text() const noexcept { return typed_ != nullptr ? typed_->Text() : text_; }
+};
+
+/**
+ * @brief CSV の 1 行への読み取り専用ビュー
+ *
+ * utility::CsvReader の述語に渡される行型。csv::CSVRow と同じく
+ * インデックスまたは列名でフィールドにアクセスできる。
+ * 列名アクセスは毎回探索が発生するため、ホットループでは
+ * CsvReader::IndexOf() で事前に解決したインデックスを使うこと。
+ *
+ * @code
+ * auto pred = [](const utility::CsvRowView &row) { return row["flag"].get<int>() == 1; };
+ * @endcode
+ */
+class CsvRowView {
+public:
+    CsvRowView(const std::vector<std::string_view> &fields, const CsvHeader &header) noexcept
+        : fields_(&fields),
+          header_(&header) {}
+
+    /**
+     * @param typed fields と同じ要素数の配列。Kind::kNone でない要素は fields の代わりに使う
+     */
+    CsvRowView(
+        const std::vector<std::string_view> &fields,
+        const CsvTypedValue *typed,
+        const CsvHeader &header) noexcept
+        : fields_(&fields),
+          typed_(typed),
+          header_(&header) {}
+
+    /**
+     * @brief フィールド数を取得
+     */
+    std::size_t Size() const noexcept { return fields_->size(); }
+
+    /**
+     * @brief インデックスでフィールドを取得
+     * @throws std::out_of_range インデックスが範囲外の場合
+     */
+    CsvFieldView operator[](std::size_t index) const {
+        if (index >= fields_->size()) {
+            throw std::out_of_range("utility::CsvRowView: field index out of range: " + std::to_string(index));
+        }
+        if (typed_ != nullptr && typed_[index].GetKind() != CsvTypedValue::Kind::kNone) {
+            return CsvFieldView(typed_[index]);
+        }
+        return CsvFieldView((*fields_)[index]);
+    }
+
+    /**
+     * @brief 列名でフィールドを取得
+     * @throws std::invalid_argument 列名が存在しない場合
+     */
+    CsvFieldView operator[](std::string_view name) const {
+        const int index = header_->IndexOf(name);
+        if (index < 0) {
+            throw std::invalid_argument("utility::CsvRowView: column not found: " + std::string(name));
+        }
+        return (*this)[static_cast<std::size_t>(index)];
+    }
+
+private:
+    const std::vector<std::string_view> *fields_;
+    const CsvTypedValue *typed_ = nullptr;
+    const CsvHeader *header_;
+};
+
+} // namespace utility
@@ -0,0 +1,172 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define TEMPLATE_CLI_CPP_CSV_SCAN_X86 1
+#else
+#define TEMPLATE_CLI_CPP_CSV_SCAN_X86 0
+#endif
+
+namespace utility {
+
+/**
+ * @brief 区切り文字・改行の検出に使う命令セット
+ */
+enum class ScanKernel : std::uint8_t {
+    kScalar, ///< 1 バイトずつ比較する（全プラットフォーム）
+    kSse2,   ///< 16 バイト単位（x86-64 のベースライン）
+    kAvx2,   ///< 32 バイト単位（実行時に CPU が対応している場合のみ）
+};
+
+/**
+ * @brief 実行中の CPU で使える最速のカーネルを返す（初回呼び出し時に判定してキャッシュする）
+ */
+inline ScanKernel DetectScanKernel() noexcept {
+#if TEMPLATE_CLI_CPP_CSV_SCAN_X86
+    static const ScanKernel kernel = __builtin_cpu_supports("avx2") ? ScanKernel::kAvx2 : ScanKernel::kSse2;
+    return kernel;
+#else
+    return ScanKernel::kScalar;
+#endif
+}
+
+namespace detail {
+
+// p[0, n) のうち区切り文字・LF・CR の位置にビットを立てたマスク（n <= 64）
+inline std::uint64_t StructuralMaskScalar(const char *p, std::size_t n, char delimiter) noexcept {
+    std::uint64_t mask = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const char c = p[i];
+        if (c == delimiter || c == '\n' || c == '\r') {
+            mask |= std::uint64_t{1} << i;
+        }
+    }
+    return mask;
+}
+
+#if TEMPLATE_CLI_CPP_CSV_SCAN_X86
+// p[0, 64) の StructuralMaskScalar 相当（SSE2）
+inline std::uint64_t StructuralMaskSse2(const char *p, char delimiter) noexcept {
+    const __m128i delim = _mm_set1_epi8(delimiter);
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    std::uint64_t mask = 0;
+    for (int k = 0; k < 4; ++k) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16 * k));
+        const __m128i hit =
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, delim), _mm_cmpeq_epi8(v, lf)), _mm_cmpeq_epi8(v, cr));
+        mask |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(hit))) << (16 * k);
+    }
+    return mask;
+}
+
+// p[0, 64) の StructuralMaskScalar 相当（AVX2）
+__attribute__((target("avx2"))) inline std::uint64_t StructuralMaskAvx2(const char *p, char delimiter) noexcept {
+    const __m256i delim = _mm256_set1_epi8(delimiter);
+    const __m256i lf = _mm256_set1_epi8('\n');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    std::uint64_t mask = 0;
+    for (int k = 0; k < 2; ++k) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 32 * k));
+        const __m256i hit = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, delim), _mm256_cmpeq_epi8(v, lf)), _mm256_cmpeq_epi8(v, cr)
+        );
+        mask |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(hit))) << (32 * k);
+    }
+    return mask;
+}
+#endif
+
+inline unsigned int CountTrailingZeros(std::uint64_t bits) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned int>(__builtin_ctzll(bits));
+#else
+    unsigned int n = 0;
+    while ((bits & 1U) == 0) {
+        bits >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+} // namespace detail
+
+/**
+ * @brief 区切り文字・改行（LF / CR）の位置を 64 バイトブロック単位のビットマスクで探すスキャナ
+ *
+ * ブロックのマスクを一度計算すると、同じブロック内にある後続フィールドの終端は
+ * ビット演算だけで求まる。短いフィールドが続く数値 CSV で 1 バイトずつ比較するより速い。
+ * 入力末尾の 64 バイト未満の端数はスカラーで処理する（入力範囲外は読まない）。
+ */
+class StructuralScanner {
+public:
+    explicit StructuralScanner(
+        std::string_view data,
+        char delimiter = ',',
+        ScanKernel kernel = DetectScanKernel()) noexcept
+        : data_(data),
+          delimiter_(delimiter),
+          kernel_(kernel) {}
+
+    /**
+     * @brief pos 以降で最初に現れる区切り文字・LF・CR の位置を返す（見つからなければ data.size()）
+     *
+     * pos は呼び出しごとに単調増加させること（後戻りすると再計算になるだけで結果は正しい）。
+     */
+    std::size_t Next(std::size_t pos) noexcept {
+        while (pos < data_.size()) {
+            if (pos < block_begin_ || pos >= block_end_) {
+                LoadBlock(pos);
+            }
+            const std::uint64_t bits = mask_ >> (pos - block_begin_);
+            if (bits != 0) {
+                return pos + detail::CountTrailingZeros(bits);
+            }
+            pos = block_end_;
+        }
+        return data_.size();
+    }
+
+    ScanKernel Kernel() const noexcept { return kernel_; }
+
+private:
+    static constexpr std::size_t kBlockSize = 64;
+
+    std::string_view data_;
+    char delimiter_;
+    ScanKernel kernel_;
+    std::size_t block_begin_ = 0;
+    std::size_t block_end_ = 0;
+    std::uint64_t mask_ = 0;
+
+    void LoadBlock(std::size_t pos) noexcept {
+        const char *p = data_.data() + pos;
+        const std::size_t n = data_.size() - pos;
+        block_begin_ = pos;
+        if (n < kBlockSize) {
+            block_end_ = data_.size();
+            mask_ = detail::StructuralMaskScalar(p, n, delimiter_);
+            return;
+        }
+        block_end_ = pos + kBlockSize;
+        switch (kernel_) {
+#if TEMPLATE_CLI_CPP_CSV_SCAN_X86
+            case ScanKernel::kAvx2:
+                mask_ = detail::StructuralMaskAvx2(p, delimiter_);
+                return;
+            case ScanKernel::kSse2:
+                mask_ = detail::StructuralMaskSse2(p, delimiter_);
+                return;
+#endif
+            default:
+                mask_ = detail::StructuralMaskScalar(p, kBlockSize, delimiter_);
+                return;
+        }
+    }
+};
+
+} // namespace utility
@@ -0,0 +1,247 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "template_cli_cpp/utility/column_table.hpp"
+#include "template_cli_cpp/utility/csv_row_view.hpp"
+#include "template_cli_cpp/utility/numeric_parse.hpp"
+
+namespace utility {
+
+/**
+ * @brief CsvReader::InferSchema の標本の取り方
+ *
+ * データ部の先頭 head_bytes に加え、残りの部分から probes 箇所を無作為に選んで
+ * それぞれ probe_bytes ずつ読む（ファイルの後半にだけ現れる値の型も拾うため）。
+ */
+struct CsvSchemaOptions {
+    std::size_t head_bytes = std::size_t{1} * 1024 * 1024; ///< 先頭から読むバイト数
+    std::size_t probes = 32;                               ///< 無作為に選ぶ位置の数（0: 先頭のみ）
+    std::size_t probe_bytes = std::size_t{64} * 1024;      ///< 1 か所あたりに読むバイト数
+    std::uint64_t seed = 0;                                ///< 位置を選ぶ乱数の種
+};
+
+/**
+ * @brief 推定した列の型（後ろほど広い型。標本中の全フィールドを表せる最も狭い型を選ぶ）
+ */
+enum class CsvFieldType : std::uint8_t {
+    kEmpty,  ///< 標本中の値がすべて空（型を決められない）
+    kInt32,  ///< 32 ビット整数に収まる整数
+    kInt64,  ///< 64 ビット整数に収まる整数
+    kDouble, ///< 浮動小数点数（整数の範囲を超える値・指数表記・nan/inf を含む）
+    kString, ///< 数値として解釈できない値を含む
+};
+
+/**
+ * @brief 1 列分の推定結果
+ */
+struct CsvColumnSchema {
+    std::string name;
+    CsvFieldType type = CsvFieldType::kEmpty;
+    bool nullable = false;        ///< 標本中に空フィールド（または列数の足りない行）がある
+    std::uint64_t values = 0;     ///< 標本中の空でないフィールド数
+    std::uint64_t nulls = 0;      ///< 標本中の空フィールド数
+    std::uint64_t distinct = 0;   ///< 標本中の異なる値の数（kDistinctLimit で打ち切る）
+    double min = std::numeric_limits<double>::quiet_NaN(); ///< 数値型のみ: 標本中の最小値（NaN を除く）
+    double max = std::numeric_limits<double>::quiet_NaN(); ///< 数値型のみ: 標本中の最大値（NaN を除く）
+
+    bool IsNumeric() const noexcept {
+        return type == CsvFieldType::kInt32 || type == CsvFieldType::kInt64 || type == CsvFieldType::kDouble;
+    }
+};
+
+/**
+ * @brief CSV の列ごとの型・欠損の有無・数値範囲の推定結果（CsvReader::InferSchema の戻り値）
+ *
+ * 標本から求めた推定であり、標本に含まれない行に推定より広い型の値がある可能性は残る
+ * （IsExact() が true ならファイル全体を調べた結果）。
+ */
+class CsvSchema {
+public:
+    /// distinct を数える上限（これを超える列は異なる値が「多い」とだけ扱う）
+    static constexpr std::uint64_t kDistinctLimit = 4096;
+
+    CsvSchema() = default;
+
+    CsvSchema(
+        std::vector<CsvColumnSchema> columns,
+        std::uint64_t sampled_rows,
+        std::uint64_t estimated_rows,
+        bool exact)
+        : columns_(std::move(columns)),
+          sampled_rows_(sampled_rows),
+          estimated_rows_(estimated_rows),
+          exact_(exact) {}
+
+    const std::vector<CsvColumnSchema> &Columns() const noexcept { return columns_; }
+
+    /**
+     * @throws std::invalid_argument 列が存在しない場合
+     */
+    const CsvColumnSchema &Column(std::string_view name) const {
+        for (const auto &column : columns_) {
+            if (column.name == name) {
+                return column;
+            }
+        }
+        throw std::invalid_argument("utility::CsvSchema: column not found: " + std::string(name));
+    }
+
+    /// 推定に使った行数
+    std::uint64_t SampledRows() const noexcept { return sampled_rows_; }
+
+    /// ファイル全体の行数の見積もり（IsExact() なら実際の行数）。ColumnTable の事前確保に使える
+    std::uint64_t EstimatedRows() const noexcept { return estimated_rows_; }
+
+    /// ファイル全体を調べた結果か
+    bool IsExact() const noexcept { return exact_; }
+
+    /**
+     * @brief 推定した型で読むための ColumnSpec（ReadColumns にそのまま渡せる）
+     *
+     * 整数列は kInt64、浮動小数点列は kDouble、それ以外は kString。異なる値が少ない文字列列
+     * （異なる値の数が空でない値の 1/16 以下）は kDictionary にする。
+     *
+     * @param names 列名（空ならすべての列をファイルの順に）
+     * @throws std::invalid_argument 存在しない列名を含む場合
+     */
+    std::vector<ColumnSpec> Specs(const std::vector<std::string> &names = {}) const {
+        std::vector<ColumnSpec> specs;
+        if (names.empty()) {
+            for (const auto &column : columns_) {
+                specs.push_back({column.name, ColumnTypeOf(column)});
+            }
+            return specs;
+        }
+        for (const auto &name : names) {
+            specs.push_back({name, ColumnTypeOf(Column(name))});
+        }
+        return specs;
+    }
+
+    /**
+     * @brief 列の推定結果に対応する ColumnTable の格納型
+     */
+    static ColumnType ColumnTypeOf(const CsvColumnSchema &column) noexcept {
+        switch (column.type) {
+            case CsvFieldType::kInt32:
+            case CsvFieldType::kInt64:
+                return ColumnType::kInt64;
+            case CsvFieldType::kDouble:
+                return ColumnType::kDouble;
+            case CsvFieldType::kEmpty:
+            case CsvFieldType::kString:
+                break;
+        }
+        if (column.values > 0 && column.distinct < kDistinctLimit && column.distinct * 16 <= column.values) {
+            return ColumnType::kDictionary;
+        }
+        return ColumnType::kString;
+    }
+
+private:
+    std::vector<CsvColumnSchema> columns_;
+    std::uint64_t sampled_rows_ = 0;
+    std::uint64_t estimated_rows_ = 0;
+    bool exact_ = false;
+};
+
+/**
+ * @brief 標本の行を 1 行ずつ受け取り、列ごとの型・欠損・数値範囲を集計する
+ *
+ * 各フィールドは int64 → double の順に ParseNumber を試し、最初に成功した型をその値の型とする。
+ * 列の型はそれまでに見た値の型のうち最も広いもの。文字列と確定した列は数値変換を試さない。
+ *
+ * @code
+ * utility::CsvSchemaBuilder builder(header);
+ * while (tokenizer.NextRow(fields)) {
+ *     builder.AddRow(fields);
+ * }
+ * const utility::CsvSchema schema = builder.Finish(estimated_rows, false);
+ * @endcode
+ */
+class CsvSchemaBuilder {
+public:
+    explicit CsvSchemaBuilder(const CsvHeader &header)
+        : columns_(header.Size()),
+          seen_(header.Size()) {
+        for (std::size_t col = 0; col < columns_.size(); ++col) {
+            columns_[col].name = header.Names()[col];
+        }
+    }
+
+    /**
+     * @brief 1 行分のフィールドを集計する（列数の足りない行は不足分を空として数える）
+     */
+    void AddRow(const std::vector<std::string_view> &fields) {
+        for (std::size_t col = 0; col < columns_.size(); ++col) {
+            AddField(col, col < fields.size() ? fields[col] : std::string_view());
+        }
+        ++rows_;
+    }
+
+    /// これまでに集計した行数
+    std::uint64_t Rows() const noexcept { return rows_; }
+
+    /**
+     * @param estimated_rows ファイル全体の行数の見積もり
+     * @param exact          ファイル全体を集計したか
+     */
+    CsvSchema Finish(std::uint64_t estimated_rows, bool exact) const {
+        return CsvSchema(columns_, rows_, std::max(estimated_rows, rows_), exact);
+    }
+
+private:
+    std::vector<CsvColumnSchema> columns_;
+    std::vector<std::unordered_set<std::string>> seen_; // 列ごとの異なる値（kDistinctLimit まで）
+    std::uint64_t rows_ = 0;
+
+    void AddField(std::size_t col, std::string_view field) {
+        CsvColumnSchema &column = columns_[col];
+        if (field.empty()) {
+            column.nullable = true;
+            ++column.nulls;
+            return;
+        }
+        ++column.values;
+        if (column.distinct < CsvSchema::kDistinctLimit && seen_[col].emplace(field).second) {
+            ++column.distinct;
+        }
+        if (column.type == CsvFieldType::kString) {
+            return;
+        }
+
+        CsvFieldType type = CsvFieldType::kString;
+        double value = 0.0;
+        std::int64_t integer = 0;
+        if (column.type != CsvFieldType::kDouble && ParseNumber(field, integer)) {
+            const bool fits_int32 = integer >= std::numeric_limits<std::int32_t>::min() &&
+                                    integer <= std::numeric_limits<std::int32_t>::max();
+            type = fits_int32 ? CsvFieldType::kInt32 : CsvFieldType::kInt64;
+            value = static_cast<double>(integer);
+        } else if (ParseNumber(field, value)) {
+            type = CsvFieldType::kDouble;
+        }
+        column.type = std::max(column.type, type);
+        if (type == CsvFieldType::kString) {
+            column.min = column.max = std::numeric_limits<double>::quiet_NaN();
+            return;
+        }
+        if (std::isnan(value)) {
+            return; // NaN は範囲に含めない
+        }
+        column.min = std::isnan(column.min) ? value : std::min(column.min, value);
+        column.max = std::isnan(column.max) ? value : std::max(column.max, value);
+    }
+};
+
+} // namespace utility
@@ -0,0 +1,245 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "template_cli_cpp/utility/csv_scanner.hpp"
+
+namespace utility {
+
+/**
+ * @brief data[pos] 以降で最初に現れる改行の直後の位置を返す（見つからなければ data.size()）
+ */
+inline std::size_t NextLineStart(std::string_view data, std::size_t pos) noexcept {
+    if (pos >= data.size()) {
+        return data.size();
+    }
+    const void *found = std::memchr(data.data() + pos, '\n', data.size() - pos);
+    if (found == nullptr) {
+        return data.size();
+    }
+    return static_cast<std::size_t>(static_cast<const char *>(found) - data.data()) + 1;
+}
+
+/**
+ * @brief メモリ上の CSV バイト列を行単位で分割するトークナイザ
+ *
+ * RFC 4180 形式（ダブルクォートによる囲み・"" によるエスケープ・CRLF/LF 改行）に対応する。
+ * フィールドは入力バイト列を直接指す string_view で返すため、行ごと・フィールドごとの
+ * メモリ確保は発生しない。例外として "" エスケープを含むフィールドだけは
+ * アンエスケープ結果をトークナイザ内部のバッファに置く（次の NextRow() 呼び出しまで有効）。
+ *
+ * 空行は読み飛ばす。
+ *
+ * クォートなしフィールドの終端は StructuralScanner（AVX2 / SSE2 / スカラー）で探す。
+ * 既定では実行中の CPU で使える最速のカーネルを選ぶ。
+ *
+ * 行の一部だけが必要な場合は BeginRow() / ReadFields() / SkipRow() で必要な列まで
+ * 分割し、残りのフィールドを分割せずに次の行へ進める（フィルタの遅延評価用）。
+ *
+ * @code
+ * utility::CsvTokenizer tokenizer(bytes);
+ * std::vector<std::string_view> fields;
+ * while (tokenizer.NextRow(fields)) {
+ *     // fields[i] は bytes 内を指す
+ * }
+ * @endcode
+ */
+class CsvTokenizer {
+public:
+    explicit CsvTokenizer(
+        std::string_view data,
+        char delimiter = ',',
+        ScanKernel kernel = DetectScanKernel()) noexcept
+        : data_(data),
+          delimiter_(delimiter),
+          scanner_(data, delimiter, kernel) {}
+
+    /**
+     * @brief 次の行を fields に取り出す
+     * @param fields 出力先（呼び出しごとにクリアされる）
+     * @return 行を取り出せた場合 true、入力の終端に達した場合 false
+     */
+    bool NextRow(std::vector<std::string_view> &fields) {
+        if (!BeginRow(fields)) {
+            return false;
+        }
+        ReadFields(fields, fields.max_size());
+        return true;
+    }
+
+    /**
+     * @brief 次の行の読み取りを開始する（フィールドはまだ分割しない）
+     * @param fields 出力先（クリアされる）
+     * @return 行がある場合 true、入力の終端に達した場合 false
+     */
+    bool BeginRow(std::vector<std::string_view> &fields) {
+        fields.clear();
+        unescaped_used_ = 0;
+        SkipBlankLines();
+        in_row_ = pos_ < data_.size();
+        return in_row_;
+    }
+
+    /**
+     * @brief 現在の行のフィールドを fields.size() が count 以上になるか行末に達するまで追加する
+     */
+    void ReadFields(std::vector<std::string_view> &fields, std::size_t count) {
+        while (in_row_ && fields.size() < count) {
+            fields.push_back(data_[pos_] == '"' ? QuotedField() : PlainField());
+            if (pos_ < data_.size() && data_[pos_] == delimiter_) {
+                ++pos_;
+                if (pos_ >= data_.size()) {
+                    fields.emplace_back(); // 末尾の区切り文字の後ろは空フィールド
+                    in_row_ = false;
+                }
+                continue;
+            }
+            SkipLineEnd();
+            in_row_ = false;
+        }
+    }
+
+    /**
+     * @brief 現在の行の残りを分割せずに読み飛ばす
+     *
+     * 行末までにクォートがなければ memchr で改行まで一気に進む。
+     * クォートがある場合はクォート内の改行を正しく扱うためフィールド単位で読み飛ばす。
+     */
+    void SkipRow() {
+        if (!in_row_) {
+            return;
+        }
+        const std::size_t next = NextLineStart(data_, pos_);
+        if (std::memchr(data_.data() + pos_, '"', next - pos_) == nullptr) {
+            pos_ = next;
+            in_row_ = false;
+            return;
+        }
+        skipped_.clear();
+        ReadFields(skipped_, skipped_.max_size());
+    }
+
+    /**
+     * @brief 次に読む位置（data 先頭からのオフセット）
+     */
+    std::size_t Position() const noexcept { return pos_; }
+
+private:
+    std::string_view data_;
+    char delimiter_;
+    StructuralScanner scanner_;
+    std::size_t pos_ = 0;
+    bool in_row_ = false;
+    // SkipRow() でクォートを含む行の残りを読み捨てる先（使い回す）
+    std::vector<std::string_view> skipped_;
+    // "" エスケープを含むフィールドのアンエスケープ先（行をまたいで使い回す）
+    // deque は末尾追加で既存要素を移動しないため、返した string_view が無効化されない
+    std::deque<std::string> unescaped_;
+    std::size_t unescaped_used_ = 0;
+
+    void SkipBlankLines() noexcept {
+        while (pos_ < data_.size() && (data_[pos_] == '\n' || data_[pos_] == '\r')) {
+            ++pos_;
+        }
+    }
+
+    void SkipLineEnd() noexcept {
+        if (pos_ < data_.size() && data_[pos_] == '\r') {
+            ++pos_;
+        }
+        if (pos_ < data_.size() && data_[pos_] == '\n') {
+            ++pos_;
+        }
+    }
+
+    // 区切り文字・改行までを 1 フィールドとする
+    std::string_view PlainField() noexcept {
+        const std::size_t begin = pos_;
+        pos_ = scanner_.Next(pos_);
+        return data_.substr(begin, pos_ - begin);
+    }
+
+    // 開きクォート位置から閉じクォートまでを 1 フィールドとする
+    std::string_view QuotedField() {
+        const std::size_t begin = ++pos_; // 開きクォートの直後
+        bool has_escape = false;
+        std::size_t close = begin;
+        while (true) {
+            const void *found = std::memchr(data_.data() + close, '"', data_.size() - close);
+            if (found == nullptr) {
+                // 閉じクォートがない: 入力末尾までをフィールドとする
+                pos_ = data_.size();
+                return Unquote(data_.substr(begin), has_escape);
+            }
+            close = static_cast<std::size_t>(static_cast<const char *>(found) - data_.data());
+            if (close + 1 < data_.size() && data_[close + 1] == '"') {
+                has_escape = true;
+                close += 2;
+                continue;
+            }
+            break;
+        }
+        pos_ = close + 1;
+        std::string_view field = Unquote(data_.substr(begin, close - begin), has_escape);
+        // 閉じクォートの後ろに続く文字は区切り文字・改行まで読み捨てる
+        while (pos_ < data_.size() && data_[pos_] != delimiter_ && data_[pos_] != '\n' && data_[pos_] != '\r') {
+            ++pos_;
+        }
+        return field;
+    }
+
+    std::string_view Unquote(std::string_view inner, bool has_escape) {
+        if (!has_escape) {
+            return inner;
+        }
+        if (unescaped_used_ == unescaped_.size()) {
+            unescaped_.emplace_back();
+        }
+        std::string &out = unescaped_[unescaped_used_++];
+        out.clear();
+        for (std::size_t i = 0; i < inner.size(); ++i) {
+            out.push_back(inner[i]);
+            if (inner[i] == '"' && i + 1 < inner.size() && inner[i + 1] == '"') {
+                ++i;
+            }
+        }
+        return out;
+    }
+};
+
+/**
+ * @brief クォートで囲まれたフィールド内に改行（LF）を含むか
+ *
+ * 改行位置で範囲を分割する高速経路の適用可否の判定に使う。
+ * クォートを含まないファイルは memchr 1 回の走査で false が確定する。
+ * クォートの対応が崩れている（不正な）入力は安全側に倒して true を返すことがある。
+ */
+inline bool HasQuotedNewline(std::string_view data) noexcept {
+    const char *p = data.data();
+    const char *end = data.data() + data.size();
+    while (p != end) {
+        const auto *open = static_cast<const char *>(std::memchr(p, '"', static_cast<std::size_t>(end - p)));
+        if (open == nullptr) {
+            return false;
+        }
+        // "" エスケープは閉じ・開きの連続として扱えばよい（間に改行は入らない）
+        const auto *close =
+            static_cast<const char *>(std::memchr(open + 1, '"', static_cast<std::size_t>(end - open - 1)));
+        const char *inner_end = close == nullptr ? end : close;
+        if (std::memchr(open + 1, '\n', static_cast<std::size_t>(inner_end - open - 1)) != nullptr) {
+            return true;
+        }
+        if (close == nullptr) {
+            return false;
+        }
+        p = close + 1;
+    }
+    return false;
+}
+
+} // namespace utility
@@ -1,12 +1,171 @@
 #pragma once
 #include <csv.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <exception>
+#include <fstream>
 #include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include "template_cli_cpp/utility/aggregate.hpp"
+#include "template_cli_cpp/utility/blocking_queue.hpp"
+#include "template_cli_cpp/utility/column_table.hpp"
+#include "template_cli_cpp/utility/compressed_source.hpp"
+#include "template_cli_cpp/utility/csv_column_cache.hpp"
+#include "template_cli_cpp/utility/csv_filter.hpp"
+#include "template_cli_cpp/utility/csv_row_index.hpp"
+#include "template_cli_cpp/utility/csv_row_view.hpp"
+#include "template_cli_cpp/utility/csv_schema.hpp"
+#include "template_cli_cpp/utility/csv_tokenizer.hpp"
+#include "template_cli_cpp/utility/mapped_file.hpp"
+#include "template_cli_cpp/utility/numeric_parse.hpp"
+#include "template_cli_cpp/utility/parallel.hpp"
+#include "template_cli_cpp/utility/read_ahead_file.hpp"
+#include "template_cli_cpp/utility/sidecar_file.hpp"
+
 namespace utility {
 
+/**
+ * @brief CsvRowView を受け取る Read 系メソッドの読み込み方式
+ */
+enum class CsvBackend : std::uint8_t {
+    kAuto,      ///< クォート内改行を含まないファイルは kMmap、含むファイルは kCsvParser
+    kCsvParser, ///< csv-parser で解析する（ストリーム読み込み）
+    kMmap,      ///< ファイルを mmap し、内蔵トークナイザで直接分割する（ゼロコピー）
+    kReadAhead, ///< 専用の I/O スレッドで pread による先読みを行い、内蔵トークナイザで分割する
+};
+
+/**
+ * @brief CsvReader::SampleRows の標本抽出方法
+ */
+enum class CsvSampling : std::uint8_t {
+    kUniform,    ///< 全行から重複なく一様に選ぶ
+    kStratified, ///< 全行を件数分の等しい区間に分け、各区間から 1 行ずつ選ぶ（ファイル全体に散らばる）
+};
+
+/**
+ * @brief CsvReader の動作オプション
+ */
+struct CsvReaderOptions {
+    /// 並列スキャンのワーカースレッド数（1: 単一スレッドで先頭から読む、0: ハードウェアスレッド数）
+    unsigned int num_threads = 1;
+    /// 並列スキャンで 1 タスクが受け持つ最大バイト数（ワーカーごとのバッファ上限になる）
+    std::size_t range_bytes = std::size_t{64} * 1024 * 1024;
+    /// CsvRowView 述語版の読み込み方式（csv::CSVRow 述語版は常に csv-parser を使う）
+    CsvBackend backend = CsvBackend::kAuto;
+    /// CsvRowView 述語版で列指向バイナリキャッシュ（CsvColumnCache）を使う（backend より優先）
+    bool column_cache = false;
+    /// キャッシュファイルを置くディレクトリ（空なら CSV と同じディレクトリ）
+    std::string cache_dir;
+    /// kReadAhead で 1 回に先読みするバイト数（解析ワーカーへの受け渡し単位）
+    std::size_t read_ahead_bytes = ReadAheadFile::kDefaultBlockBytes;
+    /// ReadRange 等の行位置インデックス（CsvRowIndex）をサイドカーファイルに保存し、次回以降はそれを開く
+    bool persist_row_index = false;
+    /// 行位置インデックスが位置を記録する間隔（行）
+    std::uint64_t row_index_stride = CsvRowIndex::kDefaultStride;
+};
+
+/**
+ * @brief CsvReader::ReadFilteredAsViews の結果
+ *
+ * 出力対象フィールドを指す string_view の配列（要素順は ReadFilteredAsStrings と同じ）。
+ * 参照先（mmap したファイル、またはコピーを置いた内部アリーナ）の所有権を保持するため、
+ * このオブジェクトが生存している間は各要素が有効である（CsvReader の寿命とは無関係）。
+ */
+class CsvStringViews {
+public:
+    using const_iterator = std::vector<std::string_view>::const_iterator;
+
+    std::size_t Size() const noexcept { return views_.size(); }
+    bool Empty() const noexcept { return views_.empty(); }
+    std::string_view operator[](std::size_t i) const noexcept { return views_[i]; }
+    const_iterator begin() const noexcept { return views_.begin(); }
+    const_iterator end() const noexcept { return views_.end(); }
+
+private:
+    friend class CsvReader;
+
+    std::vector<std::string_view> views_;
+    StringArena arena_;
+    std::shared_ptr<const MappedFile> mapping_;
+
+    // mapping 内を指す値はそのまま、それ以外（アンエスケープ結果など）はアリーナにコピーして追加する
+    void Append(std::string_view value, const MappedFile *mapping) {
+        if (mapping != nullptr && mapping->Contains(value)) {
+            views_.push_back(value);
+        } else {
+            views_.push_back(arena_.Store(value));
+        }
+    }
+};
+
+/**
+ * @brief CsvReader::ReadQueries で 1 回の走査にまとめて答える問い合わせの集合
+ *
+ * 各問い合わせは「行の選択条件（CsvRowView 述語またはフィルタ式）+ 出力列」の組で、
+ * ReadColumns と同じ列指向の結果（ColumnTable）を返す。
+ *
+ * @code
+ * utility::CsvQuerySet queries;
+ * const auto flagged = queries.Add(utility::Col("flag") == 1, {{"value_a", utility::ColumnType::kDouble}});
+ * const auto large = queries.Add(
+ *     [](const utility::CsvRowView& row) { return row["value_b"].get<double>() > 900.0; },
+ *     {{"id", utility::ColumnType::kInt64}});
+ * auto results = reader.ReadQueries(queries);
+ * // results[flagged], results[large]
+ * @endcode
+ */
+class CsvQuerySet {
+public:
+    /**
+     * @brief CsvRowView 述語で行を選ぶ問い合わせを追加する
+     * @return ReadQueries の結果の中でこの問い合わせの結果が入る位置
+     */
+    std::size_t Add(std::function<bool(const CsvRowView &)> predicate, std::vector<ColumnSpec> specs) {
+        queries_.push_back({std::move(predicate), std::nullopt, std::move(specs)});
+        return queries_.size() - 1;
+    }
+
+    /**
+     * @brief フィルタ式で行を選ぶ問い合わせを追加する
+     * @return ReadQueries の結果の中でこの問い合わせの結果が入る位置
+     */
+    std::size_t Add(const CsvFilter &filter, std::vector<ColumnSpec> specs) {
+        queries_.push_back({nullptr, filter, std::move(specs)});
+        return queries_.size() - 1;
+    }
+
+    std::size_t Size() const noexcept { return queries_.size(); }
+    bool Empty() const noexcept { return queries_.empty(); }
+
+private:
+    friend class CsvReader;
+
+    struct Query {
+        std::function<bool(const CsvRowView &)> predicate; // filter がない場合に使う
+        std::optional<CsvFilter> filter;
+        std::vector<ColumnSpec> specs;
+    };
+
+    std::vector<Query> queries_;
+};
+
 /**
  * @brief フィルタ付き CSV 読み込みクラス
  *
@@ -14,6 +173,37 @@ namespace utility {
  * 列名からインデックスへの解決はファイルオープン直後に一度だけ行うため、
  * ループ内でハッシュ探索が発生しない（インデックスアクセス相当の性能）。
  *
+ * `CsvReaderOptions::num_threads` に 2 以上（または 0）を指定すると並列スキャンになる。
+ * ファイルをレコード境界に揃えたバイト範囲に分割し、範囲ごとに独立した csv::CSVReader で
+ * 解析・フィルタしたうえで、結果を元の行順に連結する。
+ *
+ * 並列スキャンの前提:
+ * - 区切り文字はカンマ、1 行目がヘッダ行であること
+ * - クォート内に改行を含まないこと（範囲境界を改行で決めるため）
+ * - 述語が複数スレッドから同時に呼ばれても安全であること
+ *
+ * 述語に `utility::CsvRowView` を受け取るオーバーロードは `CsvReaderOptions::backend` で
+ * 読み込み方式を選べる。`CsvBackend::kMmap` ではファイルを mmap して内蔵トークナイザ
+ * （SIMD で区切り文字・改行を探す）で分割し、行ごとのコピーを行わない
+ * （区切り文字はカンマ、クォート内改行は非対応）。既定の `CsvBackend::kAuto` は
+ * クォート内改行を含まないファイルに kMmap を、含むファイルに kCsvParser を自動で選ぶ
+ * （判定はファイルのサイズ・更新時刻が変わるまで CsvReader とそのコピーで再利用する）。
+ * `csv::CSVRow` を受け取るオーバーロードは backend・column_cache の指定によらず常に csv-parser で読む
+ * （述語が csv::CSVRow を必要とするため）。内蔵トークナイザを使うには CsvRowView 述語版を使うこと。
+ * `ReadFilteredAsViews` と `ReadColumns` の文字列列はマップ領域を直接指し、結果がマップの
+ * 所有権を共有する。
+ *
+ * `CsvBackend::kReadAhead` は mmap の代わりに専用の I/O スレッドが pread でファイルを先読みし
+ * （ReadAheadFile）、解析ワーカーが読み込み済みのブロックを受け取って分割する。ディスクの読み込みと
+ * 解析が重なるため、ページキャッシュに載っていないファイル（ネットワークマウント等）で有効。
+ * クォート内改行は非対応で、文字列出力はブロックの再利用のため結果内部にコピーする。
+ *
+ * `ReadRange` / `ReadRows` / `ReadSample` は行番号で指定した行だけを読む。初回に行位置インデックス
+ * （CsvRowIndex: 一定行数ごとのバイト位置）を作り、以降は目的の行の直前の記録位置へ移動して読む。
+ *
+ * 列の型がわからないファイルは `InferSchema` で標本から型を推定し、`CsvSchema::Specs()` を
+ * `ReadColumns` に渡して読める。
+ *
  * 使用例:
  * @code
  * utility::CsvReader reader("data.csv");
@@ -27,44 +217,75 @@ namespace utility {
  * auto labels = reader.ReadFilteredAsStrings(
  *     [](const csv::CSVRow& row) { return row["flag"].get<int>() == 1; },
  *     {"category"});
+ *
+ * // 4 スレッドで並列スキャン（結果の行順は単一スレッドと同じ）
+ * utility::CsvReaderOptions options;
+ * options.num_threads = 4;
+ * utility::CsvReader parallel_reader("data.csv", options);
+ * auto parallel_values = parallel_reader.ReadFiltered(
+ *     [](const csv::CSVRow& row) { return row["flag"].get<int>() == 1; },
+ *     {"value_a", "value_b"});
+ *
+ * // mmap バックエンド（文字列はファイルを直接指す string_view で返る）
+ * utility::CsvReaderOptions mmap_options;
+ * mmap_options.backend = utility::CsvBackend::kMmap;
+ * utility::CsvReader mmap_reader("data.csv", mmap_options);
+ * const int flag = mmap_reader.IndexOf("flag");
+ * auto views = mmap_reader.ReadFilteredAsViews(
+ *     [flag](const utility::CsvRowView& row) { return row[flag].get<int>() == 1; },
+ *     {"category"});
  * @endcode
  */
 class CsvReader {
 public:
     /**
      * @brief コンストラクタ
-     * @param path CSV ファイルパス
+     * @param path    CSV ファイルパス
+     * @param options 動作オプション（省略時は単一スレッド）
      */
-    explicit CsvReader(std::string path) : path_(std::move(path)) {}
+    explicit CsvReader(std::string path, CsvReaderOptions options = {})
+        : path_(std::move(path)),
+          options_(options),
+          row_index_(std::make_shared<RowIndexSlot>()),
+          layout_(std::make_shared<LayoutSlot>()) {}
 
     /**
      * @brief フィルタ付き CSV 読み込み（double 出力）
      *
      * 述語が true を返す行の指定列を double として返す。
      * 列名からインデックスへの解決は内部で一度だけ行う。
+     * 数値変換は csv-parser の `get<double>()` を経由せず `utility::ParseNumber`（from_chars）で行う。
      *
      * @param predicate  行を受け取り true を返す行のみ出力対象とする述語
      * @param output_cols 出力したい列名のリスト
      * @return 出力対象行の指定列を列挙した double の配列
      *         要素順: 行0の列0, 行0の列1, ..., 行1の列0, ...
      * @throws std::invalid_argument 存在しない列名が output_cols に含まれる場合
+     * @throws std::runtime_error 出力列に数値として解釈できない値がある場合
      */
     std::vector<double> ReadFiltered(
         std::function<bool(const csv::CSVRow &)> predicate,
         const std::vector<std::string> &output_cols) const {
-        csv::CSVReader csv_reader(path_);
+        const CompressionFormat compression = DetectCompression(path_);
+        if (ThreadCount() > 1 && compression == CompressionFormat::kNone) {
+            return ReadFilteredParallel<double>(predicate, output_cols, [](csv::CSVField field) {
+                return ParseField<double>(field);
+            });
+        }
 
-        const auto indices = ResolveIndices(csv_reader, output_cols);
+        return ScanCsvParser(compression, [&](csv::CSVReader &csv_reader) {
+            const auto indices = ResolveIndices(csv_reader, output_cols);
 
-        std::vector<double> result;
-        for (auto &row : csv_reader) {
-            if (predicate(row)) {
-                for (int idx : indices) {
-                    result.push_back(row[idx].get<double>());
+            std::vector<double> result;
+            for (auto &row : csv_reader) {
+                if (predicate(row)) {
+                    for (int idx : indices) {
+                        result.push_back(ParseField<double>(row[idx]));
+                    }
                 }
             }
-        }
-        return result;
+            return result;
+        });
     }
 
     /**
@@ -82,39 +303,1904 @@ public:
     std::vector<std::string> ReadFilteredAsStrings(
         std::function<bool(const csv::CSVRow &)> predicate,
         const std::vector<std::string> &output_cols) const {
-        csv::CSVReader csv_reader(path_);
+        const CompressionFormat compression = DetectCompression(path_);
+        if (ThreadCount() > 1 && compression == CompressionFormat::kNone) {
+            return ReadFilteredParallel<std::string>(predicate, output_cols, [](csv::CSVField field) {
+                return std::string(field.get<csv::string_view>());
+            });
+        }
 
-        const auto indices = ResolveIndices(csv_reader, output_cols);
+        return ScanCsvParser(compression, [&](csv::CSVReader &csv_reader) {
+            const auto indices = ResolveIndices(csv_reader, output_cols);
 
-        std::vector<std::string> result;
-        for (auto &row : csv_reader) {
-            if (predicate(row)) {
-                for (int idx : indices) {
-                    // string_view はイテレータ進行後に無効化されるため string にコピー
-                    result.emplace_back(row[idx].get<csv::string_view>());
+            std::vector<std::string> result;
+            for (auto &row : csv_reader) {
+                if (predicate(row)) {
+                    for (int idx : indices) {
+                        // string_view はイテレータ進行後に無効化されるため string にコピー
+                        result.emplace_back(row[idx].get<csv::string_view>());
+                    }
                 }
             }
+            return result;
+        });
+    }
+
+    /**
+     * @brief フィルタ付き CSV 読み込み（列指向出力）
+     *
+     * 述語が true を返す行の指定列を、列ごとの連続バッファ（ColumnTable）で返す。
+     * 列ごとに型（int64 / double / string）を指定できる。
+     * 各列の領域はファイルサイズと先頭サンプルの平均行長から見積もった行数で事前確保するため、
+     * 読み込み中の再確保が起きにくい（見積もりは全行が通過する場合の上限値）。
+     *
+     * @param predicate 行を受け取り true を返す行のみ出力対象とする述語
+     * @param specs     出力したい列名と型のリスト
+     * @return 出力対象行の指定列を列ごとに格納したテーブル（列順は specs の順）
+     * @throws std::invalid_argument 存在しない列名が specs に含まれる場合
+     *
+     * @code
+     * auto table = reader.ReadColumns(
+     *     [](const csv::CSVRow& row) { return row["flag"].get<int>() == 1; },
+     *     {{"id", utility::ColumnType::kInt64},
+     *      {"value_a", utility::ColumnType::kDouble},
+     *      {"category", utility::ColumnType::kString}});
+     * const auto& value_a = table.DoubleColumn("value_a");
+     * @endcode
+     */
+    ColumnTable ReadColumns(
+        std::function<bool(const csv::CSVRow &)> predicate,
+        const std::vector<ColumnSpec> &specs) const {
+        const CompressionFormat compression = DetectCompression(path_);
+        if (ThreadCount() > 1 && compression == CompressionFormat::kNone) {
+            return ReadColumnsParallel(predicate, specs);
         }
-        return result;
+
+        return ScanCsvParser(compression, [&](csv::CSVReader &csv_reader) {
+            const auto indices = ResolveIndices(csv_reader, SpecNames(specs));
+
+            ColumnTable table(specs);
+            if (compression == CompressionFormat::kNone) {
+                table.Reserve(EstimateFileRows()); // 圧縮ファイルはサイズから行数を見積もれない
+            }
+            for (auto &row : csv_reader) {
+                if (predicate(row)) {
+                    AppendRow(table, row, indices);
+                }
+            }
+            return table;
+        });
     }
 
-private:
-    std::string path_;
+    // ──────────────────────────────────────────────────────────
+    // CsvRowView 述語版（CsvReaderOptions::backend で読み込み方式を選択）
+    // ──────────────────────────────────────────────────────────
 
-    // 列名リストをインデックスに解決する共通実装
-    static std::vector<int> ResolveIndices(
-        csv::CSVReader &csv_reader,
-        const std::vector<std::string> &cols) {
-        std::vector<int> indices;
-        indices.reserve(cols.size());
-        for (const auto &col : cols) {
-            int idx = csv_reader.index_of(col);
-            if (idx < 0) {
-                throw std::invalid_argument("utility::CsvReader: column not found: " + col);
+    /**
+     * @brief ヘッダ行から列名のインデックスを取得する
+     *
+     * CsvRowView 述語内でインデックスアクセスするために使う。
+     *
+     * @return 列インデックス（存在しない場合は -1）
+     * @throws std::runtime_error ファイルを開けない場合
+     */
+    int IndexOf(std::string_view name) const { return ReadHeader().IndexOf(name); }
+
+    /**
+     * @brief 標本から列ごとの型・欠損の有無・数値範囲を推定する
+     *
+     * データ部の先頭 `options.head_bytes` と、残りから無作為に選んだ `options.probes` か所
+     * （各 `options.probe_bytes`）の行だけを調べるため、ファイルの大きさによらずほぼ一定の時間で終わる。
+     * 結果の CsvSchema::Specs() を ReadColumns に渡せば、列の型を呼び出し側で決めずに読める。
+     *
+     * - 先頭だけでファイル全体を読み終えた場合は正確な結果になる（CsvSchema::IsExact()）
+     * - 先頭にクォート内改行を含むファイルは、無作為な位置から行の区切りを決められないため先頭だけを調べる
+     * - 圧縮ファイルは先頭だけを伸長して調べる（EstimatedRows() は調べた行数になる）
+     *
+     * @throws std::runtime_error ファイルを開けない場合
+     *
+     * @code
+     * const auto schema = reader.InferSchema();
+     * if (schema.Column("value").IsNumeric()) {
+     *     auto table = reader.ReadColumns(utility::Col("flag") == 1, schema.Specs({"id", "value"}));
+     * }
+     * @endcode
+     */
+    CsvSchema InferSchema(const CsvSchemaOptions &options = {}) const {
+        const CompressionFormat compression = DetectCompression(path_);
+        if (compression != CompressionFormat::kNone) {
+            return InferCompressedSchema(compression, options);
+        }
+        const auto mapping = MappedFile::Open(path_);
+        const std::string_view bytes = mapping->View();
+        CsvTokenizer tokenizer(bytes);
+        std::vector<std::string_view> fields;
+        tokenizer.NextRow(fields);
+        CsvSchemaBuilder builder(CsvHeader(std::vector<std::string>(fields.begin(), fields.end())));
+        const std::size_t data_begin = tokenizer.Position();
+
+        // 先頭はトークナイザで行単位に読む（クォート内改行も正しく扱う）
+        const std::size_t head_limit = data_begin + std::min(options.head_bytes, bytes.size() - data_begin);
+        while (tokenizer.Position() < head_limit && tokenizer.NextRow(fields)) {
+            builder.AddRow(fields);
+        }
+        const std::size_t head_end = tokenizer.Position();
+        if (!tokenizer.BeginRow(fields)) {
+            return builder.Finish(builder.Rows(), true);
+        }
+
+        std::size_t sampled_bytes = head_end - data_begin;
+        if (options.probes > 0 && !HasQuotedNewline(bytes.substr(data_begin, sampled_bytes))) {
+            // 位置を昇順に並べて読む（ページの読み込みが前から順に進む）
+            std::mt19937_64 rng(options.seed);
+            std::uniform_int_distribution<std::size_t> position(head_end, bytes.size() - 1);
+            std::vector<std::size_t> starts(options.probes);
+            for (auto &start : starts) {
+                start = position(rng);
+            }
+            std::sort(starts.begin(), starts.end());
+            for (const std::size_t start : starts) {
+                CsvTokenizer probe(bytes.substr(NextLineStart(bytes, start)));
+                while (probe.Position() < options.probe_bytes && probe.NextRow(fields)) {
+                    builder.AddRow(fields);
+                }
+                sampled_bytes += probe.Position();
             }
-            indices.push_back(idx);
         }
-        return indices;
+        const double row_bytes =
+            static_cast<double>(sampled_bytes) / static_cast<double>(std::max<std::uint64_t>(1, builder.Rows()));
+        const auto estimated_rows =
+            static_cast<std::uint64_t>(static_cast<double>(bytes.size() - data_begin) / std::max(1.0, row_bytes));
+        return builder.Finish(estimated_rows, false);
+    }
+
+    /**
+     * @brief フィルタ付き CSV 読み込み（double 出力・CsvRowView 述語）
+     * @see ReadFiltered(std::function<bool(const csv::CSVRow &)>, const std::vector<std::string> &)
+     */
+    std::vector<double> ReadFiltered(
+        std::function<bool(const CsvRowView &)> predicate,
+        const std::vector<std::string> &output_cols) const {
+        const RangePlan plan = PlanRowViews(output_cols);
+        return ReadDoublesMatching(plan, PredicateMatcher<decltype(predicate)>{predicate});
+    }
+
+    /**
+     * @brief フィルタ付き CSV 読み込み（double 出力・フィルタ式）
+     *
+     * 述語の代わりに宣言的なフィルタ式（utility::CsvFilter）で行を選ぶ。
+     * mmap バックエンドでは比較に必要な列までしかフィールドを分割せず、
+     * 条件を満たさない行は残りのフィールドを分割せずに読み飛ばす。
+     *
+     * @code
+     * using utility::Col;
+     * auto values = reader.ReadFiltered(Col("flag") == 1 && Col("value_a") > 10.0, {"value_a", "value_b"});
+     * @endcode
+     *
+     * @throws std::invalid_argument 存在しない列名が output_cols またはフィルタ式に含まれる場合
+     */
+    std::vector<double> ReadFiltered(const CsvFilter &filter, const std::vector<std::string> &output_cols) const {
+        const RangePlan plan = PlanRowViews(output_cols);
+        return ReadDoublesMatching(plan, FilterMatcher{filter.Compile(plan.header)});
+    }
+
+    /**
+     * @brief フィルタ付き CSV 読み込み（string 出力・CsvRowView 述語）
+     * @see ReadFilteredAsStrings(std::function<bool(const csv::CSVRow &)>, const std::vector<std::string> &)
+     */
+    std::vector<std::string> ReadFilteredAsStrings(
+        std::function<bool(const CsvRowView &)> predicate,
+        const std::vector<std::string> &output_cols) const {
+        const RangePlan plan = PlanRowViews(output_cols);
+        return ReadStringsMatching(plan, PredicateMatcher<decltype(predicate)>{predicate});
+    }
+
+    /**
+     * @brief フィルタ付き CSV 読み込み（string 出力・フィルタ式）
+     * @see ReadFiltered(const CsvFilter &, const std::vector<std::string> &)
+     */
+    std::vector<std::string> ReadFilteredAsStrings(
+        const CsvFilter &filter,
+        const std::vector<std::string> &output_cols) const {
+        const RangePlan plan = PlanRowViews(output_cols);
+        return ReadStringsMatching(plan, FilterMatcher{filter.Compile(plan.header)});
+    }
+
+    /**
+     * @brief フィルタ付き CSV 読み込み（string_view 出力・コピーなし）
+     *
+     * `ReadFilteredAsStrings` の string_view 版。`CsvBackend::kMmap` では各要素がマップした
+     * ファイルを直接指すため、フィールドごとのメモリ確保が発生しない。
+     * "" エスケープを含むフィールドと `CsvBackend::kCsvParser` / `kReadAhead` の場合は結果内部のアリーナに
+     * コピーする。いずれの場合も結果オブジェクトの生存中は各要素が有効である。
+     *
+     * @param predicate  行を受け取り true を返す行のみ出力対象とする述語
+     * @param output_cols 出力したい列名のリスト
+     * @return 出力対象行の指定列を列挙した string_view の配列（所有権付き）
+     * @throws std::invalid_argument 存在しない列名が output_cols に含まれる場合
+     */
+    CsvStringViews ReadFilteredAsViews(
+        std::function<bool(const CsvRowView &)> predicate,
+        const std::vector<std::string> &output_cols) const {
+        const RangePlan plan = PlanRowViews(output_cols);
+        return ReadViewsMatching(plan, PredicateMatcher<decltype(predicate)>{predicate});
+    }
+
+    /**
+     * @brief フィルタ付き CSV 読み込み（string_view 出力・フィルタ式）
+     * @see ReadFilteredAsViews(std::function<bool(const CsvRowView &)>, const std::vector<std::string> &)
+     */
+    CsvStringViews ReadFilteredAsViews(const CsvFilter &filter, const std::vector<std::string> &output_cols) const {
+        const RangePlan plan = PlanRowViews(output_cols);
+        return ReadViewsMatching(plan, FilterMatcher{filter.Compile(plan.header)});
+    }
+
+    /**
+     * @brief フィルタ付き CSV 読み込み（列指向出力・CsvRowView 述語）
+     *
+     * `CsvBackend::kMmap` では文字列列がマップしたファイルを直接指し（コピーなし）、
+     * テーブルがマップの所有権を共有する。
+     *
+     * @see ReadColumns(std::function<bool(const csv::CSVRow &)>, const std::vector<ColumnSpec> &)
+     */
+    ColumnTable ReadColumns(
+        std::function<bool(const CsvRowView &)> predicate,
+        const std::vector<ColumnSpec> &specs) const {
+        const RangePlan plan = PlanRowViews(SpecNames(specs));
+        return ReadColumnsMatching(plan, PredicateMatcher<decltype(predicate)>{predicate}, specs);
+    }
+
+    /**
+     * @brief フィルタ付き CSV 読み込み（列指向出力・フィルタ式）
+     * @see ReadFiltered(const CsvFilter &, const std::vector<std::string> &)
+     */
+    ColumnTable ReadColumns(const CsvFilter &filter, const std::vector<ColumnSpec> &specs) const {
+        const RangePlan plan = PlanRowViews(SpecNames(specs));
+        return ReadColumnsMatching(plan, FilterMatcher{filter.Compile(plan.header)}, specs);
+    }
+
+    /**
+     * @brief 複数の問い合わせに 1 回の走査で答える
+     *
+     * 同じファイルに条件・出力列の異なる ReadColumns を N 回呼ぶ代わりに使う。
+     * ファイルの読み込みとトークナイズは 1 回だけで、各行を全問い合わせの条件で評価する。
+     * 読み込み方式（backend・column_cache）と並列スキャン（num_threads）は CsvRowView 述語版と同じ。
+     *
+     * - フィルタ式だけの問い合わせ集合では、条件と出力に使う最も後ろの列までしかフィールドを分割しない
+     * - 述語を含む場合は行全体を分割する
+     *
+     * @param queries 問い合わせの集合
+     * @return 問い合わせごとの結果（CsvQuerySet::Add の戻り値の位置に入る）
+     * @throws std::invalid_argument 存在しない列名が出力列・フィルタ式に含まれる場合
+     * @throws std::runtime_error 数値列のフィールドを数値に変換できない場合
+     */
+    std::vector<ColumnTable> ReadQueries(const CsvQuerySet &queries) const {
+        if (queries.Empty()) {
+            return {};
+        }
+        std::vector<std::string> names;
+        for (const auto &query : queries.queries_) {
+            for (const auto &spec : query.specs) {
+                names.push_back(spec.name);
+            }
+        }
+        RangePlan plan = PlanRowViews(names);
+
+        // 問い合わせごとに出力列を解決し、行ごとに分割が必要なフィールド数を求める
+        std::vector<QueryMatcher> matchers;
+        matchers.reserve(queries.Size());
+        std::size_t needed_fields = OutputFieldCount(plan);
+        for (const auto &query : queries.queries_) {
+            QueryMatcher matcher{query.predicate, std::nullopt, ResolveIndices(plan.header, SpecNames(query.specs))};
+            if (query.filter) {
+                matcher.filter = query.filter->Compile(plan.header);
+                needed_fields = std::max(needed_fields, matcher.filter->RequiredFields());
+            } else {
+                needed_fields = plan.header.Size();
+            }
+            matchers.push_back(std::move(matcher));
+        }
+        // 走査の出力列を「先頭から needed_fields 列」にして、全問い合わせの評価に必要なフィールドを揃える
+        plan.indices.resize(needed_fields);
+        for (std::size_t i = 0; i < needed_fields; ++i) {
+            plan.indices[i] = static_cast<int>(i);
+        }
+
+        const MappedFile *mapping = plan.mapping.get();
+        auto partials = ScanMatching<std::vector<ColumnTable>>(
+            plan,
+            AllRowsMatcher{},
+            [&](std::vector<ColumnTable> &tables, const ByteRange &) {
+                for (const auto &query : queries.queries_) {
+                    tables.emplace_back(query.specs);
+                }
+            },
+            [&](std::vector<ColumnTable> &tables, const CsvRowView &row) {
+                for (std::size_t q = 0; q < matchers.size(); ++q) {
+                    if (matchers[q].Match(row)) {
+                        AppendRowView(tables[q], row, matchers[q].indices, mapping);
+                    }
+                }
+            }
+        );
+
+        std::vector<ColumnTable> results;
+        results.reserve(queries.Size());
+        for (std::size_t q = 0; q < queries.Size(); ++q) {
+            std::vector<ColumnTable> parts;
+            parts.reserve(partials.size());
+            for (auto &tables : partials) {
+                parts.push_back(std::move(tables[q]));
+            }
+            results.push_back(MergeTables(queries.queries_[q].specs, std::move(parts)));
+            if (plan.mapping) {
+                results.back().Retain(plan.mapping);
+            }
+        }
+        return results;
+    }
+
+    /**
+     * @brief フィルタ付きグループ集計（CsvRowView 述語）
+     *
+     * 条件を満たす行を group_by 列の値でグループ分けし、value_cols の各列の件数・合計・最小・最大を求める。
+     * 集計は走査中に行い、出力値の中間配列は作らない。並列スキャンでは範囲ごとに部分集計を作り、
+     * 最後に範囲の順に合成する（グループの順は単一スレッドと同じく最初に現れた順）。
+     *
+     * @param predicate  行を集計するかどうかの判定関数
+     * @param group_by   グループ分けに使う列名（空文字列なら全行を 1 グループ（キー ""）として集計する）
+     * @param value_cols 集計する数値列の列名
+     * @return グループごとの集計結果
+     * @throws std::invalid_argument 存在しない列名が指定された場合
+     * @throws std::runtime_error value_cols の列のフィールドを数値に変換できない場合
+     *
+     * @code
+     * auto by_category = reader.ReadAggregates(utility::Col("flag") == 1, "category", {"value_a"});
+     * double mean_a = by_category.Stats("A", "value_a").Mean();
+     * @endcode
+     */
+    GroupedAggregates ReadAggregates(
+        std::function<bool(const CsvRowView &)> predicate,
+        const std::string &group_by,
+        const std::vector<std::string> &value_cols) const {
+        const RangePlan plan = PlanRowViews(AggregateColumns(group_by, value_cols));
+        return ReadAggregatesMatching(plan, PredicateMatcher<decltype(predicate)>{predicate}, group_by, value_cols);
+    }
+
+    /**
+     * @brief フィルタ付きグループ集計（フィルタ式）
+     * @see ReadAggregates(std::function<bool(const CsvRowView &)>, const std::string &,
+     *      const std::vector<std::string> &)
+     */
+    GroupedAggregates ReadAggregates(
+        const CsvFilter &filter,
+        const std::string &group_by,
+        const std::vector<std::string> &value_cols) const {
+        const RangePlan plan = PlanRowViews(AggregateColumns(group_by, value_cols));
+        return ReadAggregatesMatching(plan, FilterMatcher{filter.Compile(plan.header)}, group_by, value_cols);
+    }
+
+    /**
+     * @brief フィルタ付きヒストグラム（CsvRowView 述語）
+     *
+     * 条件を満たす行の column 列の値を [lower, upper) の bins 個の等幅ビンで数える。
+     * ReadAggregates と同じく走査中に集計し、並列スキャンでは部分ヒストグラムを合成する。
+     *
+     * @throws std::invalid_argument 存在しない列名が指定された場合、bins が 0 または lower < upper でない場合
+     * @throws std::runtime_error 列のフィールドを数値に変換できない場合
+     */
+    Histogram ReadHistogram(
+        std::function<bool(const CsvRowView &)> predicate,
+        const std::string &column,
+        double lower,
+        double upper,
+        std::size_t bins) const {
+        const Histogram empty(lower, upper, bins);
+        const RangePlan plan = PlanRowViews({column});
+        return ReadHistogramMatching(plan, PredicateMatcher<decltype(predicate)>{predicate}, empty);
+    }
+
+    /**
+     * @brief フィルタ付きヒストグラム（フィルタ式）
+     * @see ReadHistogram(std::function<bool(const CsvRowView &)>, const std::string &, double, double, std::size_t)
+     */
+    Histogram ReadHistogram(
+        const CsvFilter &filter,
+        const std::string &column,
+        double lower,
+        double upper,
+        std::size_t bins) const {
+        const Histogram empty(lower, upper, bins);
+        const RangePlan plan = PlanRowViews({column});
+        return ReadHistogramMatching(plan, FilterMatcher{filter.Compile(plan.header)}, empty);
+    }
+
+    /// ReadBatches() の 1 バッチあたりの既定行数
+    static constexpr std::size_t kDefaultBatchRows = std::size_t{64} * 1024;
+
+    /**
+     * @brief フィルタ付き CSV 読み込み（バッチ単位のストリーミング・CsvRowView 述語）
+     *
+     * ファイル全体を 1 つのテーブルに集めず、batch_rows 行ごとの ColumnTable を consumer に渡す。
+     * 解析は専用スレッドで先行して行い、consumer がバッチを処理している間に次のバッチを作る
+     * （解析と後段処理が重なる）。同時に存在するバッチは最大 3 つ（解析中・受け渡し待ち・処理中）
+     * のため、メモリ使用量はファイルサイズによらず batch_rows で決まる。
+     *
+     * - バッチはファイル内の行順に渡される。最後のバッチは batch_rows 行未満になりうる
+     * - predicate は解析スレッドで、consumer は呼び出し元のスレッドで呼ばれる
+     * - consumer に渡したテーブルは consumer から戻ると破棄される（必要なら std::move で持ち出す）
+     * - CsvReaderOptions::num_threads は使わない（解析スレッドは常に 1 つ）
+     *
+     * @param predicate  行を出力するかどうかの判定関数
+     * @param specs      出力列（列名と型）の配列
+     * @param consumer   バッチごとに呼ばれる処理関数
+     * @param batch_rows 1 バッチあたりの最大行数（0 は 1 として扱う）
+     * @throws std::invalid_argument 存在しない列名が specs に含まれる場合
+     * @throws std::runtime_error 数値列のフィールドを数値に変換できない場合
+     * @note predicate・consumer が投げた例外は解析を止めたうえで呼び出し元に再送出される
+     *
+     * @code
+     * double sum = 0.0;
+     * reader.ReadBatches(
+     *     [flag](const utility::CsvRowView& row) { return row[flag].get<int>() == 1; },
+     *     {{"value_a", utility::ColumnType::kDouble}},
+     *     [&](utility::ColumnTable& batch) {
+     *         for (double v : batch.DoubleColumn(0)) sum += v;
+     *     });
+     * @endcode
+     */
+    void ReadBatches(
+        std::function<bool(const CsvRowView &)> predicate,
+        const std::vector<ColumnSpec> &specs,
+        const std::function<void(ColumnTable &)> &consumer,
+        std::size_t batch_rows = kDefaultBatchRows) const {
+        const RangePlan plan = PlanRowViews(SpecNames(specs));
+        ReadBatchesMatching(plan, PredicateMatcher<decltype(predicate)>{predicate}, specs, consumer, batch_rows);
+    }
+
+    /**
+     * @brief フィルタ付き CSV 読み込み（バッチ単位のストリーミング・フィルタ式）
+     * @see ReadBatches(std::function<bool(const CsvRowView &)>, const std::vector<ColumnSpec> &,
+     *      const std::function<void(ColumnTable &)> &, std::size_t)
+     */
+    void ReadBatches(
+        const CsvFilter &filter,
+        const std::vector<ColumnSpec> &specs,
+        const std::function<void(ColumnTable &)> &consumer,
+        std::size_t batch_rows = kDefaultBatchRows) const {
+        const RangePlan plan = PlanRowViews(SpecNames(specs));
+        ReadBatchesMatching(plan, FilterMatcher{filter.Compile(plan.header)}, specs, consumer, batch_rows);
+    }
+
+    // ──────────────────────────────────────────────────────────
+    // 行番号による部分読み込み（行位置インデックスで目的の行へ直接移動する）
+    // ──────────────────────────────────────────────────────────
+
+    /**
+     * @brief 行位置インデックスを返す（初回の呼び出しで作り、以降は再利用する）
+     *
+     * `CsvReaderOptions::persist_row_index` が true ならサイドカーファイル（CsvRowIndex::PathFor）を
+     * 開き、なければ作成して保存する。ファイルが更新されていれば作り直す。
+     *
+     * @throws std::invalid_argument 圧縮ファイルの場合（任意の位置へ移動できない）
+     * @throws std::runtime_error ファイルを読めない・インデックスを保存できない場合
+     */
+    std::shared_ptr<const CsvRowIndex> RowIndex() const {
+        if (DetectCompression(path_) != CompressionFormat::kNone) {
+            throw std::invalid_argument(
+                "utility::CsvReader: row access is not supported for compressed input: " + path_
+            );
+        }
+        std::lock_guard<std::mutex> lock(row_index_->mutex);
+        if (!row_index_->index || !row_index_->index->Matches(path_)) {
+            if (options_.persist_row_index) {
+                const std::string index_path = CsvRowIndex::PathFor(path_, options_.cache_dir);
+                row_index_->index = CsvRowIndex::OpenOrBuild(path_, index_path, options_.row_index_stride);
+            } else {
+                row_index_->index = CsvRowIndex::Build(path_, options_.row_index_stride);
+            }
+        }
+        return row_index_->index;
+    }
+
+    /**
+     * @brief データ行数（ヘッダ行・空行を除く。初回は行位置インデックスの作成でファイル全体を走査する）
+     */
+    std::uint64_t RowCount() const { return RowIndex()->RowCount(); }
+
+    /**
+     * @brief 行番号 [first, last) のデータ行を読む（0 始まり、ヘッダ行を除く）
+     *
+     * 行位置インデックスで first 以前の最も近い記録位置へ移動してから読むため、
+     * ファイル先頭からの走査はインデックスの作成時だけで済む。行の数え方は内蔵トークナイザと同じ
+     * （空行は数えず、クォート内の改行は行の区切りにならない）。first・last は行数で切り詰める。
+     *
+     * @param specs 出力列（列名と型）の配列
+     * @throws std::invalid_argument first > last・存在しない列名・圧縮ファイルの場合
+     * @throws std::runtime_error 数値列のフィールドを数値に変換できない場合
+     *
+     * @code
+     * auto rows = reader.ReadRange(1'000'000, 1'000'100, {{"id", utility::ColumnType::kInt64}});
+     * @endcode
+     */
+    ColumnTable ReadRange(std::uint64_t first, std::uint64_t last, const std::vector<ColumnSpec> &specs) const {
+        if (first > last) {
+            throw std::invalid_argument("utility::CsvReader: ReadRange requires first <= last");
+        }
+        const std::uint64_t row_count = RowCount();
+        first = std::min(first, row_count);
+        last = std::min(last, row_count);
+        return ReadIndexedRows(specs, last - first, [first](std::uint64_t i) { return first + i; });
+    }
+
+    /**
+     * @brief 指定した行番号のデータ行を読む（行番号は ReadRange と同じ数え方）
+     *
+     * 次の行が記録間隔以上離れていれば読み飛ばさずに記録位置へ移動する。
+     *
+     * @param rows  行番号（狭義単調増加）
+     * @param specs 出力列（列名と型）の配列
+     * @throws std::invalid_argument rows が狭義単調増加でない・存在しない列名・圧縮ファイルの場合
+     * @throws std::out_of_range 行数以上の行番号を含む場合
+     * @throws std::runtime_error 数値列のフィールドを数値に変換できない場合
+     */
+    ColumnTable ReadRows(const std::vector<std::uint64_t> &rows, const std::vector<ColumnSpec> &specs) const {
+        if (std::adjacent_find(rows.begin(), rows.end(), std::greater_equal<>()) != rows.end()) {
+            throw std::invalid_argument("utility::CsvReader: ReadRows requires strictly increasing row numbers");
+        }
+        return ReadIndexedRows(specs, rows.size(), [&rows](std::uint64_t i) {
+            return rows[static_cast<std::size_t>(i)];
+        });
+    }
+
+    /**
+     * @brief 標本として読む行番号を選ぶ（昇順・重複なし。ReadRows にそのまま渡せる）
+     *
+     * 同じ seed・行数なら同じ結果になる。count が 0 なら空、行数以上なら全行を返す。
+     *
+     * @param count  選ぶ行数
+     * @param method 一様抽出（kUniform）または区間ごとの層化抽出（kStratified）
+     * @param seed   乱数の種
+     * @throws std::invalid_argument 圧縮ファイルの場合
+     */
+    std::vector<std::uint64_t> SampleRows(
+        std::size_t count,
+        CsvSampling method = CsvSampling::kUniform,
+        std::uint64_t seed = 0) const {
+        const std::uint64_t row_count = RowCount();
+        std::vector<std::uint64_t> rows;
+        if (count == 0) {
+            return rows;
+        }
+        if (count >= row_count) {
+            rows.resize(static_cast<std::size_t>(row_count));
+            std::iota(rows.begin(), rows.end(), std::uint64_t{0});
+            return rows;
+        }
+        std::mt19937_64 rng(seed);
+        rows.reserve(count);
+        if (method == CsvSampling::kStratified) {
+            // 区間 k は [row_count * k / count, row_count * (k + 1) / count)（積のオーバーフローを避けて計算する）
+            const std::uint64_t quotient = row_count / count;
+            const std::uint64_t remainder = row_count % count;
+            auto bound = [&](std::uint64_t k) { return quotient * k + remainder * k / count; };
+            for (std::uint64_t k = 0; k < count; ++k) {
+                rows.push_back(std::uniform_int_distribution<std::uint64_t>(bound(k), bound(k + 1) - 1)(rng));
+            }
+            return rows;
+        }
+        // Floyd の方法: count 回の乱数で重複のない count 行を選ぶ（行数に比例するメモリ・時間を使わない）
+        std::unordered_set<std::uint64_t> chosen;
+        chosen.reserve(count);
+        for (std::uint64_t j = row_count - count; j < row_count; ++j) {
+            const std::uint64_t pick = std::uniform_int_distribution<std::uint64_t>(0, j)(rng);
+            if (!chosen.insert(pick).second) {
+                chosen.insert(j);
+            }
+        }
+        rows.assign(chosen.begin(), chosen.end());
+        std::sort(rows.begin(), rows.end());
+        return rows;
+    }
+
+    /**
+     * @brief 標本抽出した行を読む（SampleRows() で選んだ行を ReadRows() で読む）
+     * @see SampleRows, ReadRows
+     */
+    ColumnTable ReadSample(
+        std::size_t count,
+        const std::vector<ColumnSpec> &specs,
+        CsvSampling method = CsvSampling::kUniform,
+        std::uint64_t seed = 0) const {
+        return ReadRows(SampleRows(count, method, seed), specs);
+    }
+
+    /**
+     * @brief 型付き列射影（コンパイル時特殊化）
+     *
+     * 述語と出力列の型をテンプレート引数で固定した `ReadFiltered` 相当の読み込み。
+     * 述語は std::function を介さずインライン展開され、出力列の個数・型・インデックスも
+     * コンパイル時に固定されるため、手書きのループ（bench_csv の (D) hardcoded）と同等の
+     * コードになる。読み込み方式・並列化は `CsvRowView` 述語版と同じ。
+     *
+     * @tparam Ts        出力列の型（整数型・浮動小数点型・std::string）
+     * @param predicate  `bool(const CsvRowView &)` として呼び出せる述語
+     * @param output_cols 出力したい列名（Ts と同じ個数）
+     * @return 列ごとの配列のタプル（`std::get<i>` が output_cols[i] の列）
+     * @throws std::invalid_argument 存在しない列名が output_cols に含まれる場合
+     * @throws std::runtime_error 出力列を Ts に変換できない場合
+     *
+     * @code
+     * const int flag = reader.IndexOf("flag");
+     * auto [ids, values] = reader.Read<std::int64_t, double>(
+     *     [flag](const utility::CsvRowView& row) { return row[flag].get<int>() == 1; },
+     *     {"id", "value_a"});
+     * @endcode
+     */
+    template <typename... Ts, typename Predicate>
+    std::tuple<std::vector<Ts>...> Read(
+        Predicate predicate,
+        const std::array<std::string, sizeof...(Ts)> &output_cols) const {
+        static_assert(sizeof...(Ts) > 0, "CsvReader::Read requires at least one output column type");
+        using Columns = std::tuple<std::vector<Ts>...>;
+
+        const RangePlan plan = PlanRowViews(std::vector<std::string>(output_cols.begin(), output_cols.end()));
+        std::array<std::size_t, sizeof...(Ts)> indices{};
+        std::copy(plan.indices.begin(), plan.indices.end(), indices.begin());
+
+        auto partials = ScanMatching<Columns>(
+            plan,
+            PredicateMatcher<Predicate>{predicate},
+            [](Columns &, const ByteRange &) {},
+            [&](Columns &out, const CsvRowView &row) {
+                AppendTyped(out, row, indices, std::index_sequence_for<Ts...>{});
+            }
+        );
+        return ConcatColumns(std::move(partials), std::index_sequence_for<Ts...>{});
+    }
+
+private:
+    // ファイル内のバイト範囲 [begin, end)
+    struct ByteRange {
+        std::uint64_t begin;
+        std::uint64_t end;
+    };
+
+    // 行位置インデックスの保持先（CsvReader のコピー間で共有する）
+    struct RowIndexSlot {
+        std::mutex mutex;
+        std::shared_ptr<const CsvRowIndex> index;
+    };
+
+    // kAuto の判定結果（クォート内改行の有無）の保持先（CsvReader のコピー間で共有する）
+    // stamp（サイズ・更新時刻）が現在のファイルと一致する間は走査し直さない
+    struct LayoutSlot {
+        std::mutex mutex;
+        bool known = false;
+        bool quoted_newline = false;
+        SourceStamp stamp;
+    };
+
+    std::string path_;
+    CsvReaderOptions options_;
+    std::shared_ptr<RowIndexSlot> row_index_;
+    std::shared_ptr<LayoutSlot> layout_;
+
+    // 列名リストをインデックスに解決する共通実装
+    static std::vector<int> ResolveIndices(
+        csv::CSVReader &csv_reader,
+        const std::vector<std::string> &cols) {
+        std::vector<int> indices;
+        indices.reserve(cols.size());
+        for (const auto &col : cols) {
+            int idx = csv_reader.index_of(col);
+            if (idx < 0) {
+                throw std::invalid_argument("utility::CsvReader: column not found: " + col);
+            }
+            indices.push_back(idx);
+        }
+        return indices;
+    }
+
+    static std::vector<int> ResolveIndices(const CsvHeader &header, const std::vector<std::string> &cols) {
+        std::vector<int> indices;
+        indices.reserve(cols.size());
+        for (const auto &col : cols) {
+            int idx = header.IndexOf(col);
+            if (idx < 0) {
+                throw std::invalid_argument("utility::CsvReader: column not found: " + col);
+            }
+            indices.push_back(idx);
+        }
+        return indices;
+    }
+
+    unsigned int ThreadCount() const {
+        if (options_.num_threads == 0) {
+            return std::max(1U, std::thread::hardware_concurrency());
+        }
+        return options_.num_threads;
+    }
+
+    // ──────────────────────────────────────────────────────────
+    // 並列スキャンの共通実装（各 Read 系メソッドが共有）
+    // ──────────────────────────────────────────────────────────
+
+    // 並列スキャンの準備結果
+    struct RangePlan {
+        csv::CSVFormat format;                     // 範囲解析用（ヘッダなし・列名はヘッダ行のもの）
+        CsvHeader header;                          // CsvRowView 用の列名表
+        std::vector<int> indices;                  // 出力列のインデックス
+        std::vector<ByteRange> ranges;             // 行順に並んだレコード境界揃えの範囲
+        double row_bytes = 0.0;                    // 先頭サンプルから見積もった 1 行あたりのバイト数
+        std::shared_ptr<const MappedFile> mapping; // kMmap・キャッシュ使用時のみ設定（kMmap では ranges はマップ内オフセット）
+        std::shared_ptr<const CsvColumnCache> cache; // キャッシュ使用時のみ設定（ranges は行番号、mapping はキャッシュ）
+        bool read_ahead = false;                     // kReadAhead・圧縮入力で true（ranges はデータ部全体の 1 範囲）
+        CompressionFormat compression = CompressionFormat::kNone; // 圧縮入力の形式（ranges は伸長後のオフセット）
+    };
+
+    // ヘッダ行を解析して出力列を解決し、データ部を範囲に分割する
+    RangePlan PlanRanges(const std::vector<std::string> &output_cols) const {
+        std::ifstream ifs(path_, std::ios::binary);
+        if (!ifs) {
+            throw std::runtime_error("utility::CsvReader: cannot open file: " + path_);
+        }
+
+        // ヘッダ行だけを csv-parser に解析させて列名を得る
+        std::string header_line;
+        std::getline(ifs, header_line);
+        const std::streamoff header_end = ifs.tellg();
+        std::istringstream header_stream(header_line);
+        csv::CSVReader header_reader(header_stream);
+
+        RangePlan plan;
+        plan.indices = ResolveIndices(header_reader, output_cols);
+        // 各範囲はヘッダなしで解析し、列名はヘッダ行のものを使う
+        plan.format.column_names(header_reader.get_col_names());
+        plan.header = CsvHeader(header_reader.get_col_names());
+        if (header_end < 0) {
+            return plan; // ヘッダ行のみ（末尾改行なし）
+        }
+        const auto data_begin = static_cast<std::uint64_t>(header_end);
+        plan.row_bytes = SampleRowBytes(ifs, data_begin);
+        ifs.clear();
+        ifs.seekg(0, std::ios::end);
+        const auto file_size = static_cast<std::uint64_t>(ifs.tellg());
+        plan.ranges = SplitRecordAligned(data_begin, file_size, [&](std::uint64_t pos) {
+            return NextRecordStart(ifs, pos, file_size);
+        });
+        return plan;
+    }
+
+    // ファイルを mmap してヘッダ行を内蔵トークナイザで解析し、データ部をマップ内の範囲に分割する
+    RangePlan PlanMapped(
+        const std::vector<std::string> &output_cols,
+        std::shared_ptr<const MappedFile> mapping) const {
+        RangePlan plan;
+        plan.mapping = std::move(mapping);
+        const std::string_view bytes = plan.mapping->View();
+
+        CsvTokenizer tokenizer(bytes);
+        std::vector<std::string_view> names;
+        tokenizer.NextRow(names);
+        plan.header = CsvHeader(std::vector<std::string>(names.begin(), names.end()));
+        plan.indices = ResolveIndices(plan.header, output_cols);
+
+        const std::uint64_t data_begin = tokenizer.Position();
+        plan.row_bytes = AverageRowBytes(bytes.substr(data_begin, kSampleBytes));
+        plan.ranges = SplitRecordAligned(data_begin, bytes.size(), [&](std::uint64_t pos) {
+            return NextLineStart(bytes, pos);
+        });
+        return plan;
+    }
+
+    // キャッシュの行を範囲に分割する（ByteRange は行番号の範囲として使う）
+    RangePlan PlanCached(
+        const std::vector<std::string> &output_cols,
+        std::shared_ptr<const CsvColumnCache> cache) const {
+        RangePlan plan;
+        plan.cache = std::move(cache);
+        plan.mapping = plan.cache->Mapping();
+        plan.header = plan.cache->Header();
+        plan.indices = ResolveIndices(plan.header, output_cols);
+        plan.row_bytes = 1.0; // EstimateRows() に行数をそのまま渡すため
+
+        // range_bytes を元 CSV の平均行長で行数に換算し、SplitRecordAligned と同じ方針で分割する
+        const std::uint64_t rows = plan.cache->RowCount();
+        if (rows == 0) {
+            return plan;
+        }
+        const double source_row_bytes = std::max(1.0, static_cast<double>(plan.cache->SourceSize()) / rows);
+        const auto range_rows = std::max<std::uint64_t>(
+            1, static_cast<std::uint64_t>(static_cast<double>(options_.range_bytes) / source_row_bytes)
+        );
+        const std::uint64_t count =
+            std::min(rows, std::max<std::uint64_t>(ThreadCount(), (rows + range_rows - 1) / range_rows));
+        plan.ranges.reserve(count);
+        for (std::uint64_t k = 0; k < count; ++k) {
+            plan.ranges.push_back({rows * k / count, rows * (k + 1) / count});
+        }
+        return plan;
+    }
+
+    // ヘッダ行を内蔵トークナイザで解析し、データ部全体を先読み対象の 1 範囲とする
+    // （範囲の分割は先読みしたブロック単位で行う）
+    RangePlan PlanReadAhead(const std::vector<std::string> &output_cols) const {
+        std::ifstream ifs(path_, std::ios::binary);
+        if (!ifs) {
+            throw std::runtime_error("utility::CsvReader: cannot open file: " + path_);
+        }
+        std::string header_line;
+        std::getline(ifs, header_line);
+        const std::streamoff header_end = ifs.tellg();
+        CsvTokenizer tokenizer(header_line);
+        std::vector<std::string_view> names;
+        tokenizer.NextRow(names);
+
+        RangePlan plan;
+        plan.read_ahead = true;
+        plan.header = CsvHeader(std::vector<std::string>(names.begin(), names.end()));
+        plan.indices = ResolveIndices(plan.header, output_cols);
+        if (header_end < 0) {
+            return plan; // ヘッダ行のみ（末尾改行なし）
+        }
+        const auto data_begin = static_cast<std::uint64_t>(header_end);
+        plan.row_bytes = SampleRowBytes(ifs, data_begin);
+        ifs.clear();
+        ifs.seekg(0, std::ios::end);
+        const auto file_size = static_cast<std::uint64_t>(ifs.tellg());
+        if (data_begin < file_size) {
+            plan.ranges.push_back({data_begin, file_size});
+        }
+        return plan;
+    }
+
+    // 圧縮ファイルの先頭を伸長してヘッダ行と行長のサンプルを得る
+    // 伸長後の先頭バイト列を head に入れ、ヘッダ行の直後の位置（伸長後のオフセット）を返す
+    // sample_bytes はヘッダ行の後ろに読む最小のバイト数（末尾に達すればそれより少ない）
+    std::size_t ReadCompressedHead(
+        CompressionFormat format,
+        std::string &head,
+        std::size_t sample_bytes = kSampleBytes) const {
+        const auto source = OpenDecompressed(path_, format);
+        std::size_t header_end = std::string::npos;
+        while (true) {
+            const std::size_t used = head.size();
+            head.resize(used + kSampleBytes);
+            const std::size_t got = source->Read(head.data() + used, kSampleBytes);
+            head.resize(used + got);
+            if (header_end == std::string::npos) {
+                header_end = head.find('\n', used);
+                if (header_end != std::string::npos) {
+                    ++header_end;
+                }
+            }
+            if (got < kSampleBytes) {
+                break; // 末尾に達した
+            }
+            if (header_end != std::string::npos && head.size() - header_end >= sample_bytes) {
+                break;
+            }
+        }
+        return header_end == std::string::npos ? head.size() : header_end;
+    }
+
+    // 圧縮ファイルは伸長しながら先読みする（範囲の分割は伸長したブロック単位で行う）
+    RangePlan PlanCompressed(const std::vector<std::string> &output_cols, CompressionFormat format) const {
+        std::string head;
+        const std::size_t data_begin = ReadCompressedHead(format, head);
+        CsvTokenizer tokenizer(std::string_view(head).substr(0, data_begin));
+        std::vector<std::string_view> names;
+        tokenizer.NextRow(names);
+
+        RangePlan plan;
+        plan.read_ahead = true;
+        plan.compression = format;
+        plan.header = CsvHeader(std::vector<std::string>(names.begin(), names.end()));
+        plan.indices = ResolveIndices(plan.header, output_cols);
+        plan.row_bytes = AverageRowBytes(std::string_view(head).substr(data_begin));
+        if (data_begin < head.size()) {
+            // 伸長後の全体サイズは読み終えるまでわからないため、end は伸長済みの先頭部分の末尾とする
+            // （先読みでは begin だけを使う）
+            plan.ranges.push_back({data_begin, head.size()});
+        }
+        return plan;
+    }
+
+    // 圧縮ファイルの先頭 options.head_bytes を伸長して列の型を推定する
+    CsvSchema InferCompressedSchema(CompressionFormat format, const CsvSchemaOptions &options) const {
+        std::string head;
+        const std::size_t data_begin = ReadCompressedHead(format, head, options.head_bytes);
+        CsvTokenizer header_tokenizer(std::string_view(head).substr(0, data_begin));
+        std::vector<std::string_view> fields;
+        header_tokenizer.NextRow(fields);
+        CsvSchemaBuilder builder(CsvHeader(std::vector<std::string>(fields.begin(), fields.end())));
+
+        // 末尾まで伸長していなければ最後の改行より後ろ（途中で切れた行）は使わない
+        const bool exact = head.size() - data_begin < options.head_bytes;
+        std::string_view data = std::string_view(head).substr(data_begin);
+        if (!exact) {
+            data = data.substr(0, data.rfind('\n') + 1);
+        }
+        CsvTokenizer tokenizer(data);
+        while (tokenizer.NextRow(fields)) {
+            builder.AddRow(fields);
+        }
+        return builder.Finish(builder.Rows(), exact);
+    }
+
+    // 先読みの読み込み元を開く（圧縮ファイルは伸長し、ヘッダ行を読み捨てる）
+    std::unique_ptr<ByteSource> OpenDataSource(const RangePlan &plan) const {
+        const std::uint64_t begin = plan.ranges.front().begin;
+        if (plan.compression == CompressionFormat::kNone) {
+            return std::make_unique<FileSource>(path_, begin);
+        }
+        auto source = OpenDecompressed(path_, plan.compression, ThreadCount());
+        source->Skip(static_cast<std::size_t>(begin));
+        return source;
+    }
+
+    // csv::CSVRow 述語版の単一スレッド読み込み。ファイルを csv-parser で開いて scan(csv_reader) の結果を返す
+    // 圧縮ファイルは伸長しながら istream として渡す（区切り文字はカンマ。先頭から順に伸長するため並列化しない）
+    template <typename Scan>
+    std::invoke_result_t<Scan &, csv::CSVReader &> ScanCsvParser(CompressionFormat compression, Scan scan) const {
+        if (compression == CompressionFormat::kNone) {
+            csv::CSVReader csv_reader(path_);
+            return scan(csv_reader);
+        }
+        ByteSourceStream stream(OpenDecompressed(path_, compression, ThreadCount()));
+        csv::CSVReader csv_reader(stream, csv::CSVFormat());
+        return scan(csv_reader);
+    }
+
+    RangePlan PlanRowViews(const std::vector<std::string> &output_cols) const {
+        // 圧縮ファイルは backend・column_cache の指定によらず伸長しながら読む
+        const CompressionFormat compression = DetectCompression(path_);
+        if (compression != CompressionFormat::kNone) {
+            return PlanCompressed(output_cols, compression);
+        }
+        if (options_.column_cache) {
+            const std::string cache_path = CsvColumnCache::PathFor(path_, options_.cache_dir);
+            return PlanCached(output_cols, CsvColumnCache::OpenOrBuild(path_, cache_path));
+        }
+        switch (options_.backend) {
+            case CsvBackend::kCsvParser:
+                return PlanRanges(output_cols);
+            case CsvBackend::kMmap:
+                return PlanMapped(output_cols, MappedFile::Open(path_));
+            case CsvBackend::kReadAhead:
+                return PlanReadAhead(output_cols);
+            case CsvBackend::kAuto:
+                break;
+        }
+        // クォート内改行があると改行位置での範囲分割・内蔵トークナイザが使えないため csv-parser に任せる
+        std::shared_ptr<const MappedFile> mapping;
+        if (HasQuotedNewlineCached(mapping)) {
+            return PlanRanges(output_cols);
+        }
+        return PlanMapped(output_cols, mapping ? std::move(mapping) : MappedFile::Open(path_));
+    }
+
+    // ファイルがクォート内改行を含むか（kAuto の判定）。前回の判定からファイルが変わっていなければ再利用する
+    // 走査した場合は mapping にマップを設定する（判定を再利用した場合は設定しない）
+    bool HasQuotedNewlineCached(std::shared_ptr<const MappedFile> &mapping) const {
+        SourceStamp current;
+        std::error_code ec;
+        const bool stat_ok = StatSource(path_, current, ec);
+        std::lock_guard<std::mutex> lock(layout_->mutex);
+        if (stat_ok && layout_->known && layout_->stamp.SameContent(current)) {
+            return layout_->quoted_newline;
+        }
+        mapping = MappedFile::Open(path_);
+        layout_->quoted_newline = HasQuotedNewline(mapping->View());
+        layout_->known = stat_ok;
+        layout_->stamp = current;
+        return layout_->quoted_newline;
+    }
+
+    // ヘッダ行だけを読んで列名表を作る
+    CsvHeader ReadHeader() const {
+        std::string header_line;
+        const CompressionFormat compression = DetectCompression(path_);
+        if (compression != CompressionFormat::kNone) {
+            const std::size_t header_end = ReadCompressedHead(compression, header_line);
+            header_line.resize(header_end);
+        } else {
+            std::ifstream ifs(path_, std::ios::binary);
+            if (!ifs) {
+                throw std::runtime_error("utility::CsvReader: cannot open file: " + path_);
+            }
+            std::getline(ifs, header_line);
+        }
+        CsvTokenizer tokenizer(header_line);
+        std::vector<std::string_view> names;
+        tokenizer.NextRow(names);
+        return CsvHeader(std::vector<std::string>(names.begin(), names.end()));
+    }
+
+    // 範囲ごとに Partial を 1 つ作り、範囲を解析した csv::CSVReader を on_range(partial, range, reader) に渡す
+    // 戻り値は範囲の順（= ファイル内の行順）に並ぶ
+    template <typename Partial, typename OnRange>
+    std::vector<Partial> ScanRanges(const RangePlan &plan, OnRange on_range) const {
+        std::vector<Partial> partials(plan.ranges.size());
+        RunWorkers(plan.ranges.size(), ThreadCount(), [&](std::size_t task) {
+            const ByteRange &range = plan.ranges[task];
+            std::istringstream stream(ReadByteRange(range));
+            csv::CSVReader csv_reader(stream, plan.format);
+            on_range(partials[task], range, csv_reader);
+        });
+        return partials;
+    }
+
+    // キャッシュの 1 行分のフィールド（文字列列は text、数値列は typed。CsvRowView で参照する）
+    struct CachedRow {
+        std::vector<std::string_view> text;
+        std::vector<CsvTypedValue> typed;
+
+        std::size_t Size() const noexcept { return text.size(); }
+
+        void Resize(std::size_t count) {
+            text.resize(count);
+            typed.resize(count);
+        }
+
+        void Load(const CsvColumnCache &cache, std::size_t col, std::size_t row) {
+            cache.ReadField(col, row, text[col], typed[col]);
+        }
+
+        CsvRowView View(const CsvHeader &header) const noexcept { return CsvRowView(text, typed.data(), header); }
+    };
+
+    // 述語（CsvRowView を受け取る任意の関数オブジェクト）で行を選ぶ
+    template <typename Predicate>
+    struct PredicateMatcher {
+        const Predicate &predicate;
+
+        bool Match(const CsvRowView &row) const { return predicate(row); }
+
+        // 述語はどの列を見るかわからないため行全体を分割する
+        bool Match(CsvTokenizer &tokenizer, std::vector<std::string_view> &fields, const CsvHeader &header) const {
+            tokenizer.ReadFields(fields, fields.max_size());
+            return predicate(CsvRowView(fields, header));
+        }
+
+        // キャッシュの行 [begin, end) を 1 行ずつ CsvRowView にして判定する
+        const std::uint8_t *Match(
+            const CsvColumnCache &cache,
+            std::size_t begin,
+            std::size_t end,
+            CachedRow &fields,
+            const CsvHeader &header,
+            std::vector<std::uint8_t> &scratch) const {
+            scratch.resize(end - begin);
+            fields.Resize(cache.ColumnCount());
+            for (std::size_t row = begin; row < end; ++row) {
+                for (std::size_t col = 0; col < cache.ColumnCount(); ++col) {
+                    fields.Load(cache, col, row);
+                }
+                scratch[row - begin] = predicate(fields.View(header));
+            }
+            return scratch.data();
+        }
+    };
+
+    // フィルタ式で行を選ぶ
+    struct FilterMatcher {
+        CompiledCsvFilter filter;
+
+        bool Match(const CsvRowView &row) const { return filter.Evaluate(row); }
+
+        // 比較に必要な列に達するまでだけフィールドを分割する
+        bool Match(CsvTokenizer &tokenizer, std::vector<std::string_view> &fields, const CsvHeader &) const {
+            return filter.EvaluateWith([&](std::size_t index, std::string_view &out) {
+                tokenizer.ReadFields(fields, index + 1);
+                if (index >= fields.size()) {
+                    return false;
+                }
+                out = fields[index];
+                return true;
+            });
+        }
+
+        // キャッシュの行 [begin, end) を列単位でまとめて評価する（比較に使う列だけを読む）
+        const std::uint8_t *Match(
+            const CsvColumnCache &cache,
+            std::size_t begin,
+            std::size_t end,
+            CachedRow &,
+            const CsvHeader &,
+            std::vector<std::uint8_t> &scratch) const {
+            return filter.EvaluateRows(cache, begin, end, scratch);
+        }
+    };
+
+    // すべての行を選ぶ（行の選択を on_match 側で行う ReadQueries 用）
+    struct AllRowsMatcher {
+        bool Match(const CsvRowView &) const { return true; }
+
+        bool Match(CsvTokenizer &, std::vector<std::string_view> &, const CsvHeader &) const { return true; }
+
+        const std::uint8_t *Match(
+            const CsvColumnCache &,
+            std::size_t begin,
+            std::size_t end,
+            CachedRow &,
+            const CsvHeader &,
+            std::vector<std::uint8_t> &scratch) const {
+            scratch.assign(end - begin, 1);
+            return scratch.data();
+        }
+    };
+
+    // ReadQueries の 1 問い合わせ分（ヘッダで解決済み）
+    struct QueryMatcher {
+        std::function<bool(const CsvRowView &)> predicate;
+        std::optional<CompiledCsvFilter> filter;
+        std::vector<int> indices;
+
+        bool Match(const CsvRowView &row) const { return filter ? filter->Evaluate(row) : predicate(row); }
+    };
+
+    // 範囲ごとに Partial を 1 つ作り、matcher が選んだ行を CsvRowView として on_match(partial, row) で処理する
+    // 戻り値は範囲の順（= ファイル内の行順）に並ぶ
+    template <typename Partial, typename Matcher, typename InitPartial, typename OnMatch>
+    std::vector<Partial> ScanMatching(
+        const RangePlan &plan,
+        const Matcher &matcher,
+        InitPartial init_partial,
+        OnMatch on_match) const {
+        if (plan.read_ahead) {
+            return ScanReadAhead<Partial>(plan, matcher, init_partial, on_match);
+        }
+        if (!plan.mapping && ThreadCount() == 1) {
+            // 単一スレッドでは範囲に分割せずファイル全体をストリーム読み込みする（クォート内改行も扱える）
+            std::vector<Partial> whole(1);
+            init_partial(whole.front(), WholeRange(plan));
+            csv::CSVReader csv_reader(path_);
+            MatchCsvRows(plan, matcher, csv_reader, [&](const CsvRowView &row) {
+                on_match(whole.front(), row);
+                return true;
+            });
+            return whole;
+        }
+        if (!plan.mapping) {
+            return ScanRanges<Partial>(plan, [&](Partial &partial, const ByteRange &range, csv::CSVReader &reader) {
+                init_partial(partial, range);
+                MatchCsvRows(plan, matcher, reader, [&](const CsvRowView &row) {
+                    on_match(partial, row);
+                    return true;
+                });
+            });
+        }
+
+        std::vector<Partial> partials(plan.ranges.size());
+        RunWorkers(plan.ranges.size(), ThreadCount(), [&](std::size_t task) {
+            const ByteRange &range = plan.ranges[task];
+            auto &partial = partials[task];
+            init_partial(partial, range);
+            auto on_row = [&](const CsvRowView &row) {
+                on_match(partial, row);
+                return true;
+            };
+            if (plan.cache) {
+                MatchCached(plan, matcher, range, on_row);
+            } else {
+                MatchMapped(plan, matcher, range, on_row);
+            }
+        });
+        return partials;
+    }
+
+    // I/O スレッドが先読みしたブロックを解析ワーカーが順に受け取り、ブロックごとに Partial を 1 つ作る
+    // 戻り値はブロックの順（= ファイル内の行順）に並ぶ
+    template <typename Partial, typename Matcher, typename InitPartial, typename OnMatch>
+    std::vector<Partial> ScanReadAhead(
+        const RangePlan &plan,
+        const Matcher &matcher,
+        InitPartial init_partial,
+        OnMatch on_match) const {
+        if (plan.ranges.empty()) {
+            return {};
+        }
+        // 解析中のブロック（ワーカーごとに 1 つ）に加えて 2 ブロック先まで読み進められるようにする
+        const unsigned int worker_count = ThreadCount();
+        ReadAheadFile file(
+            OpenDataSource(plan), plan.ranges.front().begin, options_.read_ahead_bytes, worker_count + 2
+        );
+        std::mutex mutex;
+        std::vector<std::pair<std::uint64_t, Partial>> done;
+        RunWorkers(worker_count, worker_count, [&](std::size_t) {
+            try {
+                ReadAheadFile::Block block;
+                while (file.Next(block)) {
+                    Partial partial;
+                    init_partial(partial, ByteRange{block.offset, block.offset + block.size});
+                    MatchBytes(plan, matcher, block.View(), [&](const CsvRowView &row) {
+                        on_match(partial, row);
+                        return true;
+                    });
+                    const std::uint64_t sequence = block.sequence;
+                    file.Release(std::move(block));
+                    const std::lock_guard<std::mutex> lock(mutex);
+                    done.emplace_back(sequence, std::move(partial));
+                }
+            } catch (...) {
+                file.Cancel(); // 他のワーカーと I/O スレッドを止める
+                throw;
+            }
+        });
+        std::sort(done.begin(), done.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+        std::vector<Partial> partials;
+        partials.reserve(done.size());
+        for (auto &entry : done) {
+            partials.push_back(std::move(entry.second));
+        }
+        return partials;
+    }
+
+    // matcher が選んだ行をファイル先頭から順に on_match(row) へ渡す（単一スレッド）
+    // on_match が false を返すとその時点で打ち切る
+    template <typename Matcher, typename OnMatch>
+    void ForEachMatch(const RangePlan &plan, const Matcher &matcher, OnMatch on_match) const {
+        if (plan.cache) {
+            MatchCached(plan, matcher, WholeRange(plan), on_match);
+        } else if (plan.mapping) {
+            MatchMapped(plan, matcher, WholeRange(plan), on_match);
+        } else if (plan.read_ahead) {
+            if (plan.ranges.empty()) {
+                return;
+            }
+            ReadAheadFile file(OpenDataSource(plan), plan.ranges.front().begin, options_.read_ahead_bytes);
+            ReadAheadFile::Block block;
+            while (file.Next(block)) {
+                if (!MatchBytes(plan, matcher, block.View(), on_match)) {
+                    return;
+                }
+                file.Release(std::move(block));
+            }
+        } else {
+            csv::CSVReader csv_reader(path_);
+            MatchCsvRows(plan, matcher, csv_reader, on_match);
+        }
+    }
+
+    // データ部全体の範囲
+    static ByteRange WholeRange(const RangePlan &plan) {
+        return plan.ranges.empty() ? ByteRange{0, 0} : ByteRange{plan.ranges.front().begin, plan.ranges.back().end};
+    }
+
+    // csv-parser の各行を CsvRowView に変換し、matcher が選んだ行を on_match(row) へ渡す
+    template <typename Matcher, typename OnMatch>
+    static void MatchCsvRows(
+        const RangePlan &plan,
+        const Matcher &matcher,
+        csv::CSVReader &reader,
+        OnMatch &&on_match) {
+        std::vector<std::string_view> fields;
+        for (auto &row : reader) {
+            fields.clear();
+            for (std::size_t i = 0; i < row.size(); ++i) {
+                const auto field = row[i].get<csv::string_view>();
+                fields.emplace_back(field.data(), field.size());
+            }
+            const CsvRowView view(fields, plan.header);
+            if (matcher.Match(view) && !on_match(view)) {
+                return;
+            }
+        }
+    }
+
+    // キャッシュの行範囲 range について、matcher が選んだ行を on_match(row) へ渡す
+    // kCacheBlockRows 行ずつまとめて判定し、選ばれた行の出力列のフィールドだけをキャッシュから取り出す
+    // 数値列の値は CsvTypedValue のまま渡すため、出力側の get<double>() 等は文字列を解析しない
+    template <typename Matcher, typename OnMatch>
+    static void MatchCached(const RangePlan &plan, const Matcher &matcher, const ByteRange &range, OnMatch &&on_match) {
+        const CsvColumnCache &cache = *plan.cache;
+        const std::size_t output_fields = OutputFieldCount(plan);
+        CachedRow fields;
+        std::vector<std::uint8_t> scratch;
+        for (std::size_t begin = range.begin; begin < range.end; begin += kCacheBlockRows) {
+            const std::size_t end = std::min<std::size_t>(begin + kCacheBlockRows, range.end);
+            const std::uint8_t *selected = matcher.Match(cache, begin, end, fields, plan.header, scratch);
+            for (std::size_t row = begin; row < end; ++row) {
+                if (selected[row - begin] == 0) {
+                    continue;
+                }
+                if (fields.Size() < output_fields) {
+                    fields.Resize(output_fields);
+                }
+                for (int idx : plan.indices) {
+                    fields.Load(cache, static_cast<std::size_t>(idx), row);
+                }
+                if (!on_match(fields.View(plan.header))) {
+                    return;
+                }
+            }
+        }
+    }
+
+    // 出力に必要なフィールド数（参照する最大の列インデックス + 1）
+    static std::size_t OutputFieldCount(const RangePlan &plan) {
+        std::size_t count = 0;
+        for (int idx : plan.indices) {
+            count = std::max(count, static_cast<std::size_t>(idx) + 1);
+        }
+        return count;
+    }
+
+    // マップ領域の range を内蔵トークナイザで分割し、matcher が選んだ行を on_match(row) へ渡す
+    template <typename Matcher, typename OnMatch>
+    static void MatchMapped(const RangePlan &plan, const Matcher &matcher, const ByteRange &range, OnMatch &&on_match) {
+        MatchBytes(plan, matcher, plan.mapping->View().substr(range.begin, range.end - range.begin), on_match);
+    }
+
+    // 行単位のバイト列 bytes を内蔵トークナイザで分割し、matcher が選んだ行を on_match(row) へ渡す
+    // 出力列より後ろのフィールドと選ばれなかった行の残りは分割せずに読み飛ばす
+    // on_match が false を返して打ち切った場合は false を返す
+    template <typename Matcher, typename OnMatch>
+    static bool MatchBytes(const RangePlan &plan, const Matcher &matcher, std::string_view bytes, OnMatch &&on_match) {
+        const std::size_t output_fields = OutputFieldCount(plan);
+        CsvTokenizer tokenizer(bytes);
+        std::vector<std::string_view> fields;
+        while (tokenizer.BeginRow(fields)) {
+            const bool matched = matcher.Match(tokenizer, fields, plan.header);
+            if (matched) {
+                tokenizer.ReadFields(fields, output_fields);
+            }
+            tokenizer.SkipRow();
+            if (matched && !on_match(CsvRowView(fields, plan.header))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // ──────────────────────────────────────────────────────────
+    // CsvRowView 述語版・フィルタ式版の共通実装（Matcher で行の選び方を切り替える）
+    // ──────────────────────────────────────────────────────────
+
+    template <typename Matcher>
+    std::vector<double> ReadDoublesMatching(const RangePlan &plan, const Matcher &matcher) const {
+        return Concat(ScanMatching<std::vector<double>>(
+            plan,
+            matcher,
+            [](std::vector<double> &, const ByteRange &) {},
+            [&](std::vector<double> &out, const CsvRowView &row) {
+                for (int idx : plan.indices) {
+                    out.push_back(row[static_cast<std::size_t>(idx)].get<double>());
+                }
+            }
+        ));
+    }
+
+    template <typename Matcher>
+    std::vector<std::string> ReadStringsMatching(const RangePlan &plan, const Matcher &matcher) const {
+        return Concat(ScanMatching<std::vector<std::string>>(
+            plan,
+            matcher,
+            [](std::vector<std::string> &, const ByteRange &) {},
+            [&](std::vector<std::string> &out, const CsvRowView &row) {
+                for (int idx : plan.indices) {
+                    out.push_back(row[static_cast<std::size_t>(idx)].get<std::string>());
+                }
+            }
+        ));
+    }
+
+    template <typename Matcher>
+    CsvStringViews ReadViewsMatching(const RangePlan &plan, const Matcher &matcher) const {
+        const MappedFile *mapping = plan.mapping.get();
+        auto partials = ScanMatching<CsvStringViews>(
+            plan,
+            matcher,
+            [](CsvStringViews &, const ByteRange &) {},
+            [&](CsvStringViews &out, const CsvRowView &row) {
+                for (int idx : plan.indices) {
+                    out.Append(row[static_cast<std::size_t>(idx)].get<std::string_view>(), mapping);
+                }
+            }
+        );
+
+        CsvStringViews result;
+        std::size_t total = 0;
+        for (const auto &part : partials) {
+            total += part.Size();
+        }
+        result.views_.reserve(total);
+        for (auto &part : partials) {
+            result.views_.insert(result.views_.end(), part.views_.begin(), part.views_.end());
+            result.arena_.Merge(std::move(part.arena_));
+        }
+        result.mapping_ = plan.mapping;
+        return result;
+    }
+
+    template <typename Matcher>
+    ColumnTable ReadColumnsMatching(
+        const RangePlan &plan,
+        const Matcher &matcher,
+        const std::vector<ColumnSpec> &specs) const {
+        const MappedFile *mapping = plan.mapping.get();
+        auto partials = ScanMatching<ColumnTable>(
+            plan,
+            matcher,
+            [&](ColumnTable &table, const ByteRange &range) {
+                table = ColumnTable(specs);
+                table.Reserve(EstimateRows(range.end - range.begin, plan.row_bytes));
+            },
+            [&](ColumnTable &table, const CsvRowView &row) { AppendRowView(table, row, plan.indices, mapping); }
+        );
+
+        ColumnTable result = MergeTables(specs, std::move(partials));
+        if (plan.mapping) {
+            result.Retain(plan.mapping);
+        }
+        return result;
+    }
+
+    template <typename Matcher>
+    GroupedAggregates ReadAggregatesMatching(
+        const RangePlan &plan,
+        const Matcher &matcher,
+        const std::string &group_by,
+        const std::vector<std::string> &value_cols) const {
+        // plan.indices は AggregateColumns() の順（group_by があれば先頭）
+        const std::size_t first_value = group_by.empty() ? 0 : 1;
+        auto partials = ScanMatching<GroupedAggregates>(
+            plan,
+            matcher,
+            [&](GroupedAggregates &partial, const ByteRange &) { partial = GroupedAggregates(value_cols); },
+            [&](GroupedAggregates &partial, const CsvRowView &row) {
+                const std::string_view key =
+                    group_by.empty() ? std::string_view()
+                                     : row[static_cast<std::size_t>(plan.indices[0])].get<std::string_view>();
+                const std::size_t group = partial.AddGroup(key);
+                partial.CountRow(group);
+                for (std::size_t v = 0; v < value_cols.size(); ++v) {
+                    const auto idx = static_cast<std::size_t>(plan.indices[first_value + v]);
+                    partial.Add(group, v, row[idx].get<double>());
+                }
+            }
+        );
+
+        GroupedAggregates result(value_cols);
+        for (const auto &partial : partials) {
+            result.Merge(partial);
+        }
+        return result;
+    }
+
+    template <typename Matcher>
+    Histogram ReadHistogramMatching(const RangePlan &plan, const Matcher &matcher, const Histogram &empty) const {
+        const auto idx = static_cast<std::size_t>(plan.indices[0]);
+        auto partials = ScanMatching<Histogram>(
+            plan,
+            matcher,
+            [&](Histogram &partial, const ByteRange &) { partial = empty; },
+            [&](Histogram &partial, const CsvRowView &row) { partial.Add(row[idx].get<double>()); }
+        );
+
+        Histogram result = empty;
+        for (const auto &partial : partials) {
+            result.Merge(partial);
+        }
+        return result;
+    }
+
+    static std::vector<std::string> AggregateColumns(
+        const std::string &group_by,
+        const std::vector<std::string> &value_cols) {
+        std::vector<std::string> names;
+        if (!group_by.empty()) {
+            names.push_back(group_by);
+        }
+        names.insert(names.end(), value_cols.begin(), value_cols.end());
+        return names;
+    }
+
+    // 解析スレッドがバッチを作り、呼び出し元スレッドの consumer に受け渡す
+    template <typename Matcher>
+    void ReadBatchesMatching(
+        const RangePlan &plan,
+        const Matcher &matcher,
+        const std::vector<ColumnSpec> &specs,
+        const std::function<void(ColumnTable &)> &consumer,
+        std::size_t batch_rows) const {
+        batch_rows = std::max<std::size_t>(batch_rows, 1);
+        const MappedFile *mapping = plan.mapping.get();
+        auto new_batch = [&] {
+            ColumnTable batch(specs);
+            batch.Reserve(batch_rows);
+            if (plan.mapping) {
+                batch.Retain(plan.mapping);
+            }
+            return batch;
+        };
+
+        // 容量 1: 解析スレッドは consumer より最大 1 バッチ先行する
+        BoundedBlockingQueue<ColumnTable> queue(1);
+        std::exception_ptr producer_error;
+        std::thread producer([&] {
+            try {
+                ColumnTable batch = new_batch();
+                bool open = true;
+                ForEachMatch(plan, matcher, [&](const CsvRowView &row) {
+                    AppendRowView(batch, row, plan.indices, mapping);
+                    if (batch.RowCount() < batch_rows) {
+                        return true;
+                    }
+                    open = queue.Push(std::move(batch));
+                    batch = new_batch();
+                    return open;
+                });
+                if (open && batch.RowCount() > 0) {
+                    queue.Push(std::move(batch));
+                }
+            } catch (...) {
+                producer_error = std::current_exception();
+            }
+            queue.Close();
+        });
+
+        ColumnTable batch;
+        try {
+            while (queue.Pop(batch)) {
+                consumer(batch);
+                batch = ColumnTable();
+            }
+        } catch (...) {
+            queue.Close(); // 待機中の解析スレッドを起こして終了させる
+            producer.join();
+            throw;
+        }
+        producer.join();
+        if (producer_error) {
+            std::rethrow_exception(producer_error);
+        }
+    }
+
+    template <typename T, typename Convert>
+    std::vector<T> ReadFilteredParallel(
+        const std::function<bool(const csv::CSVRow &)> &predicate,
+        const std::vector<std::string> &output_cols,
+        Convert convert) const {
+        const RangePlan plan = PlanRanges(output_cols);
+        return Concat(ScanRanges<std::vector<T>>(
+            plan,
+            [&](std::vector<T> &out, const ByteRange &, csv::CSVReader &reader) {
+                for (auto &row : reader) {
+                    if (predicate(row)) {
+                        for (int idx : plan.indices) {
+                            out.push_back(convert(row[idx]));
+                        }
+                    }
+                }
+            }
+        ));
+    }
+
+    // 範囲の順に連結して元の行順を復元する
+    template <typename T>
+    static std::vector<T> Concat(std::vector<std::vector<T>> partials) {
+        std::size_t total = 0;
+        for (const auto &part : partials) {
+            total += part.size();
+        }
+        std::vector<T> result;
+        result.reserve(total);
+        for (auto &part : partials) {
+            std::move(part.begin(), part.end(), std::back_inserter(result));
+        }
+        return result;
+    }
+
+    ColumnTable ReadColumnsParallel(
+        const std::function<bool(const csv::CSVRow &)> &predicate,
+        const std::vector<ColumnSpec> &specs) const {
+        const RangePlan plan = PlanRanges(SpecNames(specs));
+        return MergeTables(specs, ScanRanges<ColumnTable>(
+            plan,
+            [&](ColumnTable &table, const ByteRange &range, csv::CSVReader &reader) {
+                table = ColumnTable(specs);
+                table.Reserve(EstimateRows(range.end - range.begin, plan.row_bytes));
+                for (auto &row : reader) {
+                    if (predicate(row)) {
+                        AppendRow(table, row, plan.indices);
+                    }
+                }
+            }
+        ));
+    }
+
+    // 範囲ごとのテーブルを行順に連結する
+    static ColumnTable MergeTables(const std::vector<ColumnSpec> &specs, std::vector<ColumnTable> partials) {
+        ColumnTable result(specs);
+        std::size_t total = 0;
+        for (const auto &part : partials) {
+            total += part.RowCount();
+        }
+        result.Reserve(total);
+        for (auto &part : partials) {
+            result.AppendTable(std::move(part));
+        }
+        return result;
+    }
+
+    // csv-parser の get<T>() を経由せず from_chars で数値に変換する（例外は変換失敗時のみ）
+    template <typename T>
+    static T ParseField(csv::CSVField field) {
+        const auto text = field.get<csv::string_view>();
+        T value{};
+        if (!ParseNumber(std::string_view(text.data(), text.size()), value)) {
+            throw std::runtime_error("utility::CsvReader: not a number: " + std::string(text.data(), text.size()));
+        }
+        return value;
+    }
+
+    // 1 行分の出力列を ColumnSpec の型に変換して table に追加する
+    static void AppendRow(ColumnTable &table, csv::CSVRow &row, const std::vector<int> &indices) {
+        for (std::size_t col = 0; col < indices.size(); ++col) {
+            csv::CSVField field = row[indices[col]];
+            switch (table.Spec(col).type) {
+                case ColumnType::kInt64:
+                    table.AppendInt64(col, ParseField<std::int64_t>(field));
+                    break;
+                case ColumnType::kDouble:
+                    table.AppendDouble(col, ParseField<double>(field));
+                    break;
+                case ColumnType::kString:
+                    // string_view はイテレータ進行後に無効化されるためアリーナにコピー
+                    table.AppendString(col, field.get<csv::string_view>());
+                    break;
+                case ColumnType::kDictionary:
+                    table.AppendDictionary(col, field.get<csv::string_view>());
+                    break;
+            }
+        }
+        table.CommitRow();
+    }
+
+    // AppendRow の CsvRowView 版
+    // 文字列列は mapping 内を指すならそのまま参照し（所有権は呼び出し側で Retain）、それ以外はコピーする
+    static void AppendRowView(
+        ColumnTable &table,
+        const CsvRowView &row,
+        const std::vector<int> &indices,
+        const MappedFile *mapping) {
+        for (std::size_t col = 0; col < indices.size(); ++col) {
+            const CsvFieldView field = row[static_cast<std::size_t>(indices[col])];
+            switch (table.Spec(col).type) {
+                case ColumnType::kInt64:
+                    table.AppendInt64(col, field.get<std::int64_t>());
+                    break;
+                case ColumnType::kDouble:
+                    table.AppendDouble(col, field.get<double>());
+                    break;
+                case ColumnType::kString: {
+                    const auto text = field.get<std::string_view>();
+                    if (mapping != nullptr && mapping->Contains(text)) {
+                        table.AppendStringView(col, text);
+                    } else {
+                        table.AppendString(col, text);
+                    }
+                    break;
+                }
+                case ColumnType::kDictionary:
+                    table.AppendDictionary(col, field.get<std::string_view>());
+                    break;
+            }
+        }
+        table.CommitRow();
+    }
+
+    // Read の 1 行分: 列 I を tuple の I 番目の配列に型変換して追加する
+    template <typename... Ts, std::size_t... I>
+    static void AppendTyped(
+        std::tuple<std::vector<Ts>...> &out,
+        const CsvRowView &row,
+        const std::array<std::size_t, sizeof...(Ts)> &indices,
+        std::index_sequence<I...>) {
+        (std::get<I>(out).push_back(row[indices[I]].template get<Ts>()), ...);
+    }
+
+    // Read の範囲ごとの結果を列ごとに行順で連結する
+    template <typename... Ts, std::size_t... I>
+    static std::tuple<std::vector<Ts>...> ConcatColumns(
+        std::vector<std::tuple<std::vector<Ts>...>> partials,
+        std::index_sequence<I...>) {
+        std::tuple<std::vector<Ts>...> result;
+        (ConcatColumn(std::get<I>(result), partials, std::integral_constant<std::size_t, I>{}), ...);
+        return result;
+    }
+
+    template <typename T, typename Partials, std::size_t I>
+    static void ConcatColumn(std::vector<T> &out, Partials &partials, std::integral_constant<std::size_t, I>) {
+        std::size_t total = 0;
+        for (const auto &part : partials) {
+            total += std::get<I>(part).size();
+        }
+        out.reserve(total);
+        for (auto &part : partials) {
+            auto &column = std::get<I>(part);
+            std::move(column.begin(), column.end(), std::back_inserter(out));
+        }
+    }
+
+    static std::vector<std::string> SpecNames(const std::vector<ColumnSpec> &specs) {
+        std::vector<std::string> names;
+        names.reserve(specs.size());
+        for (const auto &spec : specs) {
+            names.push_back(spec.name);
+        }
+        return names;
+    }
+
+    // ──────────────────────────────────────────────────────────
+    // 行番号による部分読み込みの共通実装
+    // ──────────────────────────────────────────────────────────
+
+    // row_at(0), ..., row_at(count - 1)（狭義単調増加の行番号）の行を読み、specs の列をテーブルにする
+    // 次の行より前の記録位置が現在位置より後ろにあれば、そこへ移動してから読み飛ばす
+    template <typename RowAt>
+    ColumnTable ReadIndexedRows(const std::vector<ColumnSpec> &specs, std::uint64_t count, RowAt row_at) const {
+        const auto index = RowIndex();
+        const auto mapping = MappedFile::Open(path_);
+        const std::string_view bytes = mapping->View();
+
+        CsvTokenizer header_tokenizer(bytes);
+        std::vector<std::string_view> fields;
+        header_tokenizer.NextRow(fields);
+        const CsvHeader header(std::vector<std::string>(fields.begin(), fields.end()));
+        const std::vector<int> indices = ResolveIndices(header, SpecNames(specs));
+        std::size_t output_fields = 0;
+        for (const int idx : indices) {
+            output_fields = std::max(output_fields, static_cast<std::size_t>(idx) + 1);
+        }
+
+        ColumnTable table(specs);
+        table.Reserve(static_cast<std::size_t>(count));
+        std::optional<CsvTokenizer> tokenizer;
+        std::uint64_t next_row = 0; // tokenizer が次に読む行の行番号
+        for (std::uint64_t i = 0; i < count; ++i) {
+            const std::uint64_t row = row_at(i);
+            const CsvRowIndex::Checkpoint checkpoint = index->Locate(row);
+            if (!tokenizer || checkpoint.row > next_row) {
+                tokenizer.emplace(bytes.substr(static_cast<std::size_t>(checkpoint.offset)));
+                next_row = checkpoint.row;
+            }
+            for (; next_row < row; ++next_row) {
+                tokenizer->BeginRow(fields);
+                tokenizer->SkipRow();
+            }
+            tokenizer->BeginRow(fields);
+            tokenizer->ReadFields(fields, output_fields);
+            tokenizer->SkipRow();
+            ++next_row;
+            AppendRowView(table, CsvRowView(fields, header), indices, mapping.get());
+        }
+        table.Retain(mapping);
+        return table;
+    }
+
+    // ──────────────────────────────────────────────────────────
+    // 行数の見積もり（ColumnTable の事前確保用）
+    // ──────────────────────────────────────────────────────────
+
+    static constexpr std::size_t kSampleBytes = std::size_t{64} * 1024;
+    // キャッシュをまとめて判定する行数（フィルタ式の作業領域がキャッシュに収まる大きさ）
+    static constexpr std::size_t kCacheBlockRows = 4096;
+
+    // from 以降の先頭 kSampleBytes に含まれる改行数から 1 行あたりのバイト数を見積もる
+    static double SampleRowBytes(std::ifstream &ifs, std::uint64_t from) {
+        std::string sample(kSampleBytes, '\0');
+        ifs.clear();
+        ifs.seekg(static_cast<std::streamoff>(from));
+        ifs.read(sample.data(), static_cast<std::streamsize>(sample.size()));
+        sample.resize(static_cast<std::size_t>(ifs.gcount()));
+        return AverageRowBytes(sample);
+    }
+
+    static double AverageRowBytes(std::string_view sample) {
+        const auto lines = std::count(sample.begin(), sample.end(), '\n');
+        if (lines == 0) {
+            return static_cast<double>(sample.size());
+        }
+        return static_cast<double>(sample.size()) / static_cast<double>(lines);
+    }
+
+    static std::size_t EstimateRows(std::uint64_t bytes, double row_bytes) {
+        if (row_bytes <= 0.0) {
+            return 0;
+        }
+        // サンプルより長い行が続く場合に備え 1 割の余裕を持たせる
+        return static_cast<std::size_t>(static_cast<double>(bytes) / row_bytes * 1.1) + 1;
+    }
+
+    // ファイル全体のデータ行数を見積もる
+    std::size_t EstimateFileRows() const {
+        std::ifstream ifs(path_, std::ios::binary);
+        std::string header_line;
+        if (!ifs || !std::getline(ifs, header_line)) {
+            return 0;
+        }
+        const std::streamoff header_end = ifs.tellg();
+        if (header_end < 0) {
+            return 0;
+        }
+        const double row_bytes = SampleRowBytes(ifs, static_cast<std::uint64_t>(header_end));
+        ifs.clear();
+        ifs.seekg(0, std::ios::end);
+        const std::streamoff file_size = ifs.tellg();
+        if (file_size <= header_end) {
+            return 0;
+        }
+        return EstimateRows(static_cast<std::uint64_t>(file_size - header_end), row_bytes);
+    }
+
+    // データ部 [data_begin, file_size) を改行直後で区切ったバイト範囲に分割する
+    // next_record(pos) は pos 以降で最初に現れる改行の直後の位置を返す
+    template <typename NextRecord>
+    std::vector<ByteRange> SplitRecordAligned(
+        std::uint64_t data_begin,
+        std::uint64_t file_size,
+        NextRecord next_record) const {
+        if (file_size <= data_begin) {
+            return {};
+        }
+
+        // スレッド数以上、かつ 1 範囲が range_bytes を超えない分割数にする
+        const std::uint64_t data_size = file_size - data_begin;
+        const std::uint64_t range_bytes = std::max<std::uint64_t>(1, options_.range_bytes);
+        const std::uint64_t min_count =
+            std::max<std::uint64_t>(ThreadCount(), (data_size + range_bytes - 1) / range_bytes);
+        const std::uint64_t count = std::min(data_size, min_count);
+
+        std::vector<ByteRange> ranges;
+        ranges.reserve(count);
+        std::uint64_t begin = data_begin;
+        for (std::uint64_t k = 1; k < count && begin < file_size; ++k) {
+            const std::uint64_t target = std::max(begin, data_begin + (data_size * k / count));
+            const std::uint64_t end = next_record(target);
+            if (end > begin) {
+                ranges.push_back({begin, end});
+                begin = end;
+            }
+        }
+        if (begin < file_size) {
+            ranges.push_back({begin, file_size});
+        }
+        return ranges;
+    }
+
+    // pos 以降で最初に現れる改行の直後の位置を返す（見つからなければ file_size）
+    static std::uint64_t NextRecordStart(std::ifstream &ifs, std::uint64_t pos, std::uint64_t file_size) {
+        constexpr std::size_t kProbeSize = 4096;
+        char probe[kProbeSize];
+        ifs.clear();
+        ifs.seekg(static_cast<std::streamoff>(pos));
+        while (pos < file_size) {
+            ifs.read(probe, kProbeSize);
+            const auto got = static_cast<std::size_t>(ifs.gcount());
+            if (got == 0) {
+                break;
+            }
+            const char *newline = std::find(probe, probe + got, '\n');
+            if (newline != probe + got) {
+                return pos + static_cast<std::uint64_t>(newline - probe) + 1;
+            }
+            pos += got;
+        }
+        return file_size;
+    }
+
+    // 範囲のバイト列を読み込む（ワーカーごとに独立したストリームを開く）
+    std::string ReadByteRange(const ByteRange &range) const {
+        std::ifstream ifs(path_, std::ios::binary);
+        std::string buffer(static_cast<std::size_t>(range.end - range.begin), '\0');
+        ifs.seekg(static_cast<std::streamoff>(range.begin));
+        ifs.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.resize(static_cast<std::size_t>(ifs.gcount()));
+        return buffer;
     }
 };
 
@@ -0,0 +1,506 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "template_cli_cpp/utility/column_table.hpp"
+#include "template_cli_cpp/utility/output_file.hpp"
+#include "template_cli_cpp/utility/parallel.hpp"
+
+namespace utility {
+
+/**
+ * @brief CsvWriter::WriteColumns に渡す 1 列分の参照（データの所有者は呼び出し側）
+ *
+ * 先頭ポインタと要素数の組で、std::vector・AlignedBuffer・ColumnTable の列をコピーせずに渡せる。
+ * 参照先は WriteColumns() から戻るまで有効であればよい。
+ */
+class CsvColumnView {
+public:
+    enum class Kind : std::uint8_t {
+        kInt32,
+        kInt64,
+        kDouble,
+        kString,     ///< std::string_view の配列
+        kStdString,  ///< std::string の配列
+        kDictionary, ///< コード（uint32）と辞書の組
+    };
+
+    /// 浮動小数点の桁数の上限（固定小数点で書くときの小数部の桁数）
+    static constexpr int kMaxPrecision = 100;
+
+    CsvColumnView(const std::int32_t *data, std::size_t size) noexcept
+        : kind_(Kind::kInt32),
+          data_(data),
+          size_(size) {}
+    CsvColumnView(const std::int64_t *data, std::size_t size) noexcept
+        : kind_(Kind::kInt64),
+          data_(data),
+          size_(size) {}
+
+    /**
+     * @param precision 小数部の桁数（負なら値を復元できる最短の表記）
+     * @throws std::invalid_argument precision が kMaxPrecision を超える場合
+     */
+    CsvColumnView(const double *data, std::size_t size, int precision = -1)
+        : kind_(Kind::kDouble),
+          data_(data),
+          size_(size),
+          precision_(precision) {
+        if (precision > kMaxPrecision) {
+            throw std::invalid_argument("utility::CsvColumnView: precision too large: " + std::to_string(precision));
+        }
+    }
+    CsvColumnView(const std::string_view *data, std::size_t size) noexcept
+        : kind_(Kind::kString),
+          data_(data),
+          size_(size) {}
+    CsvColumnView(const std::string *data, std::size_t size) noexcept
+        : kind_(Kind::kStdString),
+          data_(data),
+          size_(size) {}
+    CsvColumnView(const DictionaryColumn &column) noexcept
+        : kind_(Kind::kDictionary),
+          data_(column.Codes().Data()),
+          size_(column.Size()),
+          dictionary_(&column.Values()) {}
+
+    template <typename T>
+    CsvColumnView(const std::vector<T> &values)
+        : CsvColumnView(values.data(), values.size()) {}
+    CsvColumnView(const std::vector<double> &values, int precision)
+        : CsvColumnView(values.data(), values.size(), precision) {}
+    template <typename T>
+    CsvColumnView(const AlignedBuffer<T> &values)
+        : CsvColumnView(values.Data(), values.Size()) {}
+    CsvColumnView(const AlignedBuffer<double> &values, int precision)
+        : CsvColumnView(values.Data(), values.Size(), precision) {}
+
+    Kind GetKind() const noexcept { return kind_; }
+    std::size_t Size() const noexcept { return size_; }
+    int Precision() const noexcept { return precision_; }
+
+    /**
+     * @brief row 行目を out に書き、書いた直後の位置を返す
+     *
+     * 数値は std::to_chars で変換する（double の最短表記は libstdc++ 11 以降では Ryu 系の実装）。
+     * out には MaxNumberChars() バイト以上（文字列は MaxStringChars(row) バイト以上）の空きが必要。
+     */
+    char *Format(std::size_t row, char *out, char delimiter) const noexcept {
+        switch (kind_) {
+            case Kind::kInt32:
+                return FormatInteger(static_cast<const std::int32_t *>(data_)[row], out);
+            case Kind::kInt64:
+                return FormatInteger(static_cast<const std::int64_t *>(data_)[row], out);
+            case Kind::kDouble:
+                return FormatDouble(static_cast<const double *>(data_)[row], out);
+            case Kind::kString:
+            case Kind::kStdString:
+            case Kind::kDictionary:
+                break;
+        }
+        return FormatString(StringAt(row), out, delimiter);
+    }
+
+    /// 文字列列か（行ごとに必要な領域が変わる）
+    bool IsString() const noexcept {
+        return kind_ == Kind::kString || kind_ == Kind::kStdString || kind_ == Kind::kDictionary;
+    }
+
+    /// 数値 1 つを書くのに必要な最大バイト数（符号・整数部 309 桁・小数点・小数部を含む）
+    static constexpr std::size_t MaxNumberChars() noexcept { return 1 + 309 + 1 + kMaxPrecision + 8; }
+
+    /// row 行目の文字列を書くのに必要な最大バイト数（全文字が '"' でも足りる）
+    std::size_t MaxStringChars(std::size_t row) const noexcept { return StringAt(row).size() * 2 + 2; }
+
+private:
+    Kind kind_;
+    const void *data_;
+    std::size_t size_;
+    int precision_ = -1;
+    const std::vector<std::string_view> *dictionary_ = nullptr;
+
+    std::string_view StringAt(std::size_t row) const noexcept {
+        switch (kind_) {
+            case Kind::kString:
+                return static_cast<const std::string_view *>(data_)[row];
+            case Kind::kStdString:
+                return static_cast<const std::string *>(data_)[row];
+            case Kind::kDictionary:
+                return (*dictionary_)[static_cast<const std::uint32_t *>(data_)[row]];
+            default:
+                return {};
+        }
+    }
+
+    template <typename T>
+    static char *FormatInteger(T value, char *out) noexcept {
+        return std::to_chars(out, out + MaxNumberChars(), value).ptr;
+    }
+
+    char *FormatDouble(double value, char *out) const noexcept {
+#if defined(__cpp_lib_to_chars)
+        if (precision_ < 0) {
+            return std::to_chars(out, out + MaxNumberChars(), value).ptr;
+        }
+        return std::to_chars(out, out + MaxNumberChars(), value, std::chars_format::fixed, precision_).ptr;
+#else
+        // 浮動小数点版 to_chars がない標準ライブラリ（%.17g は最短ではないが値は復元できる）
+        const int written = precision_ < 0
+                                ? std::snprintf(out, MaxNumberChars(), "%.17g", value)
+                                : std::snprintf(out, MaxNumberChars(), "%.*f", precision_, value);
+        return out + std::max(written, 0);
+#endif
+    }
+
+    // 区切り文字・'"'・改行を含む場合だけクォートし、'"' は二重にする（RFC 4180）
+    static char *FormatString(std::string_view value, char *out, char delimiter) noexcept {
+        bool quote = false;
+        for (const char c : value) {
+            if (c == delimiter || c == '"' || c == '\n' || c == '\r') {
+                quote = true;
+                break;
+            }
+        }
+        if (!quote) {
+            std::memcpy(out, value.data(), value.size());
+            return out + value.size();
+        }
+        *out++ = '"';
+        for (const char c : value) {
+            *out++ = c;
+            if (c == '"') {
+                *out++ = '"';
+            }
+        }
+        *out++ = '"';
+        return out;
+    }
+};
+
+/**
+ * @brief CsvWriter の動作設定
+ */
+struct CsvWriterOptions {
+    char delimiter = ',';
+    unsigned int threads = 1;                                ///< 整形スレッド数（0: ハードウェアスレッド数）
+    std::size_t block_rows = 64 * 1024;                      ///< 1 スレッドが一度に整形する行数
+    std::size_t buffer_bytes = std::size_t{8} * 1024 * 1024; ///< 溜まった出力がこの大きさを超えたら write する
+};
+
+/**
+ * @brief 列単位でまとめて渡したデータを CSV ファイルに書き出すライター
+ *
+ * RecorderFactory::MakeCsvFile と DataRecorder::Write による 1 行ずつの出力は、
+ * 行ごとに文字列の確保とロガー呼び出しが発生する。シミュレーション結果のような
+ * 数百万行の出力では、列の配列（CsvColumnView）をまとめて WriteColumns() に渡すと
+ * 大きなバッファへ直接整形し、buffer_bytes 単位の write でファイルに書く。
+ *
+ * threads > 1 の場合は block_rows 行ずつのブロックを複数スレッドで並列に整形し、
+ * 行の順序どおりに書き出す。出力は threads の値によらず同じバイト列になる。
+ *
+ * @code
+ * utility::CsvWriter writer("result.csv", {"step", "time", "value"});
+ * writer.WriteColumns({steps, times, utility::CsvColumnView(values, 6)});
+ * writer.Close(); // 書き込みエラーを例外で受け取る（デストラクタでも閉じる）
+ * @endcode
+ */
+class CsvWriter {
+public:
+    /**
+     * @brief ファイルを作成し（既存のファイルは切り詰める）、ヘッダ行を書く
+     * @param header 列名（空ならヘッダ行を書かず、列数も検査しない）
+     * @throws std::runtime_error ファイルを作成できない場合
+     */
+    CsvWriter(const std::string &path, const std::vector<std::string> &header, CsvWriterOptions options = {})
+        : file_(path),
+          options_(options),
+          columns_(header.size()) {
+        if (options_.threads == 0) {
+            options_.threads = std::max(1U, std::thread::hardware_concurrency());
+        }
+        options_.block_rows = std::max<std::size_t>(options_.block_rows, 1);
+        if (!header.empty()) {
+            const std::vector<std::string_view> names(header.begin(), header.end());
+            std::vector<CsvColumnView> columns;
+            for (std::size_t col = 0; col < names.size(); ++col) {
+                columns.emplace_back(names.data() + col, 1);
+            }
+            FormatRows(columns, 0, 1, buffer_);
+        }
+    }
+
+    CsvWriter(const CsvWriter &) = delete;
+    CsvWriter &operator=(const CsvWriter &) = delete;
+
+    ~CsvWriter() {
+        try {
+            Close();
+        } catch (...) {
+            // デストラクタでは報告できない（エラーを知りたい場合は Close() を呼ぶ）
+        }
+    }
+
+    /**
+     * @brief 列の配列を行として追記する（各列の i 番目の要素が i 行目）
+     * @throws std::invalid_argument 列数がヘッダと合わない・列の長さが揃っていない場合
+     * @throws std::runtime_error 書き込みに失敗した・Close() 済みの場合
+     */
+    void WriteColumns(const std::vector<CsvColumnView> &columns) {
+        if (!file_.IsOpen()) {
+            throw std::runtime_error("utility::CsvWriter: file already closed: " + file_.Path());
+        }
+        if (columns_ != 0 && columns.size() != columns_) {
+            throw std::invalid_argument(
+                "utility::CsvWriter: expected " + std::to_string(columns_) + " columns, got " +
+                std::to_string(columns.size())
+            );
+        }
+        if (columns.empty()) {
+            return;
+        }
+        const std::size_t rows = columns.front().Size();
+        for (const auto &column : columns) {
+            if (column.Size() != rows) {
+                throw std::invalid_argument("utility::CsvWriter: columns have different lengths");
+            }
+        }
+
+        if (options_.threads <= 1 || rows <= options_.block_rows) {
+            for (std::size_t first = 0; first < rows; first += options_.block_rows) {
+                FormatRows(columns, first, std::min(rows, first + options_.block_rows), buffer_);
+                if (buffer_.size >= options_.buffer_bytes) {
+                    FlushBuffer();
+                }
+            }
+            rows_written_ += rows;
+            return;
+        }
+
+        FormatParallel(columns, rows);
+        rows_written_ += rows;
+    }
+
+    /**
+     * @brief ColumnTable の全列を書き出す（列の順序はテーブルの順）
+     * @throws std::invalid_argument 列数がヘッダと合わない場合
+     * @throws std::runtime_error 書き込みに失敗した場合
+     */
+    void WriteTable(const ColumnTable &table) {
+        std::vector<CsvColumnView> columns;
+        columns.reserve(table.ColumnCount());
+        for (std::size_t col = 0; col < table.ColumnCount(); ++col) {
+            switch (table.Spec(col).type) {
+                case ColumnType::kInt64:
+                    columns.emplace_back(table.Int64Column(col));
+                    break;
+                case ColumnType::kDouble:
+                    columns.emplace_back(table.DoubleColumn(col));
+                    break;
+                case ColumnType::kString:
+                    columns.emplace_back(table.StringColumn(col));
+                    break;
+                case ColumnType::kDictionary:
+                    columns.emplace_back(table.DictionaryColumn(col));
+                    break;
+            }
+        }
+        WriteColumns(columns);
+    }
+
+    /**
+     * @brief バッファに溜まった内容をファイルに書く
+     * @throws std::runtime_error 書き込みに失敗した場合
+     */
+    void Flush() {
+        if (file_.IsOpen()) {
+            FlushBuffer();
+        }
+    }
+
+    /**
+     * @brief 残りを書き出してファイルを閉じる（2 回目以降は何もしない）
+     * @throws std::runtime_error 書き込み・クローズに失敗した場合
+     */
+    void Close() {
+        file_.Close(buffer_.data.get(), buffer_.size);
+        buffer_.size = 0;
+    }
+
+    /// これまでに書いたデータ行数（ヘッダ行を除く）
+    std::uint64_t RowsWritten() const noexcept { return rows_written_; }
+
+private:
+    // 整形用のバイト列（std::string と違い、広げるときに 0 埋めしない）
+    struct ByteBuffer {
+        std::unique_ptr<char[]> data;
+        std::size_t size = 0;
+        std::size_t capacity = 0;
+
+        // 末尾に n バイト書ける領域を確保して書き込み位置を返す
+        char *Grow(std::size_t n) {
+            if (size + n > capacity) {
+                const std::size_t grown = std::max(size + n, capacity * 2);
+                auto next = std::make_unique<char[]>(grown);
+                if (size > 0) {
+                    std::memcpy(next.get(), data.get(), size);
+                }
+                data = std::move(next);
+                capacity = grown;
+            }
+            return data.get() + size;
+        }
+    };
+
+    OutputFile file_;
+    CsvWriterOptions options_;
+    std::size_t columns_; // ヘッダの列数（0 なら検査しない）
+    ByteBuffer buffer_;               // 未書き込みの整形済みバイト列
+    std::vector<ByteBuffer> blocks_;  // 並列整形時のブロックの出力（threads の 2 倍の枠を使い回す）
+    std::uint64_t rows_written_ = 0;
+
+    // [first, last) 行を out の末尾に整形する
+    void FormatRows(const std::vector<CsvColumnView> &columns, std::size_t first, std::size_t last, ByteBuffer &out)
+        const {
+        // 数値列の最大幅は行によらないので先に求めておき、文字列列の分だけ行ごとに足す
+        std::size_t fixed_width = columns.size() + 1;
+        bool has_string = false;
+        for (const auto &column : columns) {
+            if (column.IsString()) {
+                has_string = true;
+            } else {
+                fixed_width += CsvColumnView::MaxNumberChars();
+            }
+        }
+        for (std::size_t row = first; row < last; ++row) {
+            std::size_t width = fixed_width;
+            if (has_string) {
+                for (const auto &column : columns) {
+                    if (column.IsString()) {
+                        width += column.MaxStringChars(row);
+                    }
+                }
+            }
+            char *p = out.Grow(width);
+            char *const start = p;
+            for (std::size_t col = 0; col < columns.size(); ++col) {
+                if (col > 0) {
+                    *p++ = options_.delimiter;
+                }
+                p = columns[col].Format(row, p, options_.delimiter);
+            }
+            // 1 列の行の空フィールドをそのまま書くと空行になり、読み込み時に読み飛ばされるためクォートする
+            if (p == start) {
+                *p++ = '"';
+                *p++ = '"';
+            }
+            *p++ = '\n';
+            out.size += static_cast<std::size_t>(p - start);
+        }
+    }
+
+    // threads 個のワーカーがブロックを先頭から順に取って整形し、書き出し役が行の順に書き出す
+    // ブロック b は blocks_[b % blocks_.size()] に整形する（前に同じ枠を使ったブロックの書き出しを待つ）。
+    // どれかのスレッドで例外が起きたら全員を止め、RunWorkers が呼び出し元に再送出する
+    void FormatParallel(const std::vector<CsvColumnView> &columns, std::size_t rows) {
+        constexpr std::size_t kEmpty = static_cast<std::size_t>(-1);
+        const std::size_t block_count = (rows + options_.block_rows - 1) / options_.block_rows;
+        blocks_.resize(std::size_t{2} * options_.threads);
+        std::vector<std::size_t> ready(blocks_.size(), kEmpty); // 枠ごとの整形済みブロック番号
+        std::size_t written = 0;                                // 書き出し済みのブロック数
+        bool failed = false;
+        std::atomic<std::size_t> next_block{0};
+        std::mutex mutex;
+        std::condition_variable changed;
+
+        auto write_blocks = [&] {
+            for (std::size_t b = 0; b < block_count; ++b) {
+                const std::size_t slot = b % blocks_.size();
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(lock, [&] { return failed || ready[slot] == b; });
+                    if (failed) {
+                        return;
+                    }
+                }
+                Append(blocks_[slot]);
+                const std::lock_guard<std::mutex> lock(mutex);
+                ready[slot] = kEmpty;
+                ++written;
+                changed.notify_all();
+            }
+        };
+        auto format_blocks = [&] {
+            for (std::size_t b = next_block++; b < block_count; b = next_block++) {
+                const std::size_t slot = b % blocks_.size();
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(lock, [&] { return failed || b < written + blocks_.size(); });
+                    if (failed) {
+                        return;
+                    }
+                }
+                ByteBuffer &block = blocks_[slot];
+                block.size = 0;
+                const std::size_t begin = b * options_.block_rows;
+                FormatRows(columns, begin, std::min(rows, begin + options_.block_rows), block);
+                const std::lock_guard<std::mutex> lock(mutex);
+                ready[slot] = b;
+                changed.notify_all();
+            }
+        };
+
+        // タスク 0 が書き出し役、残りが整形役（全タスクが同時に動くようタスク数と同じ数のスレッドで実行する）
+        const unsigned int tasks = options_.threads + 1;
+        RunWorkers(tasks, tasks, [&](std::size_t task) {
+            try {
+                if (task == 0) {
+                    write_blocks();
+                } else {
+                    format_blocks();
+                }
+            } catch (...) {
+                const std::lock_guard<std::mutex> lock(mutex);
+                failed = true;
+                changed.notify_all();
+                throw;
+            }
+        });
+    }
+
+    // 整形済みのブロックを書き出し待ちに加える（十分大きければバッファを経由せず直接書く）
+    void Append(const ByteBuffer &block) {
+        if (block.size >= options_.buffer_bytes) {
+            FlushBuffer();
+            file_.Write(block.data.get(), block.size);
+            return;
+        }
+        if (block.size > 0) {
+            std::memcpy(buffer_.Grow(block.size), block.data.get(), block.size);
+            buffer_.size += block.size;
+        }
+        if (buffer_.size >= options_.buffer_bytes) {
+            FlushBuffer();
+        }
+    }
+
+    void FlushBuffer() {
+        file_.Write(buffer_.data.get(), buffer_.size);
+        buffer_.size = 0;
+    }
+};
+
+} // namespace utility
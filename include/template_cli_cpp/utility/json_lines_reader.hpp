@@ -0,0 +1,266 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <yyjson.h>
+
+#include "template_cli_cpp/utility/column_table.hpp"
+#include "template_cli_cpp/utility/mapped_file.hpp"
+#include "template_cli_cpp/utility/parallel.hpp"
+#include "template_cli_cpp/utility/yyjson_wrapper.hpp"
+
+namespace utility {
+
+/**
+ * @brief JsonLinesReader の動作設定
+ */
+struct JsonLinesReaderOptions {
+    /// 並列解析のワーカースレッド数（1: 単一スレッドで先頭から読む、0: ハードウェアスレッド数）
+    unsigned int num_threads = 1;
+    /// 1 タスクが受け持つ最大バイト数（ファイルをこの大きさ以下の行境界揃えの範囲に分けて分担する）
+    std::size_t range_bytes = std::size_t{64} * 1024 * 1024;
+    /// 値が存在しない・null の場合に既定値（kInt64: 0、kDouble: NaN、文字列: 空）を入れる（false なら例外）
+    bool allow_missing = false;
+};
+
+/**
+ * @brief JSON Lines（1 行 1 JSON / NDJSON）ファイルから指定したフィールドを型付きの列として読み込むリーダー
+ *
+ * JsonLinesWriter・MakeJsonLinesFile で書いた結果ファイルの後処理用。CsvReader::ReadColumns に対応する。
+ * ファイルを mmap し、行境界で分けた範囲を num_threads 個のワーカーで並列に解析する。
+ * 各行はワーカーごとのバッファに写してから yyjson の in-situ モードで解析し、
+ * ドキュメントはワーカーごとの JsonArena に置く（行ごとの malloc は発生しない）。
+ *
+ * 読み込む値は ColumnSpec の name に JSON Pointer（RFC 6901。例: "/results/doubled"）で指定し、
+ * 結果の列名もその文字列になる。空行（空白のみの行）は読み飛ばす。
+ *
+ * 型の変換:
+ * - kInt64: 整数（64 ビット符号付きに収まるもの）と真偽値（0 / 1）
+ * - kDouble: 数値
+ * - kString・kDictionary: 文字列（テーブルにコピーする）
+ *
+ * @code
+ * utility::JsonLinesReaderOptions options;
+ * options.num_threads = 0; // ハードウェアスレッド数
+ * const utility::JsonLinesReader reader("output/results.jsonl", options);
+ * const utility::ColumnTable table = reader.ReadColumns({
+ *     {"/step", utility::ColumnType::kInt64},
+ *     {"/results/doubled", utility::ColumnType::kDouble},
+ * });
+ * const auto &doubled = table.DoubleColumn("/results/doubled");
+ * @endcode
+ */
+class JsonLinesReader {
+public:
+    /**
+     * @param path JSON Lines ファイルのパス（読み込みは ReadColumns() の呼び出し時に行う）
+     */
+    explicit JsonLinesReader(std::string path, JsonLinesReaderOptions options = {})
+        : path_(std::move(path)),
+          options_(options) {
+        options_.range_bytes = std::max<std::size_t>(options_.range_bytes, 1);
+    }
+
+    /**
+     * @brief 全行から specs の値を読み、行順に並んだテーブルにする
+     * @param specs 読み込む値（name は JSON Pointer）と格納型
+     * @throws std::invalid_argument JSON Pointer の形式が不正な場合（空文字列か '/' で始まる必要がある）
+     * @throws std::runtime_error ファイルを開けない・JSON として不正な行がある・値が存在しない
+     *         （allow_missing が false の場合）・値を格納型に変換できない場合
+     */
+    ColumnTable ReadColumns(const std::vector<ColumnSpec> &specs) const {
+        for (const auto &spec : specs) {
+            if (!spec.name.empty() && spec.name.front() != '/') {
+                throw std::invalid_argument("utility::JsonLinesReader: invalid JSON pointer: " + spec.name);
+            }
+        }
+        const auto mapping = MappedFile::Open(path_);
+        const std::string_view bytes = mapping->View();
+        const std::vector<ByteRange> ranges = SplitRanges(bytes);
+
+        std::vector<ColumnTable> partials;
+        partials.reserve(ranges.size());
+        for (std::size_t task = 0; task < ranges.size(); ++task) {
+            partials.emplace_back(specs);
+        }
+        RunWorkers(ranges.size(), ThreadCount(), [&](std::size_t task) {
+            ParseRange(bytes, ranges[task], partials[task]);
+        });
+
+        ColumnTable result(specs);
+        std::size_t total = 0;
+        for (const auto &part : partials) {
+            total += part.RowCount();
+        }
+        result.Reserve(total);
+        for (auto &part : partials) {
+            result.AppendTable(std::move(part));
+        }
+        return result;
+    }
+
+private:
+    struct ByteRange {
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    // ワーカーごとの作業領域（行のコピー先と yyjson のドキュメント置き場）
+    struct Scratch {
+        std::vector<char> line;
+        JsonArena arena;
+    };
+
+    static constexpr auto kInt64Max = static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max());
+
+    std::string path_;
+    JsonLinesReaderOptions options_;
+
+    unsigned int ThreadCount() const {
+        if (options_.num_threads == 0) {
+            return std::max(1U, std::thread::hardware_concurrency());
+        }
+        return options_.num_threads;
+    }
+
+    // bytes を行境界で揃えた範囲に分ける（スレッド数以上、かつ各範囲が range_bytes 程度になるように）
+    std::vector<ByteRange> SplitRanges(std::string_view bytes) const {
+        std::vector<ByteRange> ranges;
+        if (bytes.empty()) {
+            return ranges;
+        }
+        const std::size_t count = std::max<std::size_t>(
+            ThreadCount(), (bytes.size() + options_.range_bytes - 1) / options_.range_bytes
+        );
+        std::size_t begin = 0;
+        for (std::size_t k = 1; k < count && begin < bytes.size(); ++k) {
+            const std::size_t target = std::max(begin, bytes.size() * k / count);
+            const std::size_t newline = bytes.find('\n', target);
+            const std::size_t end = newline == std::string_view::npos ? bytes.size() : newline + 1;
+            if (end > begin) {
+                ranges.push_back({begin, end});
+                begin = end;
+            }
+        }
+        if (begin < bytes.size()) {
+            ranges.push_back({begin, bytes.size()});
+        }
+        return ranges;
+    }
+
+    // 範囲内の各行を解析して table に追加する
+    void ParseRange(std::string_view bytes, const ByteRange &range, ColumnTable &table) const {
+        Scratch scratch;
+        std::size_t pos = range.begin;
+        while (pos < range.end) {
+            const std::size_t newline = bytes.find('\n', pos);
+            const std::size_t end = std::min(newline == std::string_view::npos ? bytes.size() : newline, range.end);
+            ParseLine(bytes.substr(pos, end - pos), pos, table, scratch);
+            pos = end + 1;
+        }
+    }
+
+    void ParseLine(std::string_view line, std::size_t offset, ColumnTable &table, Scratch &scratch) const {
+        if (line.find_first_not_of(" \t\r") == std::string_view::npos) {
+            return;
+        }
+        // in-situ 解析は入力を書き換え、末尾に YYJSON_PADDING_SIZE バイトの余白を要求する
+        scratch.line.resize(line.size() + YYJSON_PADDING_SIZE);
+        std::memcpy(scratch.line.data(), line.data(), line.size());
+        std::memset(scratch.line.data() + line.size(), 0, YYJSON_PADDING_SIZE);
+
+        scratch.arena.Reset();
+        yyjson_read_err err{};
+        yyjson_doc *doc = yyjson_read_opts(
+            scratch.line.data(), line.size(), YYJSON_READ_INSITU, scratch.arena.Allocator(), &err
+        );
+        if (doc == nullptr) {
+            throw std::runtime_error(
+                "utility::JsonLinesReader: invalid JSON at byte " + std::to_string(offset + err.pos) + ": " +
+                (err.msg != nullptr ? err.msg : "unknown error")
+            );
+        }
+        // ドキュメントはアリーナ上にあるため解放しない（次の行の Reset() で破棄される）
+        yyjson_val *root = yyjson_doc_get_root(doc);
+        for (std::size_t col = 0; col < table.ColumnCount(); ++col) {
+            const ColumnSpec &spec = table.Spec(col);
+            AppendValue(table, col, yyjson_ptr_getn(root, spec.name.data(), spec.name.size()), offset);
+        }
+        table.CommitRow();
+    }
+
+    void AppendValue(ColumnTable &table, std::size_t col, yyjson_val *val, std::size_t offset) const {
+        const ColumnSpec &spec = table.Spec(col);
+        if (val == nullptr || yyjson_is_null(val)) {
+            if (!options_.allow_missing) {
+                throw ValueError("missing value", spec, offset);
+            }
+            switch (spec.type) {
+                case ColumnType::kInt64:
+                    table.AppendInt64(col, 0);
+                    break;
+                case ColumnType::kDouble:
+                    table.AppendDouble(col, std::numeric_limits<double>::quiet_NaN());
+                    break;
+                case ColumnType::kString:
+                    table.AppendStringView(col, std::string_view());
+                    break;
+                case ColumnType::kDictionary:
+                    table.AppendDictionary(col, std::string_view());
+                    break;
+            }
+            return;
+        }
+        switch (spec.type) {
+            case ColumnType::kInt64:
+                if (yyjson_is_sint(val)) {
+                    table.AppendInt64(col, yyjson_get_sint(val));
+                } else if (yyjson_is_uint(val) && yyjson_get_uint(val) <= kInt64Max) {
+                    table.AppendInt64(col, static_cast<std::int64_t>(yyjson_get_uint(val)));
+                } else if (yyjson_is_bool(val)) {
+                    table.AppendInt64(col, yyjson_get_bool(val) ? 1 : 0);
+                } else {
+                    throw ValueError("not an int64", spec, offset);
+                }
+                break;
+            case ColumnType::kDouble:
+                if (!yyjson_is_num(val)) {
+                    throw ValueError("not a number", spec, offset);
+                }
+                table.AppendDouble(col, yyjson_get_num(val));
+                break;
+            case ColumnType::kString:
+            case ColumnType::kDictionary: {
+                if (!yyjson_is_str(val)) {
+                    throw ValueError("not a string", spec, offset);
+                }
+                // 値は行のコピー（次の行で上書きされる）を指すため、テーブルにコピーする
+                const std::string_view text(yyjson_get_str(val), yyjson_get_len(val));
+                if (spec.type == ColumnType::kString) {
+                    table.AppendString(col, text);
+                } else {
+                    table.AppendDictionary(col, text);
+                }
+                break;
+            }
+        }
+    }
+
+    static std::runtime_error ValueError(const char *what, const ColumnSpec &spec, std::size_t offset) {
+        return std::runtime_error(
+            std::string("utility::JsonLinesReader: ") + what + ": " + spec.name + " (line at byte " +
+            std::to_string(offset) + ")"
+        );
+    }
+};
+
+} // namespace utility
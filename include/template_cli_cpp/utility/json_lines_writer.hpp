@@ -0,0 +1,136 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "template_cli_cpp/utility/output_file.hpp"
+#include "template_cli_cpp/utility/yyjson_wrapper.hpp"
+
+namespace utility {
+
+/**
+ * @brief JsonBuilder のドキュメントを JSON Lines（1 行 1 JSON / NDJSON）でファイルに書き出すライター
+ *
+ * MakeJsonLinesFile と DataRecorder::Write("{}", builder.Serialize()) による出力は、
+ * 1 レコードごとに Serialize() の std::string・fmt::format のコピー・spdlog のバッファへのコピーが発生する。
+ * JsonLinesWriter は各ドキュメントを内部のアリーナへ書き出し、そのまま大きな出力バッファに追記して
+ * buffer_bytes 単位の write でファイルに書く（中間の std::string を作らない）。
+ * 定常状態ではレコードごとの malloc は発生しない。
+ *
+ * 書き出しに失敗したドキュメント（NaN・Inf を含む等）は Serialize() と同じく "{}" の行になる。
+ *
+ * @code
+ * utility::JsonArena arena;
+ * utility::JsonBuilder builder(arena);
+ * utility::JsonLinesWriter writer("results.jsonl");
+ * for (int step = 0; step < steps; ++step) {
+ *     builder.Clear();
+ *     builder.Add("step", step);
+ *     writer.Write(builder);
+ * }
+ * writer.Close(); // 書き込みエラーを例外で受け取る（デストラクタでも閉じる）
+ * @endcode
+ */
+class JsonLinesWriter {
+public:
+    static constexpr std::size_t kDefaultBufferBytes = std::size_t{8} * 1024 * 1024;
+
+    /**
+     * @brief ファイルを作成する（既存のファイルは切り詰める）
+     * @param buffer_bytes 溜まった出力がこの大きさを超えたら write する
+     * @throws std::runtime_error ファイルを作成できない場合
+     */
+    explicit JsonLinesWriter(const std::string &path, std::size_t buffer_bytes = kDefaultBufferBytes)
+        : file_(path),
+          buffer_bytes_(buffer_bytes) {
+        buffer_.reserve(buffer_bytes_ + OutputFile::kLineReserve);
+    }
+
+    JsonLinesWriter(const JsonLinesWriter &) = delete;
+    JsonLinesWriter &operator=(const JsonLinesWriter &) = delete;
+
+    ~JsonLinesWriter() {
+        try {
+            Close();
+        } catch (...) {
+            // デストラクタでは報告できない（エラーを知りたい場合は Close() を呼ぶ）
+        }
+    }
+
+    /**
+     * @brief ドキュメントを 1 行として追記する
+     * @throws std::runtime_error 書き込みに失敗した・Close() 済みの場合
+     */
+    void Write(const JsonBuilder &builder) {
+        if (!file_.IsOpen()) {
+            throw std::runtime_error("utility::JsonLinesWriter: file already closed: " + file_.Path());
+        }
+        AppendLine(builder);
+        if (buffer_.size() >= buffer_bytes_) {
+            FlushBuffer();
+        }
+    }
+
+    /**
+     * @brief count 個のドキュメントを順に 1 行ずつ追記する
+     * @throws std::runtime_error 書き込みに失敗した・Close() 済みの場合
+     */
+    void WriteBatch(const JsonBuilder *builders, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            Write(builders[i]);
+        }
+    }
+
+    void WriteBatch(const std::vector<JsonBuilder> &builders) { WriteBatch(builders.data(), builders.size()); }
+
+    /**
+     * @brief バッファに溜まった内容をファイルに書く
+     * @throws std::runtime_error 書き込みに失敗した場合
+     */
+    void Flush() {
+        if (file_.IsOpen()) {
+            FlushBuffer();
+        }
+    }
+
+    /**
+     * @brief 残りを書き出してファイルを閉じる（2 回目以降は何もしない）
+     * @throws std::runtime_error 書き込み・クローズに失敗した場合
+     */
+    void Close() {
+        file_.Close(buffer_.data(), buffer_.size());
+        buffer_.clear();
+    }
+
+    /// これまでに書いた行数
+    std::uint64_t LinesWritten() const noexcept { return lines_written_; }
+
+    /// これまでに書いたバイト数（バッファに溜まっている分を含む）
+    std::uint64_t BytesWritten() const noexcept { return bytes_written_; }
+
+private:
+    OutputFile file_;
+    std::size_t buffer_bytes_;
+    std::string buffer_;  // 未書き込みの行
+    JsonArena scratch_;   // yyjson の書き出しバッファ（1 行ごとに先頭へ戻す）
+    std::uint64_t lines_written_ = 0;
+    std::uint64_t bytes_written_ = 0;
+
+    void AppendLine(const JsonBuilder &builder) {
+        const std::size_t before = buffer_.size();
+        builder.SerializeTo(buffer_, scratch_);
+        buffer_ += '\n';
+        scratch_.Reset();
+        ++lines_written_;
+        bytes_written_ += buffer_.size() - before;
+    }
+
+    void FlushBuffer() {
+        file_.Write(buffer_.data(), buffer_.size());
+        buffer_.clear();
+    }
+};
+
+} // namespace utility
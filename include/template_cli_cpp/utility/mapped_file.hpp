@@ -0,0 +1,99 @@
+#pragma once
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace utility {
+
+/**
+ * @brief 読み取り専用のメモリマップトファイル（POSIX mmap）
+ *
+ * コンストラクタでファイル全体をマップし、デストラクタでアンマップする。
+ * マップした領域を参照する string_view を結果に持たせる場合は、
+ * shared_ptr で共有して結果側に所有権を持たせる（Open() を使用）。
+ *
+ * @code
+ * auto file = utility::MappedFile::Open("data.csv");
+ * std::string_view bytes = file->View();
+ * @endcode
+ */
+class MappedFile {
+public:
+    /**
+     * @brief ファイルをマップする
+     * @param path ファイルパス
+     * @throws std::runtime_error ファイルのオープン・マップに失敗した場合
+     */
+    explicit MappedFile(const std::string &path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("utility::MappedFile: cannot open file: " + path + ": " + std::strerror(errno));
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            const int err = errno;
+            ::close(fd);
+            throw std::runtime_error("utility::MappedFile: cannot stat file: " + path + ": " + std::strerror(err));
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ > 0) {
+            void *addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                const int err = errno;
+                ::close(fd);
+                throw std::runtime_error("utility::MappedFile: cannot map file: " + path + ": " + std::strerror(err));
+            }
+            data_ = static_cast<const char *>(addr);
+            // 先頭から順に読む用途が主なので先読みを促す
+            ::madvise(addr, size_, MADV_SEQUENTIAL);
+        }
+        // マップ後はディスクリプタが不要（マップは close 後も有効）
+        ::close(fd);
+    }
+
+    // コピー・ムーブ禁止（マップ領域を指す string_view が外部に存在するため）
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&) = delete;
+    MappedFile &operator=(MappedFile &&) = delete;
+
+    ~MappedFile() {
+        if (data_ != nullptr) {
+            ::munmap(const_cast<char *>(data_), size_);
+        }
+    }
+
+    /**
+     * @brief ファイルをマップし、共有所有権付きで返す
+     * @throws std::runtime_error ファイルのオープン・マップに失敗した場合
+     */
+    static std::shared_ptr<const MappedFile> Open(const std::string &path) {
+        return std::make_shared<const MappedFile>(path);
+    }
+
+    const char *Data() const noexcept { return data_; }
+    std::size_t Size() const noexcept { return size_; }
+    std::string_view View() const noexcept { return {data_, size_}; }
+
+    /**
+     * @brief view がマップ領域内を指しているか
+     */
+    bool Contains(std::string_view view) const noexcept {
+        return data_ != nullptr && view.data() >= data_ && view.data() + view.size() <= data_ + size_;
+    }
+
+private:
+    const char *data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+} // namespace utility
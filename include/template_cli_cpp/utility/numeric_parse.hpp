@@ -0,0 +1,91 @@
+#pragma once
+#include <charconv>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace utility {
+
+namespace detail {
+
+#if defined(__cpp_lib_to_chars)
+inline constexpr bool kHasFloatingFromChars = true;
+#else
+inline constexpr bool kHasFloatingFromChars = false;
+#endif
+
+} // namespace detail
+
+/**
+ * @brief CSV フィールド文字列を数値に変換する（例外なし・ロケール非依存）
+ *
+ * std::from_chars をベースにした変換。前後の空白（スペース・タブ）と先頭の '+' を許容し、
+ * それ以外の余分な文字を含む場合や範囲外の値は失敗とする。
+ * 浮動小数点は from_chars（libstdc++ 12 以降は Eisel-Lemire 系の実装）を使い、
+ * 浮動小数点版 from_chars がない標準ライブラリでは strtod にフォールバックする
+ * （この場合のみロケールの影響を受ける）。
+ *
+ * @tparam T 整数型（bool を除く）または浮動小数点型
+ * @param text 変換元の文字列
+ * @param out  変換結果（失敗時は変更しない）
+ * @return 変換に成功した場合 true
+ *
+ * @code
+ * double value = 0.0;
+ * if (!utility::ParseNumber(field, value)) {
+ *     // 数値ではない
+ * }
+ * @endcode
+ */
+template <typename T>
+bool ParseNumber(std::string_view text, T &out) noexcept {
+    static_assert(
+        (std::is_integral_v<T> && !std::is_same_v<T, bool>) || std::is_floating_point_v<T>,
+        "ParseNumber supports integral (except bool) and floating-point types"
+    );
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+        text.remove_suffix(1);
+    }
+    if (!text.empty() && text.front() == '+') {
+        text.remove_prefix(1);
+        if (!text.empty() && text.front() == '-') {
+            return false; // "+-1" は不正
+        }
+    }
+    if (text.empty()) {
+        return false;
+    }
+
+    const char *first = text.data();
+    const char *last = text.data() + text.size();
+    T value{};
+    if constexpr (std::is_floating_point_v<T> && !detail::kHasFloatingFromChars) {
+        // strtod は NUL 終端が必要なため短いバッファにコピーする（数値として長すぎる入力は失敗）
+        char buffer[128];
+        if (text.size() >= sizeof(buffer)) {
+            return false;
+        }
+        std::memcpy(buffer, first, text.size());
+        buffer[text.size()] = '\0';
+        char *end = nullptr;
+        value = static_cast<T>(std::strtod(buffer, &end));
+        if (end != buffer + text.size()) {
+            return false;
+        }
+    } else {
+        const auto [ptr, ec] = std::from_chars(first, last, value);
+        if (ec != std::errc{} || ptr != last) {
+            return false;
+        }
+    }
+    out = value;
+    return true;
+}
+
+} // namespace utility
@@ -0,0 +1,121 @@
+#pragma once
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace utility {
+
+/**
+ * @brief 書き出し用のファイル（POSIX write を直接呼ぶ。バッファリングは呼び出し側で行う）
+ *
+ * CsvWriter・JsonLinesWriter・BinaryRecorder が整形済みの大きなバッファをまとめて書くために使う。
+ * 短い書き込み・EINTR は繰り返し、失敗は std::runtime_error で報告する。
+ *
+ * @code
+ * utility::OutputFile file("out.csv");
+ * file.Write(buffer.data(), buffer.size());
+ * file.Close(); // クローズの失敗も例外で受け取る（デストラクタでも閉じる）
+ * // 溜まっている分を書いてから閉じる場合は file.Close(pending.data(), pending.size())
+ * @endcode
+ */
+class OutputFile {
+public:
+    /// 呼び出し側の行バッファに確保しておく 1 行分の余裕（buffer_bytes を超えた時点で書き出すため、
+    /// buffer_bytes + kLineReserve を確保しておけば確保し直しをほぼ起こさない）
+    static constexpr std::size_t kLineReserve = std::size_t{64} * 1024;
+
+    /**
+     * @brief ファイルを作成する（既存のファイルは切り詰める）
+     * @throws std::runtime_error ファイルを作成できない場合
+     */
+    explicit OutputFile(const std::string &path)
+        : path_(path) {
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            throw std::runtime_error("utility::OutputFile: cannot create file: " + path + ": " + std::strerror(errno));
+        }
+    }
+
+    OutputFile(const OutputFile &) = delete;
+    OutputFile &operator=(const OutputFile &) = delete;
+
+    ~OutputFile() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    /**
+     * @brief size バイトをすべて書く
+     * @throws std::runtime_error 書き込みに失敗した・Close() 済みの場合
+     */
+    void Write(const char *data, std::size_t size) {
+        if (fd_ < 0) {
+            throw std::runtime_error("utility::OutputFile: file already closed: " + path_);
+        }
+        while (size > 0) {
+            const ssize_t written = ::write(fd_, data, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error("utility::OutputFile: write failed: " + path_ + ": " + std::strerror(errno));
+            }
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+    }
+
+    /**
+     * @brief ファイルを閉じる（2 回目以降は何もしない）
+     * @throws std::runtime_error クローズに失敗した場合
+     */
+    void Close() {
+        if (fd_ < 0) {
+            return;
+        }
+        const int fd = fd_;
+        fd_ = -1;
+        if (::close(fd) != 0) {
+            throw std::runtime_error("utility::OutputFile: close failed: " + path_ + ": " + std::strerror(errno));
+        }
+    }
+
+    /**
+     * @brief pending の size バイトを書いてからファイルを閉じる（2 回目以降は何もしない）
+     *
+     * 書き込みに失敗した場合もファイルを閉じ、クローズのエラーより書き込みのエラーを優先して報告する。
+     * @throws std::runtime_error 書き込み・クローズに失敗した場合
+     */
+    void Close(const char *pending, std::size_t size) {
+        if (fd_ < 0) {
+            return;
+        }
+        try {
+            Write(pending, size);
+        } catch (...) {
+            try {
+                Close();
+            } catch (...) {
+                // 書き込みのエラーを優先して報告する
+            }
+            throw;
+        }
+        Close();
+    }
+
+    bool IsOpen() const noexcept { return fd_ >= 0; }
+
+    const std::string &Path() const noexcept { return path_; }
+
+private:
+    std::string path_;
+    int fd_ = -1;
+};
+
+} // namespace utility
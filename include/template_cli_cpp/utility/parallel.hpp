@@ -0,0 +1,62 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace utility {
+
+/**
+ * @brief task_count 個のタスク fn(task) を最大 max_workers 個のワーカースレッドで分担して実行する
+ *
+ * ワーカーは空いた順に次のタスク番号を取る（タスクの実行順は保証しない）。
+ * ワーカーで送出された例外は残りのタスクを打ち切り、全スレッドの join 後に呼び出し元へ再送出する。
+ * ワーカーが 1 つで足りる場合はスレッドを作らず呼び出し元で順に実行する。
+ *
+ * CsvReader・JsonLinesReader の範囲ごとの並列解析と CsvWriter の並列整形に使う。
+ *
+ * @code
+ * std::vector<Partial> partials(ranges.size());
+ * utility::RunWorkers(ranges.size(), num_threads, [&](std::size_t task) {
+ *     partials[task] = Parse(ranges[task]);
+ * });
+ * @endcode
+ */
+template <typename Fn>
+void RunWorkers(std::size_t task_count, unsigned int max_workers, Fn &&fn) {
+    const auto worker_count = std::min<std::size_t>(max_workers, task_count);
+    if (worker_count <= 1) {
+        for (std::size_t task = 0; task < task_count; ++task) {
+            fn(task);
+        }
+        return;
+    }
+    std::atomic<std::size_t> next_task{0};
+    std::vector<std::exception_ptr> errors(worker_count);
+    std::vector<std::thread> workers;
+    workers.reserve(worker_count);
+    for (std::size_t w = 0; w < worker_count; ++w) {
+        workers.emplace_back([&, w] {
+            try {
+                for (std::size_t task = next_task++; task < task_count; task = next_task++) {
+                    fn(task);
+                }
+            } catch (...) {
+                errors[w] = std::current_exception();
+                next_task = task_count; // 残りのタスクを打ち切る
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    for (const auto &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+} // namespace utility
@@ -0,0 +1,356 @@
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "template_cli_cpp/utility/blocking_queue.hpp"
+
+namespace utility {
+
+/**
+ * @brief 先頭から順に読むバイト列の読み込み元（ReadAheadFile が I/O スレッドから呼ぶ）
+ */
+class ByteSource {
+public:
+    virtual ~ByteSource() = default;
+
+    /**
+     * @brief 次の最大 size バイトを out に読む
+     * @return 読めたバイト数（size 未満なら末尾に達した）
+     * @throws std::runtime_error 読み込みに失敗した場合
+     */
+    virtual std::size_t Read(char *out, std::size_t size) = 0;
+
+    /**
+     * @brief 次の size バイトを読み捨てる
+     * @return 読み捨てたバイト数（size 未満なら末尾に達した）
+     */
+    std::size_t Skip(std::size_t size) {
+        char scratch[4096];
+        std::size_t done = 0;
+        while (done < size) {
+            const std::size_t want = std::min(sizeof(scratch), size - done);
+            const std::size_t got = Read(scratch, want);
+            done += got;
+            if (got < want) {
+                break;
+            }
+        }
+        return done;
+    }
+};
+
+/**
+ * @brief ファイルの begin 以降を pread で読む ByteSource
+ */
+class FileSource : public ByteSource {
+public:
+    /**
+     * @throws std::runtime_error ファイルを開けない場合
+     */
+    explicit FileSource(const std::string &path, std::uint64_t begin = 0)
+        : pos_(begin) {
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) {
+            throw std::runtime_error("utility::FileSource: cannot open file: " + path + ": " + std::strerror(errno));
+        }
+#ifdef POSIX_FADV_SEQUENTIAL
+        ::posix_fadvise(fd_, static_cast<off_t>(begin), 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    }
+
+    FileSource(const FileSource &) = delete;
+    FileSource &operator=(const FileSource &) = delete;
+
+    ~FileSource() override { ::close(fd_); }
+
+    // 短い読み込みは繰り返す
+    std::size_t Read(char *out, std::size_t size) override {
+        std::size_t done = 0;
+        while (done < size) {
+            const ssize_t got = ::pread(fd_, out + done, size - done, static_cast<off_t>(pos_));
+            if (got < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::string("utility::FileSource: read failed: ") + std::strerror(errno));
+            }
+            if (got == 0) {
+                break;
+            }
+            done += static_cast<std::size_t>(got);
+            pos_ += static_cast<std::uint64_t>(got);
+        }
+        return done;
+    }
+
+private:
+    int fd_ = -1;
+    std::uint64_t pos_;
+};
+
+/**
+ * @brief 専用の I/O スレッドでファイルを先読みし、改行で終わるブロック単位で受け渡すリーダー
+ *
+ * I/O スレッドは空きバッファに次のブロックを読み込み（ファイルは pread、圧縮ファイルは伸長した結果。
+ * ByteSource で差し替える）、読み込み済みキューに入れる。
+ * 消費側（解析スレッド、複数可）は Next() でブロックを受け取り、処理後に Release() でバッファを返す。
+ * バッファは最初に確保した blocks 個を使い回す（リングバッファ）ため、消費側が解析している間に
+ * 次のブロックの読み込みが進み、ディスクの待ち時間が解析に隠れる。
+ *
+ * 各ブロックはクォート（"）の外にある最後の改行までで区切り、残りは次のブロックの先頭に回す
+ * （CSV のレコードがブロックをまたがない。クォート内に改行を含むフィールドも分割しない）。
+ * ブロックより長いレコードはそのレコードが収まるまでバッファを拡張する。
+ * クォートの判定は CsvTokenizer と同じ規則に従う。" がクォートを開くのはフィールドの先頭（行頭・区切り文字の直後）
+ * だけで、フィールドの途中の " はただの文字として扱う（`5" bolt` のような値でブロックの区切りがずれない）。
+ * クォート内の "" はエスケープ、単独の " はクォートを閉じる。
+ *
+ * @code
+ * utility::ReadAheadFile file("data.csv", data_begin);
+ * utility::ReadAheadFile::Block block;
+ * while (file.Next(block)) {
+ *     Parse(block.View());              // block.offset はファイル内の先頭位置
+ *     file.Release(std::move(block));   // バッファを I/O スレッドに返す
+ * }
+ * @endcode
+ */
+class ReadAheadFile {
+public:
+    static constexpr std::size_t kDefaultBlockBytes = std::size_t{8} * 1024 * 1024;
+    static constexpr std::size_t kDefaultBlocks = 3;
+
+    /**
+     * @brief 読み込んだ 1 ブロック（改行で終わる行の並び。ファイル末尾のブロックのみ改行なしで終わりうる）
+     */
+    struct Block {
+        std::unique_ptr<char[]> data;
+        std::size_t capacity = 0;
+        std::size_t size = 0;
+        std::uint64_t offset = 0;   ///< ファイル内の先頭位置
+        std::uint64_t sequence = 0; ///< 先頭から何番目のブロックか
+
+        std::string_view View() const noexcept { return {data.get(), size}; }
+    };
+
+    /**
+     * @brief ファイルを開き、begin から末尾までの先読みを開始する
+     * @param block_bytes 1 回に読むバイト数
+     * @param blocks バッファの数（読み込み中・解析中を合わせて同時に存在できるブロック数の上限）
+     * @param delimiter フィールドの区切り文字（クォートがフィールドの先頭かの判定に使う）
+     * @throws std::runtime_error ファイルを開けない場合
+     */
+    explicit ReadAheadFile(
+        const std::string &path,
+        std::uint64_t begin = 0,
+        std::size_t block_bytes = kDefaultBlockBytes,
+        std::size_t blocks = kDefaultBlocks,
+        char delimiter = ',')
+        : ReadAheadFile(std::make_unique<FileSource>(path, begin), begin, block_bytes, blocks, delimiter) {}
+
+    /**
+     * @brief source の先読みを開始する（Block::offset は begin から数える）
+     */
+    ReadAheadFile(
+        std::unique_ptr<ByteSource> source,
+        std::uint64_t begin,
+        std::size_t block_bytes = kDefaultBlockBytes,
+        std::size_t blocks = kDefaultBlocks,
+        char delimiter = ',')
+        : source_(std::move(source)),
+          block_bytes_(block_bytes == 0 ? 1 : block_bytes),
+          delimiter_(delimiter),
+          free_(blocks == 0 ? 1 : blocks),
+          filled_(blocks == 0 ? 1 : blocks) {
+        for (std::size_t i = 0; i < (blocks == 0 ? 1 : blocks); ++i) {
+            Block block;
+            block.capacity = block_bytes_;
+            block.data = std::make_unique<char[]>(block.capacity);
+            free_.Push(std::move(block));
+        }
+        io_thread_ = std::thread([this, begin] { ReadLoop(begin); });
+    }
+
+    ReadAheadFile(const ReadAheadFile &) = delete;
+    ReadAheadFile &operator=(const ReadAheadFile &) = delete;
+
+    ~ReadAheadFile() {
+        Cancel();
+        io_thread_.join();
+    }
+
+    /**
+     * @brief 次のブロックを受け取る（読み込みが終わっていなければ待つ）
+     *
+     * 複数のスレッドから同時に呼んでよい。ブロックは sequence の順に取り出される。
+     * @return 受け取れた場合 true、ファイル末尾に達した（または Cancel() された）場合 false
+     * @throws std::runtime_error 読み込みに失敗した場合
+     */
+    bool Next(Block &out) {
+        if (filled_.Pop(out)) {
+            return true;
+        }
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+        return false;
+    }
+
+    /**
+     * @brief 処理を終えたブロックのバッファを I/O スレッドに返す
+     */
+    void Release(Block &&block) { free_.Push(std::move(block)); }
+
+    /**
+     * @brief 先読みを打ち切る（以降の Next() は false を返す）
+     */
+    void Cancel() {
+        free_.Close();
+        filled_.Close();
+    }
+
+private:
+    // 読み込み済みのバイト列の末尾での解析状態（CsvTokenizer のフィールド解析に対応する）
+    enum class FieldState : std::uint8_t {
+        kFieldStart, // フィールドの先頭（行頭・区切り文字の直後）
+        kPlain,      // クォートで始まらないフィールドの途中（" はただの文字）
+        kQuoted,     // クォート内
+        kQuoteSeen,  // クォート内で " を読んだ直後（次が " ならエスケープ、それ以外ならクォートの終わり）
+    };
+
+    std::unique_ptr<ByteSource> source_;
+    std::size_t block_bytes_;
+    char delimiter_;
+    BoundedBlockingQueue<Block> free_;   // 空きバッファ
+    BoundedBlockingQueue<Block> filled_; // 読み込み済みブロック
+    std::exception_ptr error_;           // I/O スレッドで発生した例外（filled_ を閉じる前に設定する）
+    std::thread io_thread_;
+
+    void ReadLoop(std::uint64_t offset) {
+        try {
+            std::unique_ptr<char[]> carry = std::make_unique<char[]>(block_bytes_);
+            std::size_t carry_capacity = block_bytes_;
+            std::size_t carry_size = 0; // 前のブロックの最後の改行より後ろ（次のブロックの先頭になる）
+            std::uint64_t sequence = 0;
+            FieldState state = FieldState::kFieldStart; // 読み込み済みのバイト列の末尾の状態（carry の末尾の状態でもある）
+            bool eof = false;
+            Block block;
+            while (!eof && free_.Pop(block)) {
+                block.size = 0;
+                Reserve(block, carry_size);
+                std::memcpy(block.data.get(), carry.get(), carry_size);
+                block.size = carry_size;
+
+                // クォート外の改行を含むか末尾に達するまで読む（末尾に達したら残りをすべてこのブロックに含める）
+                std::size_t line_end = 0;
+                while (true) {
+                    Reserve(block, block.size + block_bytes_);
+                    const std::size_t got = source_->Read(block.data.get() + block.size, block_bytes_);
+                    const std::string_view chunk(block.data.get() + block.size, got);
+                    const std::size_t record_end = RecordEnd(chunk, state);
+                    if (record_end != std::string_view::npos) {
+                        line_end = block.size + record_end;
+                    }
+                    block.size += got;
+                    eof = got < block_bytes_;
+                    if (eof) {
+                        line_end = block.size;
+                        break;
+                    }
+                    if (line_end != 0) {
+                        break;
+                    }
+                }
+
+                carry_size = block.size - line_end;
+                if (carry_size > carry_capacity) {
+                    carry = std::make_unique<char[]>(carry_size);
+                    carry_capacity = carry_size;
+                }
+                std::memcpy(carry.get(), block.data.get() + line_end, carry_size);
+                block.size = line_end;
+                block.offset = offset;
+                block.sequence = sequence++;
+                offset += line_end;
+                if (block.size == 0 || !filled_.Push(std::move(block))) {
+                    break;
+                }
+            }
+        } catch (...) {
+            error_ = std::current_exception();
+        }
+        filled_.Close();
+    }
+
+    // data のうちクォート外にある最後の改行の次の位置を返す（なければ npos）
+    // state は data の先頭での状態を受け取り、末尾での状態に更新する
+    std::size_t RecordEnd(std::string_view data, FieldState &state) const noexcept {
+        std::size_t end = std::string_view::npos;
+        std::size_t pos = 0;
+        while (pos < data.size()) {
+            if (state == FieldState::kQuoted) {
+                const std::size_t quote = data.find('"', pos);
+                if (quote == std::string_view::npos) {
+                    break;
+                }
+                state = FieldState::kQuoteSeen;
+                pos = quote + 1;
+                continue;
+            }
+            if (state == FieldState::kQuoteSeen) {
+                if (data[pos] == '"') {
+                    state = FieldState::kQuoted;
+                    ++pos;
+                    continue;
+                }
+                // 閉じクォートの後ろは区切り文字・改行までクォート外として扱う
+                state = FieldState::kPlain;
+            }
+
+            // クォート外: 次の " までの改行はすべてレコードの区切り
+            const std::size_t quote = data.find('"', pos);
+            const std::size_t segment_end = quote == std::string_view::npos ? data.size() : quote;
+            if (segment_end > pos) {
+                const std::size_t newline = data.substr(pos, segment_end - pos).rfind('\n');
+                if (newline != std::string_view::npos) {
+                    end = pos + newline + 1;
+                }
+                const char last = data[segment_end - 1];
+                const bool at_field_start = last == delimiter_ || last == '\n' || last == '\r';
+                state = at_field_start ? FieldState::kFieldStart : FieldState::kPlain;
+            }
+            if (quote == std::string_view::npos) {
+                break;
+            }
+            if (state == FieldState::kFieldStart) {
+                state = FieldState::kQuoted;
+            }
+            pos = quote + 1;
+        }
+        return end;
+    }
+
+    // バッファを capacity バイト以上に広げる（既存の内容は保つ）
+    static void Reserve(Block &block, std::size_t capacity) {
+        if (block.capacity >= capacity) {
+            return;
+        }
+        auto grown = std::make_unique<char[]>(capacity);
+        std::memcpy(grown.get(), block.data.get(), block.size);
+        block.data = std::move(grown);
+        block.capacity = capacity;
+    }
+};
+
+} // namespace utility
@@ -0,0 +1,143 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <unistd.h>
+
+namespace utility {
+
+/**
+ * @brief 元ファイルの正規化した絶対パス（サイドカーファイルと元ファイルの対応付けに使う）
+ *
+ * シンボリックリンクと "." / ".." を解決する。存在しない部分は字句的に正規化する。
+ */
+inline std::string CanonicalSourcePath(const std::string &source_path) {
+    std::error_code ec;
+    const auto absolute = std::filesystem::absolute(source_path, ec);
+    if (ec) {
+        return source_path;
+    }
+    const auto canonical = std::filesystem::weakly_canonical(absolute, ec);
+    return ec ? absolute.lexically_normal().string() : canonical.string();
+}
+
+/**
+ * @brief source_path に対応するサイドカーファイル（キャッシュ・インデックス）のパスを返す
+ *
+ * cache_dir が空なら元ファイルの隣に `<元ファイル名><extension>` を置く。
+ * cache_dir を指定した場合は、別のディレクトリにある同名のファイルと衝突しないよう
+ * 正規化したパスのハッシュ（FNV-1a 64 ビット、16 進 16 桁）をファイル名に含める
+ * （`<元ファイル名>.<ハッシュ><extension>`）。
+ */
+inline std::string SidecarPath(const std::string &source_path, const std::string &cache_dir, const char *extension) {
+    if (cache_dir.empty()) {
+        return source_path + extension;
+    }
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (const unsigned char c : CanonicalSourcePath(source_path)) {
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+    const std::string name = std::filesystem::path(source_path).filename().string();
+    return (std::filesystem::path(cache_dir) / (name + "." + hex + extension)).string();
+}
+
+/**
+ * @brief サイドカーファイルが作られた時点の元ファイルの状態（パス・サイズ・更新時刻）
+ *
+ * サイドカーファイルに記録し、開くときに現在の元ファイルと比べて有効かを判定する。
+ */
+struct SourceStamp {
+    std::string path; ///< 正規化した絶対パス（CanonicalSourcePath()。StatSource() は設定しない）
+    std::uint64_t size = 0;
+    std::int64_t mtime = 0;
+
+    /// サイズと更新時刻が一致するか（path は比べない）
+    bool SameContent(const SourceStamp &other) const noexcept { return size == other.size && mtime == other.mtime; }
+};
+
+/**
+ * @brief source_path のサイズと更新時刻を out に設定する（path は設定しない）
+ * @return 取得できた場合 true。失敗した場合は ec に理由を設定して false
+ */
+inline bool StatSource(const std::string &source_path, SourceStamp &out, std::error_code &ec) {
+    const auto size = std::filesystem::file_size(source_path, ec);
+    if (ec) {
+        return false;
+    }
+    const auto mtime = std::filesystem::last_write_time(source_path, ec);
+    if (ec) {
+        return false;
+    }
+    out.size = static_cast<std::uint64_t>(size);
+    out.mtime = static_cast<std::int64_t>(mtime.time_since_epoch().count());
+    return true;
+}
+
+/**
+ * @brief source_path の現在の SourceStamp（正規化したパスを含む）
+ * @param owner 例外メッセージの先頭に付ける呼び出し元の名前（例: "utility::CsvColumnCache"）
+ * @throws std::runtime_error ファイルの情報を取得できない場合
+ */
+inline SourceStamp StampOf(const std::string &source_path, const char *owner) {
+    SourceStamp stamp;
+    std::error_code ec;
+    if (!StatSource(source_path, stamp, ec)) {
+        throw std::runtime_error(std::string(owner) + ": cannot stat file: " + source_path + ": " + ec.message());
+    }
+    stamp.path = CanonicalSourcePath(source_path);
+    return stamp;
+}
+
+/**
+ * @brief write(std::ofstream &) で書いた内容で path を置き換える
+ *
+ * 同じディレクトリの一時ファイルに書き出してから rename するため、読み込み中のプロセスが
+ * 中途半端なファイルを見ることはない。一時ファイル名はプロセス・呼び出しごとに一意にする
+ * （同時に保存しても互いを壊さない）。失敗した場合（write が例外を投げた場合を含む）は一時ファイルを消す。
+ *
+ * @param owner 例外メッセージの先頭に付ける呼び出し元の名前
+ * @throws std::runtime_error 書き込み・rename に失敗した場合
+ */
+template <typename WriteFn>
+void WriteFileAtomically(const std::string &path, const char *owner, WriteFn &&write) {
+    static std::atomic<unsigned int> sequence{0};
+    const std::string tmp_path =
+        path + ".tmp." + std::to_string(::getpid()) + "." + std::to_string(sequence.fetch_add(1));
+    std::error_code ec;
+    {
+        std::ofstream ofs(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!ofs) {
+            throw std::runtime_error(std::string(owner) + ": cannot create file: " + tmp_path);
+        }
+        try {
+            std::forward<WriteFn>(write)(ofs);
+            ofs.flush();
+        } catch (...) {
+            ofs.close();
+            std::filesystem::remove(tmp_path, ec);
+            throw;
+        }
+        if (!ofs) {
+            ofs.close();
+            std::filesystem::remove(tmp_path, ec);
+            throw std::runtime_error(std::string(owner) + ": cannot write file: " + tmp_path);
+        }
+    }
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec) {
+        const std::string reason = ec.message();
+        std::filesystem::remove(tmp_path, ec);
+        throw std::runtime_error(std::string(owner) + ": cannot rename to: " + path + ": " + reason);
+    }
+}
+
+} // namespace utility
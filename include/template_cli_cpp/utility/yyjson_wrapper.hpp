@@ -1,15 +1,269 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 #include <vector>
 #include <yyjson.h>
 
 namespace utility {
 
+class JsonLinesWriter;
+
+/**
+ * @brief JsonBuilder 用のアリーナ（yyjson_alc として yyjson に渡すバンプアロケータ）
+ *
+ * 確保は現在のブロックの末尾から切り出すだけで、個別の解放はしない（直前の確保の解放・拡張だけは
+ * その場で行う。書き出しバッファの伸長がこれに当たる）。Reset() は位置を先頭に戻すだけで
+ * ブロックは保持するため、同じ大きさのレコードを繰り返し作る定常状態では malloc が発生しない。
+ * ブロックが足りなくなった場合だけ新しいブロックを確保する（BlockAllocations() で数えられる）。
+ *
+ * 1 つのアリーナを同時に使える JsonBuilder は 1 つだけ。アリーナは JsonBuilder より長く生存させること。
+ *
+ * @code
+ * utility::JsonArena arena;
+ * utility::JsonBuilder builder(arena);
+ * std::string line;
+ * for (int step = 0; step < steps; ++step) {
+ *     builder.Clear();                  // アリーナを先頭に戻す（解放・再確保なし）
+ *     builder.Add("step", step);
+ *     line.clear();
+ *     builder.SerializeTo(line);        // line の容量を使い回す
+ * }
+ * @endcode
+ */
+class JsonArena {
+public:
+    static constexpr std::size_t kDefaultBlockBytes = std::size_t{64} * 1024;
+
+    /**
+     * @param block_bytes 1 ブロックの大きさ（これより大きい確保はその大きさのブロックを作る）
+     */
+    explicit JsonArena(std::size_t block_bytes = kDefaultBlockBytes)
+        : block_bytes_(std::max<std::size_t>(block_bytes, kAlign)) {
+        alc_.malloc = &JsonArena::Malloc;
+        alc_.realloc = &JsonArena::Realloc;
+        alc_.free = &JsonArena::Free;
+        alc_.ctx = this;
+    }
+
+    // yyjson_alc::ctx が自身を指すためコピー・ムーブ禁止
+    JsonArena(const JsonArena &) = delete;
+    JsonArena &operator=(const JsonArena &) = delete;
+
+    /**
+     * @brief すべての確保をまとめて破棄する（ブロックは次の確保のために保持する）
+     */
+    void Reset() noexcept {
+        current_ = 0;
+        used_ = 0;
+        last_ = nullptr;
+    }
+
+    /// yyjson に渡すアロケータ
+    const yyjson_alc *Allocator() const noexcept { return &alc_; }
+
+    /// 保持しているブロックの合計バイト数
+    std::size_t Capacity() const noexcept {
+        std::size_t total = 0;
+        for (const auto &block : blocks_) {
+            total += block.size;
+        }
+        return total;
+    }
+
+    /// これまでにブロックを確保した回数（定常状態では増えない）
+    std::size_t BlockAllocations() const noexcept { return block_allocations_; }
+
+private:
+    static constexpr std::size_t kAlign = alignof(std::max_align_t);
+
+    struct Block {
+        std::unique_ptr<unsigned char[]> data;
+        std::size_t size;
+    };
+
+    std::size_t block_bytes_;
+    std::vector<Block> blocks_;
+    std::size_t current_ = 0;            // 使用中のブロック
+    std::size_t used_ = 0;               // 使用中のブロックの切り出し済みバイト数
+    unsigned char *last_ = nullptr;      // 直前の確保の先頭（解放・拡張をその場で行える）
+    std::size_t block_allocations_ = 0;
+    yyjson_alc alc_{};
+
+    static std::size_t RoundUp(std::size_t size) noexcept { return (size + kAlign - 1) / kAlign * kAlign; }
+
+    // yyjson（C）から呼ばれるため例外は外に出さず、確保できなければ nullptr を返す
+    void *Allocate(std::size_t size) noexcept {
+        try {
+            return AllocateOrThrow(size);
+        } catch (...) {
+            return nullptr;
+        }
+    }
+
+    void *AllocateOrThrow(std::size_t size) {
+        size = RoundUp(std::max<std::size_t>(size, 1));
+        // 使用中のブロックに入らなければ、入る大きさの次のブロックへ進む（なければ作る）
+        while (current_ >= blocks_.size() || used_ + size > blocks_[current_].size) {
+            if (current_ < blocks_.size()) {
+                ++current_;
+                used_ = 0;
+            }
+            if (current_ == blocks_.size() || blocks_[current_].size < size) {
+                const std::size_t bytes = std::max(block_bytes_, size);
+                Block block{std::unique_ptr<unsigned char[]>(new unsigned char[bytes]), bytes};
+                blocks_.insert(blocks_.begin() + static_cast<std::ptrdiff_t>(current_), std::move(block));
+                ++block_allocations_;
+            }
+        }
+        last_ = blocks_[current_].data.get() + used_;
+        used_ += size;
+        return last_;
+    }
+
+    void *Reallocate(void *ptr, std::size_t old_size, std::size_t size) noexcept {
+        if (ptr == nullptr) {
+            return Allocate(size);
+        }
+        // 直前の確保でブロックに余裕があればその場で伸ばす
+        if (ptr == last_) {
+            const std::size_t begin = static_cast<std::size_t>(last_ - blocks_[current_].data.get());
+            const std::size_t rounded = RoundUp(std::max<std::size_t>(size, 1));
+            if (begin + rounded <= blocks_[current_].size) {
+                used_ = begin + rounded;
+                return ptr;
+            }
+        }
+        void *moved = Allocate(size);
+        if (moved != nullptr) {
+            std::memcpy(moved, ptr, std::min(old_size, size));
+        }
+        return moved;
+    }
+
+    void Release(void *ptr) noexcept {
+        // 直前の確保だけは巻き戻す（それ以外は Reset() までそのまま）
+        if (ptr != nullptr && ptr == last_) {
+            used_ = static_cast<std::size_t>(last_ - blocks_[current_].data.get());
+            last_ = nullptr;
+        }
+    }
+
+    static void *Malloc(void *ctx, std::size_t size) noexcept { return static_cast<JsonArena *>(ctx)->Allocate(size); }
+
+    static void *Realloc(void *ctx, void *ptr, std::size_t old_size, std::size_t size) noexcept {
+        return static_cast<JsonArena *>(ctx)->Reallocate(ptr, old_size, size);
+    }
+
+    static void Free(void *ctx, void *ptr) noexcept { static_cast<JsonArena *>(ctx)->Release(ptr); }
+};
+
+/**
+ * @brief 構造体のメンバーと JSON キーの対応（JsonBuilder::AddFields に渡すスキーマの 1 要素）
+ *
+ * config::FieldDescriptor と同じく、構造体ごとに 1 度だけタプルで記述する。
+ * キーはコピーせずドキュメントから参照するため、文字列リテラルなどドキュメントより長く生存する文字列を使う。
+ *
+ * @code
+ * struct StepRecord {
+ *     int step;
+ *     double energy;
+ *     std::vector<double> forces;
+ * };
+ * inline constexpr auto kStepRecordFields = std::make_tuple(
+ *     utility::JsonField{"step", &StepRecord::step},
+ *     utility::JsonField{"energy", &StepRecord::energy},
+ *     utility::JsonField{"forces", &StepRecord::forces}
+ * );
+ * @endcode
+ *
+ * @tparam Owner フィールドを持つ構造体型
+ * @tparam T フィールドの型
+ */
+template <typename Owner, typename T>
+struct JsonField {
+    std::string_view key; ///< JSON キー（コピーしない）
+    T Owner::*member;     ///< ポインタ・トゥ・メンバー
+};
+
+// CTAD補助 (C++17): JsonField{"key", &Owner::member} の型推論を有効にする
+template <typename Owner, typename T>
+JsonField(std::string_view, T Owner::*) -> JsonField<Owner, T>;
+
+/**
+ * @brief 連続した数値配列への読み取り専用ビュー（C++17 用の std::span<const T> 相当）
+ *
+ * JsonBuilder::Add() に渡すと、要素をコピーせずに参照し、yyjson の一括作成関数（yyjson_mut_arr_with_real 等）で
+ * 配列全体を 1 回の確保で作る。10^4〜10^6 要素の状態ベクトルなど大きな配列の出力向け。
+ * 参照先は Add() の呼び出し中だけ有効であればよい（値はドキュメントにコピーされる）。
+ *
+ * @code
+ * builder.Add("state", utility::JsonArrayView(state));                 // std::vector<double>
+ * builder.Add("ids", utility::JsonArrayView(ids.Data(), ids.Size()));  // AlignedBuffer<std::int64_t>
+ * @endcode
+ *
+ * @tparam T 要素の型（整数・浮動小数点数・bool）
+ */
+template <typename T>
+class JsonArrayView {
+    static_assert(std::is_arithmetic_v<T>, "utility::JsonArrayView: element type must be arithmetic");
+
+public:
+    JsonArrayView(const T *data, std::size_t size) noexcept
+        : data_(data),
+          size_(size) {}
+
+    /// data() と size() を持つ連続コンテナ（std::vector・std::array 等）を参照する
+    template <
+        typename Container,
+        typename Data = decltype(std::declval<const Container &>().data()),
+        typename = std::enable_if_t<std::is_convertible_v<Data, const T *>>>
+    JsonArrayView(const Container &values) noexcept // NOLINT(google-explicit-constructor)
+        : data_(values.data()),
+          size_(values.size()) {}
+
+    const T *Data() const noexcept { return data_; }
+    std::size_t Size() const noexcept { return size_; }
+
+private:
+    const T *data_;
+    std::size_t size_;
+};
+
+// CTAD補助 (C++17): JsonArrayView(vec) の要素型を推論する（ポインタ + 要素数は暗黙の推論で足りる）
+template <typename Container>
+JsonArrayView(const Container &)
+    -> JsonArrayView<std::remove_cv_t<std::remove_pointer_t<decltype(std::declval<const Container &>().data())>>>;
+
+namespace detail {
+
+template <typename T>
+struct IsJsonArrayView : std::false_type {};
+template <typename T>
+struct IsJsonArrayView<JsonArrayView<T>> : std::true_type {};
+
+template <typename T>
+struct IsStdVector : std::false_type {};
+template <typename E, typename A>
+struct IsStdVector<std::vector<E, A>> : std::true_type {};
+
+template <typename T>
+struct IsStdArray : std::false_type {};
+template <typename E, std::size_t N>
+struct IsStdArray<std::array<E, N>> : std::true_type {};
+
+} // namespace detail
+
 /**
  * @brief ネストオブジェクトへの型安全ハンドル
  *
@@ -31,6 +285,8 @@ class NestedObject {
  * - コンパイル時型推論で最適化
  * - 高性能（約150ns/op）
  * - メモリ安全（RAII、copy API使用）
+ * - JsonArena を渡すと確保をアリーナから行い、Clear() + SerializeTo() の繰り返しで malloc が発生しない
+ * - JsonField のタプルで記述した構造体を AddFields() で一括追加できる
  *
  * 使用例:
  * @code
@@ -51,12 +307,27 @@ public:
      */
     JsonBuilder() { Init(); }
 
+    /**
+     * @brief アリーナから確保するビルダーを作成する
+     *
+     * ドキュメント・値・文字列・SerializeTo() の書き出しバッファをすべて arena から確保する。
+     * Clear() はドキュメントを解放せず arena.Reset() で先頭に戻すだけになる。
+     * arena はこのビルダーより長く生存させ、同時に他のビルダーに渡さないこと。
+     *
+     * @throws std::runtime_error yyjsonドキュメント作成に失敗した場合
+     */
+    explicit JsonBuilder(JsonArena &arena)
+        : arena_(&arena) {
+        Init();
+    }
+
     // コピー禁止、ムーブ許可（RAII設計）
     JsonBuilder(const JsonBuilder &) = delete;
     JsonBuilder &operator=(const JsonBuilder &) = delete;
 
     JsonBuilder(JsonBuilder &&other) noexcept
-        : doc_(other.doc_),
+        : arena_(other.arena_),
+          doc_(other.doc_),
           root_(other.root_) {
         other.doc_ = nullptr;
         other.root_ = nullptr;
@@ -64,9 +335,8 @@ public:
 
     JsonBuilder &operator=(JsonBuilder &&other) noexcept {
         if (this != &other) {
-            if (doc_ != nullptr) {
-                yyjson_mut_doc_free(doc_);
-            }
+            FreeDoc();
+            arena_ = other.arena_;
             doc_ = other.doc_;
             root_ = other.root_;
             other.doc_ = nullptr;
@@ -78,20 +348,16 @@ public:
     /**
      * @brief デストラクタ - リソースを自動解放
      */
-    ~JsonBuilder() {
-        if (doc_ != nullptr) {
-            yyjson_mut_doc_free(doc_);
-        }
-    }
+    ~JsonBuilder() { FreeDoc(); }
 
     /**
      * @brief 統一Add関数 - あらゆる型をサポート
      *
      * サポート型:
-     * - int, double, float: 数値
+     * - int, std::int64_t, std::uint64_t 等の整数, double, float: 数値
      * - bool: 真偽値
-     * - std::string, const char*: 文字列
-     * - std::vector<int>: 数値配列
+     * - std::string, std::string_view, const char*: 文字列（コピーする）
+     * - 数値・bool の std::vector / std::array / JsonArrayView: 数値配列（yyjson の一括作成関数でまとめて追加する）
      * - std::vector<std::string>: 文字列配列
      *
      * @tparam T 値の型（自動推論）
@@ -140,6 +406,30 @@ public:
         AddVal(nested.val_, key, value);
     }
 
+    /**
+     * @brief JsonField のタプルで記述した構造体のメンバーをまとめて追加する
+     *
+     * キーはスキーマの文字列を長さ付きで参照する（コピー・strlen なし）。値の型は Add() と同じ。
+     * 呼び出しはコンパイル時にフィールドごとに展開される。
+     *
+     * @code
+     * builder.AddFields(record, kStepRecordFields);
+     * builder.AddFields(builder.AddNested("inputs"), record.inputs, kInputsFields);
+     * @endcode
+     */
+    template <typename Owner, typename... Ts>
+    void AddFields(const Owner &record, const std::tuple<JsonField<Owner, Ts>...> &fields) {
+        AddFieldsTo(root_, record, fields);
+    }
+
+    /**
+     * @brief AddFields() のネストオブジェクト版
+     */
+    template <typename Owner, typename... Ts>
+    void AddFields(NestedObject nested, const Owner &record, const std::tuple<JsonField<Owner, Ts>...> &fields) {
+        AddFieldsTo(nested.val_, record, fields);
+    }
+
     /**
      * @brief JSONデータの文字列表現を取得
      * @param pretty フォーマットするか（デフォルト: false）
@@ -160,6 +450,41 @@ public:
         return {json_str.get(), len};
     }
 
+    /**
+     * @brief JSON文字列を out の末尾に追記する（out の容量を使い回せる）
+     *
+     * アリーナを使うビルダーでは書き出し用の一時バッファもアリーナから確保するため、
+     * out の容量が足りていれば malloc は発生しない。
+     *
+     * @param out 追記先（既存の内容は残す）
+     * @param pretty フォーマットするか（デフォルト: false）
+     * @return 追記したバイト数
+     *
+     * @code
+     * std::string line;
+     * line.clear();
+     * builder.SerializeTo(line);
+     * @endcode
+     */
+    std::size_t SerializeTo(std::string &out, bool pretty = false) const {
+        return SerializeWith(out, arena_ != nullptr ? arena_->Allocator() : nullptr, pretty);
+    }
+
+    /**
+     * @brief JSON文字列を out の末尾に追記する（書き出し用の一時バッファを scratch から確保する）
+     *
+     * ビルダー自身がアリーナを使うかどうかによらず、一時バッファだけを呼び出し側のアリーナに置く。
+     * 一時バッファは戻る前に scratch へ返す（直前の確保なのでその場で巻き戻る）。
+     *
+     * @param out 追記先（既存の内容は残す）
+     * @param scratch 一時バッファの確保先
+     * @param pretty フォーマットするか（デフォルト: false）
+     * @return 追記したバイト数
+     */
+    std::size_t SerializeTo(std::string &out, JsonArena &scratch, bool pretty = false) const {
+        return SerializeWith(out, scratch.Allocator(), pretty);
+    }
+
     /**
      * @brief 現在のJSONサイズ（フィールド数）を取得
      * @return フィールド数
@@ -174,26 +499,58 @@ public:
 
     /**
      * @brief JSONをクリア（全フィールドを削除）
+     *
+     * アリーナを使うビルダーではドキュメントを解放せず、アリーナを先頭に戻してから作り直す。
      */
     void Clear() {
-        if (doc_ != nullptr) {
-            yyjson_mut_doc_free(doc_);
+        if (arena_ != nullptr) {
+            doc_ = nullptr;
+            arena_->Reset();
+        } else {
+            FreeDoc();
         }
         Init();
     }
 
 private:
+    JsonArena *arena_ = nullptr; // nullptr なら yyjson の既定アロケータ（malloc）
     yyjson_mut_doc *doc_{};
     yyjson_mut_val *root_{};
 
+    // アリーナ上のドキュメントは個別に解放しない（アリーナの Reset()・破棄でまとめて解放される）
+    void FreeDoc() noexcept {
+        if (doc_ != nullptr && arena_ == nullptr) {
+            yyjson_mut_doc_free(doc_);
+        }
+        doc_ = nullptr;
+    }
+
+    // alc（nullptr なら malloc）から確保したバッファに書き出して out に追記する
+    std::size_t SerializeWith(std::string &out, const yyjson_alc *alc, bool pretty) const {
+        std::size_t len = 0;
+        const std::uint32_t flags = pretty ? YYJSON_WRITE_PRETTY : YYJSON_WRITE_NOFLAG;
+        char *json = yyjson_mut_write_opts(doc_, flags, alc, &len, nullptr);
+        if (json == nullptr) {
+            out += "{}";
+            return 2;
+        }
+        out.append(json, len);
+        if (alc != nullptr) {
+            alc->free(alc->ctx, json);
+        } else {
+            std::free(json);
+        }
+        return len;
+    }
+
     void Init() {
-        doc_ = yyjson_mut_doc_new(nullptr);
+        doc_ = yyjson_mut_doc_new(arena_ != nullptr ? arena_->Allocator() : nullptr);
         if (doc_ == nullptr) {
             throw std::runtime_error("Failed to create yyjson document");
         }
         root_ = yyjson_mut_obj(doc_);
         if (root_ == nullptr) {
-            yyjson_mut_doc_free(doc_);
+            FreeDoc();
             throw std::runtime_error("Failed to create root object");
         }
         yyjson_mut_doc_set_root(doc_, root_);
@@ -205,37 +562,103 @@ private:
 
     template <typename T>
     void AddVal(yyjson_mut_val *obj, const char *key, const T &value) {
+        yyjson_mut_obj_add_val(doc_, obj, key, MakeVal(value));
+    }
+
+    template <typename Owner, typename... Ts>
+    void AddFieldsTo(yyjson_mut_val *obj, const Owner &record, const std::tuple<JsonField<Owner, Ts>...> &fields) {
+        std::apply(
+            [&](const auto &...field) {
+                (yyjson_mut_obj_add(
+                     obj, yyjson_mut_strn(doc_, field.key.data(), field.key.size()), MakeVal(record.*field.member)
+                 ),
+                 ...);
+            },
+            fields
+        );
+    }
+
+    // 値 1 つ分の yyjson_mut_val を作る（確保に失敗した場合は nullptr。追加側で無視される）
+    template <typename T>
+    yyjson_mut_val *MakeVal(const T &value) {
         using D = std::decay_t<T>;
-        if constexpr (std::is_same_v<D, int>) {
-            yyjson_mut_obj_add_int(doc_, obj, key, value);
-        } else if constexpr (std::is_same_v<D, double> || std::is_same_v<D, float>) {
-            yyjson_mut_obj_add_real(doc_, obj, key, static_cast<double>(value));
-        } else if constexpr (std::is_same_v<D, bool>) {
-            yyjson_mut_obj_add_bool(doc_, obj, key, value);
-        } else if constexpr (std::is_same_v<D, std::string>) {
-            yyjson_mut_obj_add_strcpy(doc_, obj, key, value.c_str());
+        if constexpr (std::is_same_v<D, bool>) {
+            return yyjson_mut_bool(doc_, value);
+        } else if constexpr (std::is_integral_v<D> && std::is_signed_v<D>) {
+            return yyjson_mut_sint(doc_, static_cast<std::int64_t>(value));
+        } else if constexpr (std::is_integral_v<D>) {
+            return yyjson_mut_uint(doc_, static_cast<std::uint64_t>(value));
+        } else if constexpr (std::is_floating_point_v<D>) {
+            return yyjson_mut_real(doc_, static_cast<double>(value));
+        } else if constexpr (std::is_same_v<D, std::string> || std::is_same_v<D, std::string_view>) {
+            return yyjson_mut_strncpy(doc_, value.data(), value.size());
         } else if constexpr (std::is_same_v<D, const char *> || std::is_same_v<D, char *>) {
-            yyjson_mut_obj_add_strcpy(doc_, obj, key, value);
-        } else if constexpr (std::is_same_v<D, std::vector<int>>) {
-            AddArray<int>(obj, key, value);
-        } else if constexpr (std::is_same_v<D, std::vector<std::string>>) {
-            AddArray<std::string>(obj, key, value);
+            return yyjson_mut_strcpy(doc_, value);
+        } else if constexpr (detail::IsStdVector<D>::value || detail::IsStdArray<D>::value) {
+            return MakeArray(value);
+        } else if constexpr (detail::IsJsonArrayView<D>::value) {
+            return MakeNumberArray(value.Data(), value.Size());
         } else {
-            static_assert(std::is_same_v<T, void>, "Unsupported type for Add/AddToNested");
+            static_assert(std::is_same_v<T, void>, "Unsupported type for Add/AddToNested/AddFields");
         }
     }
 
+    template <typename Container>
+    yyjson_mut_val *MakeArray(const Container &values) {
+        using Elem = typename Container::value_type;
+        if constexpr (std::is_same_v<Container, std::vector<bool>>) {
+            // std::vector<bool> は連続した bool 配列ではないため 1 要素ずつ追加する
+            yyjson_mut_val *arr = yyjson_mut_arr(doc_);
+            for (const bool item : values) {
+                yyjson_mut_arr_add_bool(doc_, arr, item);
+            }
+            return arr;
+        } else if constexpr (std::is_arithmetic_v<Elem>) {
+            return MakeNumberArray(values.data(), values.size());
+        } else if constexpr (std::is_same_v<Elem, std::string>) {
+            yyjson_mut_val *arr = yyjson_mut_arr(doc_);
+            for (const auto &item : values) {
+                yyjson_mut_arr_add_strncpy(doc_, arr, item.data(), item.size());
+            }
+            return arr;
+        } else {
+            static_assert(std::is_same_v<Elem, void>, "Unsupported array element type for Add/AddToNested/AddFields");
+        }
+    }
+
+    // 連続した数値配列。yyjson に同じ型の一括作成関数があれば、全要素を 1 回の確保で作る
     template <typename Elem>
-    void AddArray(yyjson_mut_val *obj, const char *key, const std::vector<Elem> &arr) {
-        yyjson_mut_val *json_arr = yyjson_mut_arr(doc_);
-        for (const auto &item : arr) {
-            if constexpr (std::is_same_v<Elem, int>) {
-                yyjson_mut_arr_add_int(doc_, json_arr, item);
-            } else {
-                yyjson_mut_arr_add_strcpy(doc_, json_arr, item.c_str());
+    yyjson_mut_val *MakeNumberArray(const Elem *values, std::size_t count) {
+        if constexpr (std::is_same_v<Elem, double>) {
+            return yyjson_mut_arr_with_real(doc_, values, count);
+        } else if constexpr (std::is_same_v<Elem, float>) {
+            return yyjson_mut_arr_with_float(doc_, values, count);
+        } else if constexpr (std::is_same_v<Elem, bool>) {
+            return yyjson_mut_arr_with_bool(doc_, values, count);
+        } else if constexpr (std::is_same_v<Elem, std::int64_t>) {
+            return yyjson_mut_arr_with_sint64(doc_, values, count);
+        } else if constexpr (std::is_same_v<Elem, std::int32_t>) {
+            return yyjson_mut_arr_with_sint32(doc_, values, count);
+        } else if constexpr (std::is_same_v<Elem, std::int16_t>) {
+            return yyjson_mut_arr_with_sint16(doc_, values, count);
+        } else if constexpr (std::is_same_v<Elem, std::int8_t>) {
+            return yyjson_mut_arr_with_sint8(doc_, values, count);
+        } else if constexpr (std::is_same_v<Elem, std::uint64_t>) {
+            return yyjson_mut_arr_with_uint64(doc_, values, count);
+        } else if constexpr (std::is_same_v<Elem, std::uint32_t>) {
+            return yyjson_mut_arr_with_uint32(doc_, values, count);
+        } else if constexpr (std::is_same_v<Elem, std::uint16_t>) {
+            return yyjson_mut_arr_with_uint16(doc_, values, count);
+        } else if constexpr (std::is_same_v<Elem, std::uint8_t>) {
+            return yyjson_mut_arr_with_uint8(doc_, values, count);
+        } else {
+            // long double・char・long long（int64_t と別の型の場合）等は 1 要素ずつ変換して追加する
+            yyjson_mut_val *arr = yyjson_mut_arr(doc_);
+            for (std::size_t i = 0; i < count; ++i) {
+                yyjson_mut_arr_append(arr, MakeVal(values[i]));
             }
+            return arr;
         }
-        yyjson_mut_obj_add_val(doc_, obj, key, json_arr);
     }
 };
 
@@ -3,6 +3,7 @@
 #include <filesystem>
 #include <fstream>
 #include <string>
+#include <system_error>
 
 /**
  * @brief テスト用の一時ファイルを作成するヘルパー
@@ -27,3 +28,30 @@ struct TempFile {
 
     std::string Str() const { return path.string(); }
 };
+
+/**
+ * @brief テスト用の一時ディレクトリを作成するヘルパー
+ *
+ * コンストラクタでディレクトリを生成し、デストラクタで中身ごと自動削除する。
+ *
+ * @code
+ * const TempDir dir("test_cache_dir");
+ * options.cache_dir = dir.Str();
+ * @endcode
+ */
+struct TempDir {
+    std::filesystem::path path;
+
+    explicit TempDir(const std::string &name)
+        : path(std::filesystem::temp_directory_path() / name) {
+        std::filesystem::remove_all(path);
+        std::filesystem::create_directories(path);
+    }
+
+    ~TempDir() {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+    }
+
+    std::string Str() const { return path.string(); }
+};
@@ -0,0 +1,1604 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "support/temp_file.hpp"
+#include "template_cli_cpp/utility/csv_wrapper.hpp"
+#include "template_cli_cpp/utility/csv_writer.hpp"
+
+#if TEMPLATE_CLI_CPP_HAS_ZLIB
+#include <zlib.h>
+#endif
+#if TEMPLATE_CLI_CPP_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+// id, category, value, flag の 4 列 CSV を生成する（flag は 3 行に 1 行が 1）
+static std::string MakeCsv(int num_rows) {
+    static const char *const kCategories[] = {"A", "B", "C"};
+    std::string content = "id,category,value,flag\n";
+    for (int i = 0; i < num_rows; ++i) {
+        content += std::to_string(i) + ',' + kCategories[i % 3] + ',' + std::to_string(i * 0.5) + ',' +
+                   (i % 3 == 0 ? "1" : "0") + '\n';
+    }
+    return content;
+}
+
+static bool FlagIsOne(const csv::CSVRow &row) { return row["flag"].get<int>() == 1; }
+
+// 範囲を細かく分割して並列スキャンを強制するオプション
+static utility::CsvReaderOptions ParallelOptions(unsigned int num_threads) {
+    utility::CsvReaderOptions options;
+    options.num_threads = num_threads;
+    options.range_bytes = 64;
+    return options;
+}
+
+// ──────────────────────────────────────────────────────────────
+// 単一スレッド
+// ──────────────────────────────────────────────────────────────
+
+TEST_CASE("CsvReader: ReadFiltered") {
+    const TempFile tmp("test_csv_wrapper_basic.csv", MakeCsv(10));
+    const utility::CsvReader reader(tmp.Str());
+
+    SUBCASE("double output is row-major over output_cols") {
+        const auto values = reader.ReadFiltered(FlagIsOne, {"id", "value"});
+        REQUIRE(values.size() == 8);
+        CHECK(values[0] == doctest::Approx(0.0));
+        CHECK(values[1] == doctest::Approx(0.0));
+        CHECK(values[2] == doctest::Approx(3.0));
+        CHECK(values[3] == doctest::Approx(1.5));
+        CHECK(values[6] == doctest::Approx(9.0));
+        CHECK(values[7] == doctest::Approx(4.5));
+    }
+
+    SUBCASE("string output") {
+        const auto labels = reader.ReadFilteredAsStrings(FlagIsOne, {"category"});
+        CHECK(labels == std::vector<std::string>{"A", "A", "A", "A"});
+    }
+
+    SUBCASE("unknown column throws") {
+        CHECK_THROWS_AS(reader.ReadFiltered(FlagIsOne, {"missing"}), std::invalid_argument);
+    }
+}
+
+// ──────────────────────────────────────────────────────────────
+// 並列スキャン
+// ──────────────────────────────────────────────────────────────
+
+TEST_CASE("CsvReader: parallel scan matches single-thread order") {
+    const TempFile tmp("test_csv_wrapper_parallel.csv", MakeCsv(500));
+    const utility::CsvReader sequential(tmp.Str());
+    const auto expected = sequential.ReadFiltered(FlagIsOne, {"id", "value"});
+    const auto expected_labels = sequential.ReadFilteredAsStrings(FlagIsOne, {"id", "category"});
+
+    for (const unsigned int num_threads : {2U, 3U, 8U, 0U}) {
+        const utility::CsvReader parallel(tmp.Str(), ParallelOptions(num_threads));
+        CHECK(parallel.ReadFiltered(FlagIsOne, {"id", "value"}) == expected);
+        CHECK(parallel.ReadFilteredAsStrings(FlagIsOne, {"id", "category"}) == expected_labels);
+    }
+}
+
+TEST_CASE("CsvReader: parallel scan edge cases") {
+    SUBCASE("header only") {
+        const TempFile tmp("test_csv_wrapper_header_only.csv", "id,category,value,flag\n");
+        const utility::CsvReader reader(tmp.Str(), ParallelOptions(4));
+        CHECK(reader.ReadFiltered(FlagIsOne, {"value"}).empty());
+    }
+
+    SUBCASE("last row without trailing newline") {
+        const TempFile tmp("test_csv_wrapper_no_eol.csv", "id,category,value,flag\n0,A,1.5,1\n1,B,2.5,1");
+        const utility::CsvReader reader(tmp.Str(), ParallelOptions(4));
+        CHECK(reader.ReadFiltered(FlagIsOne, {"value"}) == std::vector<double>{1.5, 2.5});
+    }
+
+    SUBCASE("unknown column throws") {
+        const TempFile tmp("test_csv_wrapper_parallel_missing.csv", MakeCsv(10));
+        const utility::CsvReader reader(tmp.Str(), ParallelOptions(4));
+        CHECK_THROWS_AS(reader.ReadFiltered(FlagIsOne, {"missing"}), std::invalid_argument);
+    }
+
+    SUBCASE("exception from predicate propagates") {
+        const TempFile tmp("test_csv_wrapper_parallel_throw.csv", MakeCsv(100));
+        const utility::CsvReader reader(tmp.Str(), ParallelOptions(4));
+        auto throwing = [](const csv::CSVRow &) -> bool { throw std::runtime_error("predicate failure"); };
+        CHECK_THROWS_AS(reader.ReadFiltered(throwing, {"value"}), std::runtime_error);
+    }
+}
+
+// ──────────────────────────────────────────────────────────────
+// 列指向出力
+// ──────────────────────────────────────────────────────────────
+
+TEST_CASE("ColumnTable: build and access") {
+    utility::ColumnTable table({{"id", utility::ColumnType::kInt64}, {"label", utility::ColumnType::kString}});
+    for (int i = 0; i < 100; ++i) {
+        table.AppendInt64(0, i);
+        table.AppendString(1, std::to_string(i));
+        table.CommitRow();
+    }
+    CHECK(table.RowCount() == 100);
+    CHECK(table.ColumnCount() == 2);
+    CHECK(table.Int64Column("id")[99] == 99);
+    CHECK(table.StringColumn(1)[42] == "42");
+    CHECK(reinterpret_cast<std::uintptr_t>(table.Int64Column(0).Data()) % 64 == 0);
+    CHECK_THROWS_AS(table.DoubleColumn("id"), std::invalid_argument);
+    CHECK_THROWS_AS(table.IndexOf("missing"), std::invalid_argument);
+}
+
+TEST_CASE("ColumnTable: dictionary column") {
+    const std::vector<utility::ColumnSpec> specs = {{"label", utility::ColumnType::kDictionary}};
+    utility::ColumnTable first(specs);
+    for (const char *label : {"x", "y", "x", "x"}) {
+        first.AppendDictionary(0, label);
+        first.CommitRow();
+    }
+    const auto &dictionary = first.DictionaryColumn("label");
+    CHECK(dictionary.Values().size() == 2);
+    CHECK(dictionary.Codes()[2] == 0);
+    CHECK(dictionary[1] == "y");
+    CHECK(dictionary.CodeOf("y") == 1);
+    CHECK(dictionary.CodeOf("z") == -1);
+    CHECK_THROWS_AS(first.StringColumn(0), std::invalid_argument);
+
+    // 結合時は後ろのテーブルのコードを前のテーブルの辞書に付け替える
+    utility::ColumnTable second(specs);
+    for (const char *label : {"z", "y", "z"}) {
+        second.AppendDictionary(0, std::string(label));
+        second.CommitRow();
+    }
+    first.AppendTable(std::move(second));
+    const auto &merged = first.DictionaryColumn(0);
+    REQUIRE(merged.Size() == 7);
+    CHECK(merged.Values().size() == 3);
+    CHECK(merged[4] == "z");
+    CHECK(merged[5] == "y");
+    CHECK(merged.Codes()[5] == 1);
+    CHECK(merged.Codes()[6] == 2);
+}
+
+TEST_CASE("CsvReader: ReadColumns") {
+    const TempFile tmp("test_csv_wrapper_columns.csv", MakeCsv(300));
+    const std::vector<utility::ColumnSpec> specs = {
+        {      "id",  utility::ColumnType::kInt64},
+        {   "value", utility::ColumnType::kDouble},
+        {"category", utility::ColumnType::kString},
+    };
+
+    const utility::CsvReader reader(tmp.Str());
+    const auto table = reader.ReadColumns(FlagIsOne, specs);
+    REQUIRE(table.RowCount() == 100);
+    CHECK(table.Int64Column("id")[1] == 3);
+    CHECK(table.DoubleColumn("value")[1] == doctest::Approx(1.5));
+    CHECK(table.StringColumn("category")[1] == "A");
+    CHECK(reinterpret_cast<std::uintptr_t>(table.DoubleColumn("value").Data()) % 64 == 0);
+    // ファイルサイズからの見積もりで事前確保され、全行分以上の容量がある
+    CHECK(table.DoubleColumn("value").Capacity() >= 300);
+
+    SUBCASE("parallel scan matches single-thread") {
+        const utility::CsvReader parallel(tmp.Str(), ParallelOptions(4));
+        const auto merged = parallel.ReadColumns(FlagIsOne, specs);
+        REQUIRE(merged.RowCount() == table.RowCount());
+        for (std::size_t i = 0; i < table.RowCount(); ++i) {
+            CHECK(merged.Int64Column(0)[i] == table.Int64Column(0)[i]);
+            CHECK(merged.DoubleColumn(1)[i] == table.DoubleColumn(1)[i]);
+            CHECK(merged.StringColumn(2)[i] == table.StringColumn(2)[i]);
+        }
+    }
+
+    SUBCASE("unknown column throws") {
+        CHECK_THROWS_AS(
+            reader.ReadColumns(FlagIsOne, {{"missing", utility::ColumnType::kDouble}}), std::invalid_argument
+        );
+    }
+}
+
+// ──────────────────────────────────────────────────────────────
+// mmap バックエンド / CsvRowView
+// ──────────────────────────────────────────────────────────────
+
+static bool FlagViewIsOne(const utility::CsvRowView &row) { return row["flag"].get<int>() == 1; }
+
+static utility::CsvReaderOptions MmapOptions(unsigned int num_threads) {
+    utility::CsvReaderOptions options = ParallelOptions(num_threads);
+    options.backend = utility::CsvBackend::kMmap;
+    return options;
+}
+
+TEST_CASE("CsvTokenizer: quoting and line endings") {
+    const std::string data = "a,\"b,c\",\"say \"\"hi\"\"\"\r\n\n1,,3\nlast,row,";
+    utility::CsvTokenizer tokenizer(data);
+    std::vector<std::string_view> fields;
+
+    REQUIRE(tokenizer.NextRow(fields));
+    CHECK(fields == std::vector<std::string_view>{"a", "b,c", "say \"hi\""});
+    REQUIRE(tokenizer.NextRow(fields)); // 空行は読み飛ばす
+    CHECK(fields == std::vector<std::string_view>{"1", "", "3"});
+    REQUIRE(tokenizer.NextRow(fields));
+    CHECK(fields == std::vector<std::string_view>{"last", "row", ""});
+    CHECK_FALSE(tokenizer.NextRow(fields));
+}
+
+TEST_CASE("StructuralScanner: all kernels agree") {
+    // ブロック境界（64 バイト）をまたぐ長さ・位置に区切り文字と改行を散らす
+    std::string data;
+    for (int i = 0; i < 1000; ++i) {
+        data += static_cast<char>("ab,\n\r9x"[(i * 7 + i / 13) % 7]);
+    }
+    for (const auto kernel : {utility::ScanKernel::kScalar, utility::ScanKernel::kSse2, utility::ScanKernel::kAvx2}) {
+        if (kernel == utility::ScanKernel::kAvx2 && utility::DetectScanKernel() != utility::ScanKernel::kAvx2) {
+            continue; // 非対応 CPU
+        }
+        if (kernel != utility::ScanKernel::kScalar && utility::DetectScanKernel() == utility::ScanKernel::kScalar) {
+            continue; // x86-64 以外
+        }
+        utility::StructuralScanner scanner(data, ',', kernel);
+        utility::StructuralScanner reference(data, ',', utility::ScanKernel::kScalar);
+        for (std::size_t pos = 0; pos <= data.size(); ++pos) {
+            REQUIRE(scanner.Next(pos) == reference.Next(pos));
+        }
+        CHECK(utility::StructuralScanner(data.substr(0, 70), '9', kernel).Next(0) == data.find_first_of("9\n\r"));
+    }
+}
+
+TEST_CASE("HasQuotedNewline") {
+    CHECK_FALSE(utility::HasQuotedNewline(""));
+    CHECK_FALSE(utility::HasQuotedNewline("a,b\n1,2\n"));
+    CHECK_FALSE(utility::HasQuotedNewline("a,\"x,y\"\n1,\"say \"\"hi\"\"\"\n"));
+    CHECK(utility::HasQuotedNewline("a,\"multi\nline\"\n"));
+    CHECK(utility::HasQuotedNewline("a,\"unterminated\n"));
+}
+
+TEST_CASE("CsvReader: CsvRowView predicate matches csv::CSVRow") {
+    const TempFile tmp("test_csv_wrapper_mmap.csv", MakeCsv(500));
+    const utility::CsvReader reference(tmp.Str());
+    const auto expected = reference.ReadFiltered(FlagIsOne, {"id", "value"});
+    const auto expected_labels = reference.ReadFilteredAsStrings(FlagIsOne, {"id", "category"});
+
+    for (const auto backend :
+         {utility::CsvBackend::kAuto, utility::CsvBackend::kCsvParser, utility::CsvBackend::kMmap}) {
+        for (const unsigned int num_threads : {1U, 4U}) {
+            utility::CsvReaderOptions options = ParallelOptions(num_threads);
+            options.backend = backend;
+            const utility::CsvReader reader(tmp.Str(), options);
+            CHECK(reader.ReadFiltered(FlagViewIsOne, {"id", "value"}) == expected);
+            CHECK(reader.ReadFilteredAsStrings(FlagViewIsOne, {"id", "category"}) == expected_labels);
+
+            const auto views = reader.ReadFilteredAsViews(FlagViewIsOne, {"id", "category"});
+            REQUIRE(views.Size() == expected_labels.size());
+            CHECK(std::equal(views.begin(), views.end(), expected_labels.begin()));
+        }
+    }
+}
+
+TEST_CASE("CsvReader: mmap backend") {
+    const TempFile tmp(
+        "test_csv_wrapper_mmap_quoted.csv",
+        "id,label,value,flag\r\n1,\"x,y\",1.5,1\r\n2,plain,2.5,0\r\n3,\"say \"\"hi\"\"\",3.5,1\r\n"
+    );
+
+    SUBCASE("quoted and escaped fields") {
+        const utility::CsvReader reader(tmp.Str(), MmapOptions(1));
+        CHECK(reader.ReadFilteredAsStrings(FlagViewIsOne, {"label"}) == std::vector<std::string>{"x,y", "say \"hi\""});
+        CHECK(reader.ReadFiltered(FlagViewIsOne, {"value"}) == std::vector<double>{1.5, 3.5});
+    }
+
+    SUBCASE("results outlive the reader") {
+        utility::CsvStringViews views;
+        utility::ColumnTable table;
+        {
+            const utility::CsvReader reader(tmp.Str(), MmapOptions(1));
+            const int flag = reader.IndexOf("flag");
+            REQUIRE(flag == 3);
+            auto by_index = [flag](const utility::CsvRowView &row) { return row[flag].get<int>() == 1; };
+            views = reader.ReadFilteredAsViews(by_index, {"label"});
+            table = reader.ReadColumns(
+                by_index, {{"id", utility::ColumnType::kInt64}, {"label", utility::ColumnType::kString}}
+            );
+        }
+        REQUIRE(views.Size() == 2);
+        CHECK(views[0] == "x,y");
+        CHECK(views[1] == "say \"hi\"");
+        REQUIRE(table.RowCount() == 2);
+        CHECK(table.Int64Column("id")[1] == 3);
+        CHECK(table.StringColumn("label")[0] == "x,y");
+        CHECK(table.StringColumn("label")[1] == "say \"hi\"");
+    }
+
+    SUBCASE("errors") {
+        const utility::CsvReader reader(tmp.Str(), MmapOptions(4));
+        CHECK(reader.IndexOf("missing") == -1);
+        CHECK_THROWS_AS(reader.ReadFiltered(FlagViewIsOne, {"missing"}), std::invalid_argument);
+        CHECK_THROWS_AS(reader.ReadFiltered(FlagViewIsOne, {"label"}), std::runtime_error);
+        auto bad_name = [](const utility::CsvRowView &row) { return row["nope"].IsEmpty(); };
+        CHECK_THROWS_AS(reader.ReadFiltered(bad_name, {"value"}), std::invalid_argument);
+    }
+}
+
+TEST_CASE("CsvReader: mmap parallel ReadColumns matches csv-parser") {
+    const TempFile tmp("test_csv_wrapper_mmap_columns.csv", MakeCsv(300));
+    const std::vector<utility::ColumnSpec> specs = {
+        {      "id",  utility::ColumnType::kInt64},
+        {   "value", utility::ColumnType::kDouble},
+        {"category", utility::ColumnType::kString},
+    };
+    const auto expected = utility::CsvReader(tmp.Str()).ReadColumns(FlagIsOne, specs);
+    const auto table = utility::CsvReader(tmp.Str(), MmapOptions(4)).ReadColumns(FlagViewIsOne, specs);
+    REQUIRE(table.RowCount() == expected.RowCount());
+    for (std::size_t i = 0; i < table.RowCount(); ++i) {
+        CHECK(table.Int64Column(0)[i] == expected.Int64Column(0)[i]);
+        CHECK(table.DoubleColumn(1)[i] == expected.DoubleColumn(1)[i]);
+        CHECK(table.StringColumn(2)[i] == expected.StringColumn(2)[i]);
+    }
+}
+
+TEST_CASE("CsvReader: auto backend falls back on quoted newlines") {
+    const TempFile tmp(
+        "test_csv_wrapper_auto_multiline.csv", "id,note,flag\n1,\"two\nlines\",1\n2,plain,0\n3,last,1\n"
+    );
+    const utility::CsvReader reader(tmp.Str());
+    CHECK(reader.ReadFiltered(FlagViewIsOne, {"id"}) == std::vector<double>{1.0, 3.0});
+    CHECK(reader.ReadFilteredAsStrings(FlagViewIsOne, {"note"}) == std::vector<std::string>{"two\nlines", "last"});
+
+    // 判定は読み込み間で再利用し、ファイルが変わったら判定し直す
+    const utility::CsvReader copy = reader;
+    std::ofstream(tmp.Str(), std::ios::trunc) << "id,note,flag\n1,one,1\n2,\"x,y\",1\n";
+    CHECK(copy.ReadFilteredAsStrings(FlagViewIsOne, {"note"}) == std::vector<std::string>{"one", "x,y"});
+    std::ofstream(tmp.Str(), std::ios::app) << "3,\"a\nb\",1\n";
+    CHECK(reader.ReadFilteredAsStrings(FlagViewIsOne, {"note"}) == std::vector<std::string>{"one", "x,y", "a\nb"});
+}
+
+// ──────────────────────────────────────────────────────────────
+// 先読み I/O
+// ──────────────────────────────────────────────────────────────
+
+TEST_CASE("ReadAheadFile: blocks are line-aligned and cover the file") {
+    const std::string content = MakeCsv(200) + "last,row,without,newline";
+    const TempFile tmp("test_csv_wrapper_read_ahead_blocks.csv", content);
+    // ブロックを行より短くして、行がブロックをまたぐ場合（バッファ拡張）も通す
+    for (const std::size_t block_bytes : {std::size_t{5}, std::size_t{64}, std::size_t{1} << 20}) {
+        utility::ReadAheadFile file(tmp.Str(), 0, block_bytes, 2);
+        std::string joined;
+        std::uint64_t expected_sequence = 0;
+        utility::ReadAheadFile::Block block;
+        while (file.Next(block)) {
+            CHECK(block.sequence == expected_sequence++);
+            CHECK(block.offset == joined.size());
+            const bool is_last = block.offset + block.size == content.size();
+            CHECK((is_last || block.View().back() == '\n'));
+            joined += block.View();
+            file.Release(std::move(block));
+        }
+        CHECK(joined == content);
+    }
+    CHECK_THROWS_AS(utility::ReadAheadFile("/nonexistent/read_ahead.csv"), std::runtime_error);
+
+    SUBCASE("quoted newlines do not end a block") {
+        const std::string quoted = "id,text\n0,\"a\nb\"\n1,\"\"\"c\"\"\n\nd\"\n2,e\n";
+        const TempFile quoted_tmp("test_csv_wrapper_read_ahead_quoted.csv", quoted);
+        utility::ReadAheadFile file(quoted_tmp.Str(), 0, 3, 2);
+        std::vector<std::string> blocks;
+        utility::ReadAheadFile::Block block;
+        while (file.Next(block)) {
+            blocks.emplace_back(block.View());
+            file.Release(std::move(block));
+        }
+        CHECK(blocks == std::vector<std::string>{"id,text\n", "0,\"a\nb\"\n", "1,\"\"\"c\"\"\n\nd\"\n", "2,e\n"});
+    }
+
+    SUBCASE("a quote in the middle of a field is a literal") {
+        // 2 行目の " はフィールドの途中なのでクォートを開かない（CsvTokenizer と同じ規則）
+        const std::string stray = "id,text\n0,5\" bolt\n1,\"multi\nline\"\n2,x\"y\n3,z\n";
+        const TempFile stray_tmp("test_csv_wrapper_read_ahead_stray.csv", stray);
+        utility::ReadAheadFile file(stray_tmp.Str(), 0, 4, 2);
+        std::vector<std::string> blocks;
+        utility::ReadAheadFile::Block block;
+        while (file.Next(block)) {
+            blocks.emplace_back(block.View());
+            file.Release(std::move(block));
+        }
+        CHECK(
+            blocks ==
+            std::vector<std::string>{"id,text\n", "0,5\" bolt\n", "1,\"multi\nline\"\n", "2,x\"y\n", "3,z\n"}
+        );
+    }
+
+    SUBCASE("abandoning the reader stops the I/O thread") {
+        utility::ReadAheadFile file(tmp.Str(), 0, 16, 2);
+        utility::ReadAheadFile::Block block;
+        CHECK(file.Next(block));
+    }
+}
+
+TEST_CASE("CsvReader: read-ahead backend matches mmap") {
+    using utility::Col;
+    const TempFile tmp("test_csv_wrapper_read_ahead.csv", MakeCsv(500));
+    const std::vector<utility::ColumnSpec> specs = {
+        {      "id",  utility::ColumnType::kInt64},
+        {   "value", utility::ColumnType::kDouble},
+        {"category", utility::ColumnType::kString},
+    };
+    const utility::CsvReader reference(tmp.Str(), MmapOptions(1));
+    const auto expected = reference.ReadFiltered(FlagViewIsOne, {"id", "value"});
+    const auto expected_labels = reference.ReadFilteredAsStrings(Col("category") == "B", {"category", "id"});
+    const auto expected_table = reference.ReadColumns(FlagViewIsOne, specs);
+
+    for (const unsigned int num_threads : {1U, 4U}) {
+        for (const std::size_t block_bytes : {std::size_t{7}, std::size_t{256}, std::size_t{1} << 20}) {
+            utility::CsvReaderOptions options;
+            options.num_threads = num_threads;
+            options.backend = utility::CsvBackend::kReadAhead;
+            options.read_ahead_bytes = block_bytes;
+            const utility::CsvReader reader(tmp.Str(), options);
+
+            CHECK(reader.ReadFiltered(FlagViewIsOne, {"id", "value"}) == expected);
+            CHECK(reader.ReadFilteredAsStrings(Col("category") == "B", {"category", "id"}) == expected_labels);
+            const auto views = reader.ReadFilteredAsViews(Col("category") == "B", {"category", "id"});
+            CHECK(std::equal(views.begin(), views.end(), expected_labels.begin(), expected_labels.end()));
+
+            const auto table = reader.ReadColumns(FlagViewIsOne, specs);
+            REQUIRE(table.RowCount() == expected_table.RowCount());
+            for (std::size_t i = 0; i < table.RowCount(); ++i) {
+                CHECK(table.Int64Column(0)[i] == expected_table.Int64Column(0)[i]);
+                CHECK(table.StringColumn(2)[i] == expected_table.StringColumn(2)[i]);
+            }
+
+            std::size_t streamed = 0;
+            reader.ReadBatches(
+                FlagViewIsOne, specs, [&](utility::ColumnTable &batch) { streamed += batch.RowCount(); }, 16
+            );
+            CHECK(streamed == expected_table.RowCount());
+        }
+    }
+
+    SUBCASE("exception from predicate propagates") {
+        utility::CsvReaderOptions options;
+        options.num_threads = 4;
+        options.backend = utility::CsvBackend::kReadAhead;
+        options.read_ahead_bytes = 64;
+        auto throwing = [](const utility::CsvRowView &) -> bool { throw std::runtime_error("predicate failure"); };
+        CHECK_THROWS_AS(utility::CsvReader(tmp.Str(), options).ReadFiltered(throwing, {"value"}), std::runtime_error);
+    }
+
+    SUBCASE("stray quotes do not shift block boundaries") {
+        std::string content = "id,text\n";
+        std::vector<std::string> expected_text;
+        for (int i = 0; i < 50; ++i) {
+            const std::string n = std::to_string(i);
+            if (i % 2 == 0) {
+                content += n + "," + n + "\" bolt\n";
+                expected_text.push_back(n + "\" bolt");
+            } else {
+                content += n + ",\"multi\nline " + n + "\"\n";
+                expected_text.push_back("multi\nline " + n);
+            }
+        }
+        const TempFile stray("test_csv_wrapper_read_ahead_stray_rows.csv", content);
+        for (const unsigned int num_threads : {1U, 4U}) {
+            utility::CsvReaderOptions options;
+            options.num_threads = num_threads;
+            options.backend = utility::CsvBackend::kReadAhead;
+            options.read_ahead_bytes = 8;
+            const utility::CsvReader reader(stray.Str(), options);
+            CHECK(reader.ReadFilteredAsStrings(Col("id") >= 0, {"text"}) == expected_text);
+        }
+    }
+
+    SUBCASE("header-only file") {
+        const TempFile header_only("test_csv_wrapper_read_ahead_header.csv", "id,category,value,flag\n");
+        utility::CsvReaderOptions options;
+        options.backend = utility::CsvBackend::kReadAhead;
+        CHECK(utility::CsvReader(header_only.Str(), options).ReadFiltered(FlagViewIsOne, {"value"}).empty());
+    }
+}
+
+// ──────────────────────────────────────────────────────────────
+// 圧縮ファイル入力
+// ──────────────────────────────────────────────────────────────
+
+// content を chunk_bytes ごとに独立に圧縮して連結する（gzip は複数メンバー、zstd は複数フレームになる）
+static std::string CompressChunks(
+    [[maybe_unused]] utility::CompressionFormat format,
+    [[maybe_unused]] const std::string &content,
+    [[maybe_unused]] std::size_t chunk_bytes) {
+    std::string out;
+#if TEMPLATE_CLI_CPP_HAS_ZLIB
+    if (format == utility::CompressionFormat::kGzip) {
+        for (std::size_t pos = 0; pos < content.size(); pos += chunk_bytes) {
+            const std::size_t n = std::min(chunk_bytes, content.size() - pos);
+            z_stream stream{};
+            REQUIRE(deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK);
+            std::string member(deflateBound(&stream, static_cast<uLong>(n)) + 32, '\0');
+            stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(content.data() + pos));
+            stream.avail_in = static_cast<uInt>(n);
+            stream.next_out = reinterpret_cast<Bytef *>(member.data());
+            stream.avail_out = static_cast<uInt>(member.size());
+            REQUIRE(deflate(&stream, Z_FINISH) == Z_STREAM_END);
+            member.resize(stream.total_out);
+            deflateEnd(&stream);
+            out += member;
+        }
+    }
+#endif
+#if TEMPLATE_CLI_CPP_HAS_ZSTD
+    if (format == utility::CompressionFormat::kZstd) {
+        for (std::size_t pos = 0; pos < content.size(); pos += chunk_bytes) {
+            const std::size_t n = std::min(chunk_bytes, content.size() - pos);
+            std::string frame(ZSTD_compressBound(n), '\0');
+            const std::size_t size = ZSTD_compress(frame.data(), frame.size(), content.data() + pos, n, 3);
+            REQUIRE(!ZSTD_isError(size));
+            frame.resize(size);
+            out += frame;
+        }
+    }
+#endif
+    return out;
+}
+
+TEST_CASE("CsvReader: compressed input") {
+    using utility::Col;
+    using utility::CompressionFormat;
+    const std::string content = MakeCsv(500);
+    const TempFile plain("test_csv_wrapper_compressed.csv", content);
+    const utility::CsvReader reference(plain.Str(), MmapOptions(1));
+    const auto expected = reference.ReadFiltered(FlagViewIsOne, {"id", "value"});
+    const auto expected_labels = reference.ReadFilteredAsStrings(Col("category") == "B", {"category", "id"});
+    CHECK(utility::DetectCompression(plain.Str()) == CompressionFormat::kNone);
+
+    std::vector<CompressionFormat> formats;
+#if TEMPLATE_CLI_CPP_HAS_ZLIB
+    formats.push_back(CompressionFormat::kGzip);
+#endif
+#if TEMPLATE_CLI_CPP_HAS_ZSTD
+    formats.push_back(CompressionFormat::kZstd);
+#endif
+    for (const auto format : formats) {
+        // 1 つにまとめて圧縮した場合と、行の途中で区切って複数メンバー・フレームにした場合
+        for (const std::size_t chunk_bytes : {content.size(), std::size_t{1000}}) {
+            const TempFile compressed(
+                "test_csv_wrapper_compressed.csv.z", CompressChunks(format, content, chunk_bytes)
+            );
+            CHECK(utility::DetectCompression(compressed.Str()) == format);
+            for (const unsigned int num_threads : {1U, 4U}) {
+                utility::CsvReaderOptions options;
+                options.num_threads = num_threads;
+                options.read_ahead_bytes = 256;
+                const utility::CsvReader reader(compressed.Str(), options);
+
+                CHECK(reader.IndexOf("flag") == 3);
+                const auto schema = reader.InferSchema();
+                CHECK(schema.Column("value").type == utility::CsvFieldType::kDouble);
+                CHECK(schema.IsExact() == (content.size() < utility::CsvSchemaOptions().head_bytes));
+                CHECK(reader.ReadFiltered(FlagViewIsOne, {"id", "value"}) == expected);
+                CHECK(reader.ReadFilteredAsStrings(Col("category") == "B", {"category", "id"}) == expected_labels);
+                const auto table =
+                    reader.ReadColumns(Col("flag") == 1, {{"category", utility::ColumnType::kDictionary}});
+                CHECK(table.RowCount() * 2 == expected.size());
+                const auto aggregates = reader.ReadAggregates(Col("flag") == 1, "", {"value"});
+                CHECK(aggregates.RowCount(0) * 2 == expected.size());
+
+                // csv::CSVRow 述語版は伸長しながら csv-parser で読む
+                CHECK(reader.ReadFiltered(FlagIsOne, {"id", "value"}) == expected);
+                const auto row_table = reader.ReadColumns(FlagIsOne, {{"id", utility::ColumnType::kInt64}});
+                CHECK(row_table.RowCount() * 2 == expected.size());
+            }
+            const auto is_b = [](const csv::CSVRow &row) { return row["category"].get<csv::string_view>() == "B"; };
+            const utility::CsvReader single(compressed.Str());
+            CHECK(single.ReadFilteredAsStrings(is_b, {"category", "id"}) == expected_labels);
+        }
+    }
+
+    SUBCASE("quoted newlines are not split across blocks") {
+        std::string quoted = "id,text\n";
+        std::vector<std::string> expected_text;
+        for (int i = 0; i < 100; ++i) {
+            const std::string n = std::to_string(i);
+            expected_text.push_back("line " + n + "\nnext \"" + n + "\"");
+            quoted += n + ",\"line " + n + "\nnext \"\"" + n + "\"\"\"\n";
+        }
+        for (const auto format : formats) {
+            const TempFile compressed("test_csv_wrapper_compressed_quoted.csv.z", CompressChunks(format, quoted, 64));
+            for (const unsigned int num_threads : {1U, 4U}) {
+                utility::CsvReaderOptions options;
+                options.num_threads = num_threads;
+                options.read_ahead_bytes = 16;
+                const utility::CsvReader reader(compressed.Str(), options);
+                CHECK(reader.ReadFilteredAsStrings(Col("id") >= 0, {"text"}) == expected_text);
+            }
+        }
+    }
+
+    SUBCASE("corrupt input throws") {
+        for (const auto format : formats) {
+            std::string data = CompressChunks(format, content, content.size());
+            data.resize(data.size() / 2);
+            const TempFile truncated("test_csv_wrapper_compressed_truncated.csv.z", data);
+            const utility::CsvReader reader(truncated.Str());
+            CHECK_THROWS_AS(reader.ReadFiltered(Col("flag") == 1, {"value"}), std::runtime_error);
+            CHECK_THROWS_AS(reader.ReadFiltered(FlagIsOne, {"value"}), std::runtime_error);
+        }
+    }
+}
+
+// ──────────────────────────────────────────────────────────────
+// 行番号による部分読み込み
+// ──────────────────────────────────────────────────────────────
+
+TEST_CASE("CsvRowIndex: checkpoints locate every row") {
+    // 空行とクォート内改行は行として数えない
+    const TempFile tmp("test_csv_row_index.csv", "id,text\n0,a\n\n1,\"b\nc\"\n2,d\n3,e\n4,f\n");
+    const auto index = utility::CsvRowIndex::Build(tmp.Str(), 2);
+    CHECK(index->RowCount() == 5);
+    CHECK(index->Stride() == 2);
+    CHECK(index->Matches(tmp.Str()));
+
+    const auto checkpoint = index->Locate(3);
+    CHECK(checkpoint.row == 2);
+    CHECK(checkpoint.skip == 1);
+    std::ifstream ifs(tmp.Str(), std::ios::binary);
+    const std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    CHECK(content.compare(static_cast<std::size_t>(checkpoint.offset), 4, "2,d\n") == 0);
+    CHECK_THROWS_AS(index->Locate(5), std::out_of_range);
+
+    SUBCASE("saved index is reopened until the source changes") {
+        const std::string index_path = utility::CsvRowIndex::PathFor(tmp.Str(), "");
+        index->Save(index_path);
+        const auto reopened = utility::CsvRowIndex::Open(tmp.Str(), index_path);
+        REQUIRE(reopened != nullptr);
+        CHECK(reopened->RowCount() == 5);
+        CHECK(reopened->Locate(4).offset == index->Locate(4).offset);
+
+        std::ofstream(tmp.Str(), std::ios::app) << "5,g\n";
+        CHECK(utility::CsvRowIndex::Open(tmp.Str(), index_path) == nullptr);
+        CHECK(utility::CsvRowIndex::OpenOrBuild(tmp.Str(), index_path, 2)->RowCount() == 6);
+        CHECK(utility::CsvRowIndex::Open(tmp.Str(), index_path) != nullptr);
+        std::filesystem::remove(index_path);
+    }
+
+    SUBCASE("cache_dir separates files with the same name") {
+        using utility::CsvRowIndex;
+        const TempDir dir("test_csv_row_index_dir");
+        const TempDir other_dir("test_csv_row_index_other");
+        const std::string other = (other_dir.path / tmp.path.filename()).string();
+        std::filesystem::copy_file(tmp.path, other);
+        std::filesystem::last_write_time(other, std::filesystem::last_write_time(tmp.path));
+
+        const std::string shared_path = CsvRowIndex::PathFor(tmp.Str(), dir.Str());
+        CHECK(std::filesystem::path(shared_path).parent_path() == dir.path);
+        CHECK(CsvRowIndex::PathFor(other, dir.Str()) != shared_path);
+
+        const auto shared = CsvRowIndex::OpenOrBuild(tmp.Str(), shared_path, 2);
+        CHECK(CsvRowIndex::Open(tmp.Str(), shared_path) != nullptr);
+        CHECK(shared->Matches(tmp.Str()));
+        // サイズ・更新時刻が同じでも、別のファイルのインデックスは開かない
+        CHECK(CsvRowIndex::Open(other, shared_path) == nullptr);
+        CHECK_FALSE(shared->Matches(other));
+    }
+}
+
+TEST_CASE("CsvReader: ReadRange / ReadRows / sampling") {
+    using utility::ColumnType;
+    const std::vector<utility::ColumnSpec> specs = {{"id", ColumnType::kInt64}, {"category", ColumnType::kString}};
+    const TempFile tmp("test_csv_wrapper_rows.csv", MakeCsv(1000));
+    utility::CsvReaderOptions options;
+    options.row_index_stride = 16;
+    const utility::CsvReader reader(tmp.Str(), options);
+    CHECK(reader.RowCount() == 1000);
+
+    SUBCASE("range") {
+        const auto table = reader.ReadRange(500, 537, specs);
+        REQUIRE(table.RowCount() == 37);
+        for (std::size_t i = 0; i < table.RowCount(); ++i) {
+            CHECK(table.Int64Column(0)[i] == static_cast<std::int64_t>(500 + i));
+        }
+        CHECK(table.StringColumn(1)[0] == "C");
+        CHECK(reader.ReadRange(990, 2000, specs).RowCount() == 10);
+        CHECK(reader.ReadRange(2000, 3000, specs).RowCount() == 0);
+        CHECK_THROWS_AS(reader.ReadRange(10, 5, specs), std::invalid_argument);
+        CHECK_THROWS_AS(reader.ReadRange(0, 1, {{"missing", ColumnType::kInt64}}), std::invalid_argument);
+    }
+
+    SUBCASE("rows") {
+        const std::vector<std::uint64_t> rows = {0, 1, 15, 16, 17, 300, 999};
+        const auto table = reader.ReadRows(rows, specs);
+        REQUIRE(table.RowCount() == rows.size());
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            CHECK(table.Int64Column(0)[i] == static_cast<std::int64_t>(rows[i]));
+        }
+        CHECK_THROWS_AS(reader.ReadRows({3, 3}, specs), std::invalid_argument);
+        CHECK_THROWS_AS(reader.ReadRows({5, 4}, specs), std::invalid_argument);
+        CHECK_THROWS_AS(reader.ReadRows({1000}, specs), std::out_of_range);
+    }
+
+    SUBCASE("uniform sample") {
+        const auto rows = reader.SampleRows(50, utility::CsvSampling::kUniform, 7);
+        REQUIRE(rows.size() == 50);
+        CHECK(std::adjacent_find(rows.begin(), rows.end(), std::greater_equal<>()) == rows.end());
+        CHECK(rows.back() < 1000);
+        CHECK(reader.SampleRows(50, utility::CsvSampling::kUniform, 7) == rows);
+        CHECK(reader.SampleRows(50, utility::CsvSampling::kUniform, 8) != rows);
+
+        const auto table = reader.ReadSample(50, specs, utility::CsvSampling::kUniform, 7);
+        REQUIRE(table.RowCount() == 50);
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            CHECK(table.Int64Column(0)[i] == static_cast<std::int64_t>(rows[i]));
+        }
+        CHECK(reader.SampleRows(5000).size() == 1000);
+    }
+
+    SUBCASE("stratified sample picks one row per stratum") {
+        const auto rows = reader.SampleRows(30, utility::CsvSampling::kStratified, 1);
+        REQUIRE(rows.size() == 30);
+        for (std::uint64_t k = 0; k < rows.size(); ++k) {
+            CHECK(rows[k] >= 1000 * k / 30);
+            CHECK(rows[k] < 1000 * (k + 1) / 30);
+        }
+    }
+
+    SUBCASE("zero-row sample is empty") {
+        for (const auto method : {utility::CsvSampling::kUniform, utility::CsvSampling::kStratified}) {
+            CHECK(reader.SampleRows(0, method, 3).empty());
+            CHECK(reader.ReadSample(0, specs, method, 3).RowCount() == 0);
+        }
+    }
+
+    SUBCASE("persisted index is written next to the file") {
+        utility::CsvReaderOptions persist = options;
+        persist.persist_row_index = true;
+        const utility::CsvReader persisted(tmp.Str(), persist);
+        const std::string index_path = utility::CsvRowIndex::PathFor(tmp.Str(), "");
+        CHECK(persisted.ReadRange(100, 101, specs).Int64Column(0)[0] == 100);
+        CHECK(std::filesystem::exists(index_path));
+        CHECK(utility::CsvRowIndex::Open(tmp.Str(), index_path)->Stride() == 16);
+        std::filesystem::remove(index_path);
+    }
+}
+
+TEST_CASE("CsvReader: ReadRows handles quoted fields") {
+    const TempFile tmp("test_csv_wrapper_rows_quoted.csv", "id,text\n0,\"a,\"\"x\"\"\"\n1,\"multi\nline\"\n2,plain\n");
+    utility::CsvReaderOptions options;
+    options.row_index_stride = 1;
+    const utility::CsvReader reader(tmp.Str(), options);
+    const auto table = reader.ReadRange(0, 3, {{"text", utility::ColumnType::kString}});
+    REQUIRE(table.RowCount() == 3);
+    CHECK(table.StringColumn(0)[0] == "a,\"x\"");
+    CHECK(table.StringColumn(0)[1] == "multi\nline");
+    CHECK(table.StringColumn(0)[2] == "plain");
+}
+
+// ──────────────────────────────────────────────────────────────
+// 列の型の推定
+// ──────────────────────────────────────────────────────────────
+
+TEST_CASE("CsvReader: InferSchema on a small file is exact") {
+    using utility::CsvFieldType;
+    const TempFile tmp("test_csv_wrapper_schema.csv", MakeCsv(300));
+    const utility::CsvReader reader(tmp.Str());
+    const auto schema = reader.InferSchema();
+    CHECK(schema.IsExact());
+    CHECK(schema.SampledRows() == 300);
+    CHECK(schema.EstimatedRows() == 300);
+    REQUIRE(schema.Columns().size() == 4);
+
+    const auto &id = schema.Column("id");
+    CHECK(id.type == CsvFieldType::kInt32);
+    CHECK_FALSE(id.nullable);
+    CHECK(id.min == 0.0);
+    CHECK(id.max == 299.0);
+    CHECK(schema.Column("category").type == CsvFieldType::kString);
+    CHECK(schema.Column("category").distinct == 3);
+    CHECK(schema.Column("value").type == CsvFieldType::kDouble);
+    CHECK(schema.Column("value").max == doctest::Approx(149.5));
+    CHECK_THROWS_AS(schema.Column("missing"), std::invalid_argument);
+
+    const auto specs = schema.Specs();
+    CHECK(specs[0].type == utility::ColumnType::kInt64);
+    CHECK(specs[1].type == utility::ColumnType::kDictionary);
+    CHECK(specs[2].type == utility::ColumnType::kDouble);
+    const auto table = reader.ReadColumns(utility::Col("flag") == 1, schema.Specs({"id", "value"}));
+    CHECK(table.RowCount() == 100);
+}
+
+TEST_CASE("CsvReader: InferSchema widens types and tracks nulls") {
+    using utility::CsvFieldType;
+    const TempFile tmp(
+        "test_csv_wrapper_schema_mixed.csv", "a,b,c,d,e\n1,,x,3000000000,\n2,2.5,y,1,\n,3,z,-2,\n4,nan,w,5\n"
+    );
+    const auto schema = utility::CsvReader(tmp.Str()).InferSchema();
+    CHECK(schema.Column("a").type == CsvFieldType::kInt32);
+    CHECK(schema.Column("a").nullable);
+    CHECK(schema.Column("a").nulls == 1);
+    CHECK(schema.Column("b").type == CsvFieldType::kDouble);
+    CHECK(schema.Column("b").min == 2.5);
+    CHECK(schema.Column("b").max == 3.0);
+    CHECK(schema.Column("c").type == CsvFieldType::kString);
+    CHECK(std::isnan(schema.Column("c").min));
+    CHECK(schema.Column("d").type == CsvFieldType::kInt64);
+    CHECK(schema.Column("d").min == -2.0);
+    CHECK(schema.Column("d").max == 3000000000.0);
+    // 値がすべて空（最後の行は列が足りない）
+    CHECK(schema.Column("e").type == CsvFieldType::kEmpty);
+    CHECK(schema.Column("e").nulls == 4);
+    CHECK(schema.Specs({"e"})[0].type == utility::ColumnType::kString);
+}
+
+TEST_CASE("CsvReader: InferSchema probes beyond the head") {
+    // 先頭 100 行は数値、残りは文字列
+    std::string content = "id,v\n";
+    for (int i = 0; i < 2100; ++i) {
+        content += std::to_string(i) + ',' + (i < 100 ? std::to_string(i) : std::string("n/a")) + '\n';
+    }
+    const TempFile tmp("test_csv_wrapper_schema_probe.csv", content);
+    const utility::CsvReader reader(tmp.Str());
+
+    utility::CsvSchemaOptions options;
+    options.head_bytes = 256;
+    options.probe_bytes = 128;
+    options.probes = 0;
+    CHECK(reader.InferSchema(options).Column("v").type == utility::CsvFieldType::kInt32);
+
+    options.probes = 8;
+    const auto schema = reader.InferSchema(options);
+    CHECK_FALSE(schema.IsExact());
+    CHECK(schema.Column("v").type == utility::CsvFieldType::kString);
+    CHECK(schema.SampledRows() < 2100);
+    CHECK(schema.EstimatedRows() > 1500);
+    CHECK(schema.EstimatedRows() < 3000);
+}
+
+// ──────────────────────────────────────────────────────────────
+// 数値変換
+// ──────────────────────────────────────────────────────────────
+
+TEST_CASE("ParseNumber") {
+    double d = -1.0;
+    CHECK(utility::ParseNumber("1.5", d));
+    CHECK(d == 1.5);
+    CHECK(utility::ParseNumber(" +2.5e3\t", d));
+    CHECK(d == 2500.0);
+    CHECK(utility::ParseNumber("-0.125", d));
+    CHECK(d == -0.125);
+
+    std::int64_t i = 0;
+    CHECK(utility::ParseNumber("-9223372036854775808", i));
+    CHECK(i == INT64_MIN);
+    CHECK(utility::ParseNumber("42", i));
+    CHECK(i == 42);
+
+    SUBCASE("failures leave the output untouched") {
+        for (const char *bad : {"", " ", "abc", "1.5x", "+-1", "1 2"}) {
+            double value = 7.0;
+            CHECK_FALSE(utility::ParseNumber(bad, value));
+            CHECK(value == 7.0);
+        }
+        int small = 3;
+        CHECK_FALSE(utility::ParseNumber("1.5", small));
+        CHECK_FALSE(utility::ParseNumber("99999999999", small));
+        CHECK(small == 3);
+    }
+
+    SUBCASE("CsvFieldView") {
+        const utility::CsvFieldView field(" 12 ");
+        int value = 0;
+        CHECK(field.TryGet(value));
+        CHECK(field.get<long long>() == 12);
+        CHECK_FALSE(utility::CsvFieldView("n/a").TryGet(value));
+        CHECK_THROWS_AS(utility::CsvFieldView("n/a").get<double>(), std::runtime_error);
+    }
+}
+
+TEST_CASE("CsvReader: non-numeric output cell throws") {
+    const TempFile tmp("test_csv_wrapper_not_number.csv", "id,value,flag\n1,abc,1\n");
+    const utility::CsvReader reader(tmp.Str());
+    CHECK_THROWS_AS(reader.ReadFiltered(FlagIsOne, {"value"}), std::runtime_error);
+    CHECK_THROWS_AS(
+        reader.ReadColumns(FlagIsOne, {{"value", utility::ColumnType::kDouble}}), std::runtime_error
+    );
+}
+
+// ──────────────────────────────────────────────────────────────
+// 型付き列射影
+// ──────────────────────────────────────────────────────────────
+
+TEST_CASE("CsvReader: typed Read") {
+    const TempFile tmp("test_csv_wrapper_typed.csv", MakeCsv(300));
+    const utility::CsvReader reference(tmp.Str());
+    const auto expected_values = reference.ReadFiltered(FlagIsOne, {"value"});
+    const auto expected_labels = reference.ReadFilteredAsStrings(FlagIsOne, {"category"});
+
+    for (const unsigned int num_threads : {1U, 4U}) {
+        const utility::CsvReader reader(tmp.Str(), ParallelOptions(num_threads));
+        const int flag = reader.IndexOf("flag");
+        auto [ids, values, labels] = reader.Read<std::int64_t, double, std::string>(
+            [flag](const utility::CsvRowView &row) { return row[flag].get<int>() == 1; }, {"id", "value", "category"}
+        );
+        REQUIRE(ids.size() == 100);
+        CHECK(ids[1] == 3);
+        CHECK(values == expected_values);
+        CHECK(labels == expected_labels);
+    }
+
+    CHECK_THROWS_AS(reference.Read<double>(FlagViewIsOne, {"missing"}), std::invalid_argument);
+    CHECK_THROWS_AS(reference.Read<int>(FlagViewIsOne, {"value"}), std::runtime_error);
+}
+
+// ──────────────────────────────────────────────────────────────
+// フィルタ式
+// ──────────────────────────────────────────────────────────────
+
+TEST_CASE("CsvTokenizer: partial rows") {
+    const std::string data = "a,b,\"c\nd\",e\n1,2,3,4\n";
+    utility::CsvTokenizer tokenizer(data);
+    std::vector<std::string_view> fields;
+
+    REQUIRE(tokenizer.BeginRow(fields));
+    tokenizer.ReadFields(fields, 1);
+    CHECK(fields == std::vector<std::string_view>{"a"});
+    tokenizer.SkipRow(); // クォート内改行を含む残りも正しく読み飛ばす
+
+    REQUIRE(tokenizer.BeginRow(fields));
+    tokenizer.ReadFields(fields, 2);
+    tokenizer.ReadFields(fields, 3);
+    CHECK(fields == std::vector<std::string_view>{"1", "2", "3"});
+    tokenizer.SkipRow();
+    CHECK_FALSE(tokenizer.BeginRow(fields));
+}
+
+TEST_CASE("CsvFilter: evaluation") {
+    using utility::Col;
+    const utility::CsvHeader header({"id", "category", "value"});
+    auto matches = [&](const utility::CsvFilter &filter, std::vector<std::string_view> fields) {
+        return filter.Compile(header).Evaluate(utility::CsvRowView(fields, header));
+    };
+
+    CHECK(matches(Col("value") > 1.5, {"1", "A", "2.0"}));
+    CHECK_FALSE(matches(Col("value") > 1.5, {"1", "A", "1.5"}));
+    CHECK(matches(Col("value") >= 1.5 && Col("category") == "A", {"1", "A", "1.5"}));
+    CHECK(matches(Col("id") == 9 || Col("category") != "B", {"1", "A", "0"}));
+    CHECK(matches(!(Col("category") < std::string("B")), {"1", "C", "0"}));
+    // 数値として解釈できない・列がない場合の比較は false
+    CHECK_FALSE(matches(Col("value") == 0, {"1", "A", "n/a"}));
+    CHECK_FALSE(matches(Col("value") == 0, {"1", "A"}));
+    CHECK_THROWS_AS((Col("missing") == 1).Compile(header), std::invalid_argument);
+    CHECK((Col("value") < 1 && Col("category") == "A").Compile(header).RequiredFields() == 3);
+}
+
+TEST_CASE("CsvReader: filter expression matches predicate") {
+    using utility::Col;
+    const TempFile tmp("test_csv_wrapper_filter.csv", MakeCsv(500));
+    auto predicate = [](const csv::CSVRow &row) {
+        return row["flag"].get<int>() == 1 &&
+               (row["value"].get<double>() > 100.0 || row["category"].get<std::string>() == "B");
+    };
+    const auto filter = Col("flag") == 1 && (Col("value") > 100.0 || Col("category") == "B");
+
+    const utility::CsvReader reference(tmp.Str());
+    const auto expected = reference.ReadFiltered(predicate, {"id", "value"});
+    const auto expected_labels = reference.ReadFilteredAsStrings(predicate, {"category", "id"});
+    REQUIRE_FALSE(expected.empty());
+
+    for (const auto backend : {utility::CsvBackend::kCsvParser, utility::CsvBackend::kMmap}) {
+        for (const unsigned int num_threads : {1U, 4U}) {
+            utility::CsvReaderOptions options = ParallelOptions(num_threads);
+            options.backend = backend;
+            const utility::CsvReader reader(tmp.Str(), options);
+            CHECK(reader.ReadFiltered(filter, {"id", "value"}) == expected);
+            CHECK(reader.ReadFilteredAsStrings(filter, {"category", "id"}) == expected_labels);
+            const auto views = reader.ReadFilteredAsViews(filter, {"category", "id"});
+            CHECK(std::equal(views.begin(), views.end(), expected_labels.begin(), expected_labels.end()));
+            const auto table = reader.ReadColumns(filter, {{"id", utility::ColumnType::kInt64}});
+            CHECK(table.RowCount() * 2 == expected.size());
+        }
+    }
+
+    CHECK_THROWS_AS(reference.ReadFiltered(Col("missing") == 1, {"id"}), std::invalid_argument);
+}
+
+// ──────────────────────────────────────────────────────────────
+// バッチ単位のストリーミング
+// ──────────────────────────────────────────────────────────────
+
+TEST_CASE("CsvReader: ReadBatches matches ReadColumns") {
+    const TempFile tmp("test_csv_wrapper_batches.csv", MakeCsv(1000));
+    const std::vector<utility::ColumnSpec> specs = {
+        {      "id",  utility::ColumnType::kInt64},
+        {"category", utility::ColumnType::kString},
+    };
+    const auto expected = utility::CsvReader(tmp.Str()).ReadColumns(FlagIsOne, specs);
+    REQUIRE(expected.RowCount() == 334);
+
+    for (const auto backend : {utility::CsvBackend::kCsvParser, utility::CsvBackend::kMmap}) {
+        utility::CsvReaderOptions options;
+        options.backend = backend;
+        const utility::CsvReader reader(tmp.Str(), options);
+
+        std::vector<std::int64_t> ids;
+        std::vector<std::string> categories;
+        std::vector<std::size_t> sizes;
+        reader.ReadBatches(
+            FlagViewIsOne,
+            specs,
+            [&](utility::ColumnTable &batch) {
+                sizes.push_back(batch.RowCount());
+                for (std::size_t i = 0; i < batch.RowCount(); ++i) {
+                    ids.push_back(batch.Int64Column(0)[i]);
+                    categories.emplace_back(batch.StringColumn(1)[i]);
+                }
+            },
+            100
+        );
+        CHECK(sizes == std::vector<std::size_t>{100, 100, 100, 34});
+        REQUIRE(ids.size() == expected.RowCount());
+        for (std::size_t i = 0; i < ids.size(); ++i) {
+            CHECK(ids[i] == expected.Int64Column(0)[i]);
+            CHECK(categories[i] == expected.StringColumn(1)[i]);
+        }
+
+        std::size_t filtered_rows = 0;
+        reader.ReadBatches(
+            utility::Col("flag") == 1,
+            specs,
+            [&](utility::ColumnTable &batch) { filtered_rows += batch.RowCount(); },
+            64
+        );
+        CHECK(filtered_rows == expected.RowCount());
+    }
+}
+
+TEST_CASE("CsvReader: ReadBatches propagates exceptions") {
+    const TempFile tmp("test_csv_wrapper_batches_error.csv", MakeCsv(1000));
+    const utility::CsvReader reader(tmp.Str(), MmapOptions(1));
+    const std::vector<utility::ColumnSpec> specs = {{"id", utility::ColumnType::kInt64}};
+
+    SUBCASE("consumer") {
+        int calls = 0;
+        auto consumer = [&](utility::ColumnTable &) {
+            if (++calls == 2) {
+                throw std::logic_error("stop");
+            }
+        };
+        CHECK_THROWS_AS(reader.ReadBatches(utility::Col("flag") == 1, specs, consumer, 10), std::logic_error);
+        CHECK(calls == 2);
+    }
+
+    SUBCASE("non-numeric output cell") {
+        auto consumer = [](utility::ColumnTable &) {};
+        CHECK_THROWS_AS(
+            reader.ReadBatches(FlagViewIsOne, {{"category", utility::ColumnType::kDouble}}, consumer, 10),
+            std::runtime_error
+        );
+    }
+
+    SUBCASE("unknown column") {
+        auto consumer = [](utility::ColumnTable &) {};
+        CHECK_THROWS_AS(
+            reader.ReadBatches(FlagViewIsOne, {{"missing", utility::ColumnType::kInt64}}, consumer),
+            std::invalid_argument
+        );
+    }
+}
+
+// ──────────────────────────────────────────────────────────────
+// 列指向バイナリキャッシュ
+// ──────────────────────────────────────────────────────────────
+
+TEST_CASE("CsvColumnCache: build, open and invalidate") {
+    const TempFile tmp("test_csv_column_cache.csv", "a,b,c\n1,\"x,\"\"y\"\"\",z\n2,\"multi\nline\",\n3\n");
+    const TempFile cache_file("test_csv_column_cache.csv.colcache", "");
+    const std::string cache_path = cache_file.Str();
+    CHECK(utility::CsvColumnCache::PathFor(tmp.Str(), "") == cache_path);
+    CHECK(utility::CsvColumnCache::Open(tmp.Str(), cache_path) == nullptr); // 空ファイルは無効
+
+    utility::CsvColumnCache::Build(tmp.Str(), cache_path);
+    const auto cache = utility::CsvColumnCache::Open(tmp.Str(), cache_path);
+    REQUIRE(cache != nullptr);
+    REQUIRE(cache->RowCount() == 3);
+    REQUIRE(cache->ColumnCount() == 3);
+    CHECK(cache->Header().IndexOf("c") == 2);
+    utility::CsvTypedValue scratch;
+    CHECK(cache->Field(1, 0, scratch) == "x,\"y\"");
+    CHECK(cache->Field(1, 1, scratch) == "multi\nline");
+    CHECK(cache->Field(2, 1, scratch).empty());
+    CHECK(cache->Field(0, 2, scratch) == "3");
+    CHECK(cache->Field(1, 2, scratch).empty()); // 列が足りない行は空フィールドで補う
+    CHECK(cache->Mapping()->Contains(cache->Field(2, 0, scratch)));
+    // 数値列は型付きの配列だけを持つ
+    using Kind = utility::CsvColumnCache::ColumnKind;
+    CHECK(cache->Kind(0) == Kind::kInt64);
+    REQUIRE(cache->Int64s(0) != nullptr);
+    CHECK(cache->Int64s(0)[2] == 3);
+    CHECK(cache->Doubles(0) == nullptr);
+    CHECK(cache->Kind(1) == Kind::kString); // 数値でないフィールドを含む列
+    CHECK(cache->Int64s(1) == nullptr);
+
+    SUBCASE("modified source invalidates cache") {
+        std::ofstream(tmp.path, std::ios::app) << "4,w,v\n";
+        CHECK(utility::CsvColumnCache::Open(tmp.Str(), cache_path) == nullptr);
+        const auto rebuilt = utility::CsvColumnCache::OpenOrBuild(tmp.Str(), cache_path);
+        CHECK(rebuilt->RowCount() == 4);
+        CHECK(rebuilt->Field(2, 3, scratch) == "v");
+        CHECK(cache->Field(2, 0, scratch) == "z"); // 置き換え前のマップは有効なまま
+    }
+
+    SUBCASE("numeric columns keep only values that reproduce the source text") {
+        // d: 指数表記、e: 小数点以下 2 桁、f: 表記が揃わない、g: int64 の最小値（null の印と衝突するため double）
+        const TempFile typed(
+            "test_csv_column_cache_typed.csv",
+            "d,e,f,g,h\n0.1,1.50,1.5,-9223372036854775808,-7\n,2.00,1.50,1,\n1e5,,3,2,9007199254740993\n"
+        );
+        const TempFile typed_cache("test_csv_column_cache_typed.csv.colcache", "");
+        const auto columns = utility::CsvColumnCache::OpenOrBuild(typed.Str(), typed_cache.Str());
+        CHECK(columns->Kind(0) == Kind::kString); // 1e5 は固定小数点表記で戻せない
+        CHECK(columns->Kind(1) == Kind::kDouble);
+        CHECK(columns->Kind(2) == Kind::kString);
+        CHECK(columns->Kind(3) == Kind::kDouble);
+        CHECK(columns->Kind(4) == Kind::kInt64);
+        CHECK(columns->Field(3, 0, scratch) == "-9223372036854775808");
+        CHECK(columns->Field(1, 0, scratch) == "1.50");
+        CHECK(columns->Field(1, 1, scratch) == "2.00");
+        CHECK(columns->Field(1, 2, scratch).empty());
+        CHECK(columns->Field(4, 2, scratch) == "9007199254740993");
+
+        std::string_view text;
+        columns->ReadField(4, 2, text, scratch);
+        const utility::CsvFieldView field(scratch);
+        CHECK(field.get<std::int64_t>() == 9007199254740993LL); // double を経由しない
+        CHECK(field.get<double>() == 9007199254740992.0);
+        int narrow = 0;
+        CHECK_FALSE(field.TryGet(narrow));
+        columns->ReadField(1, 0, text, scratch);
+        CHECK(utility::CsvFieldView(scratch).get<double>() == 1.5);
+        CHECK(utility::CsvFieldView(scratch).get<std::string>() == "1.50");
+        columns->ReadField(1, 2, text, scratch);
+        CHECK(scratch.GetKind() == utility::CsvTypedValue::Kind::kNone);
+    }
+
+    SUBCASE("filter evaluation over cached columns") {
+        // 空フィールドは数値配列では null になり、行単位の評価と同じくどの比較も false
+        const TempFile numeric("test_csv_column_cache_numeric.csv", "n,s,x\n1,x,0.5\n,y,\n3,z,2.25\n");
+        const TempFile numeric_cache("test_csv_column_cache_numeric.csv.colcache", "");
+        const auto columns = utility::CsvColumnCache::OpenOrBuild(numeric.Str(), numeric_cache.Str());
+        REQUIRE(columns->Int64s(0) != nullptr);
+        REQUIRE(columns->Doubles(2) != nullptr);
+        using utility::Col;
+        std::vector<std::uint8_t> scratch_rows;
+        for (const auto &filter :
+             {Col("n") != 1, Col("n") >= 1, !(Col("n") < 2) && Col("s") != "x", Col("s") > "x", Col("x") != 0.5,
+              Col("x") < 1.0, Col("n") == "3", Col("x") == "2.25"}) {
+            const auto compiled = filter.Compile(columns->Header());
+            const std::uint8_t *selected = compiled.EvaluateRows(*columns, 0, 3, scratch_rows);
+            for (std::size_t row = 0; row < 3; ++row) {
+                CHECK(selected[row] == compiled.EvaluateWith([&](std::size_t index, std::string_view &out) {
+                    out = columns->Field(index, row, scratch);
+                    return true;
+                }));
+            }
+        }
+    }
+
+    SUBCASE("corrupt cache is rejected") {
+        std::ofstream(cache_path, std::ios::binary | std::ios::trunc) << "TCCSVC03 truncated";
+        CHECK(utility::CsvColumnCache::Open(tmp.Str(), cache_path) == nullptr);
+    }
+
+    SUBCASE("cache_dir separates files with the same name") {
+        using utility::CsvColumnCache;
+        const TempDir dir("test_csv_column_cache_dir");
+        const TempDir other_dir("test_csv_column_cache_other");
+        const std::string other = (other_dir.path / tmp.path.filename()).string();
+        std::filesystem::copy_file(tmp.path, other);
+        std::filesystem::last_write_time(other, std::filesystem::last_write_time(tmp.path));
+
+        const std::string shared_path = CsvColumnCache::PathFor(tmp.Str(), dir.Str());
+        CHECK(std::filesystem::path(shared_path).parent_path() == dir.path);
+        CHECK(CsvColumnCache::PathFor(other, dir.Str()) != shared_path);
+        const std::string dotted = (tmp.path.parent_path() / "." / tmp.path.filename()).string();
+        CHECK(CsvColumnCache::PathFor(dotted, dir.Str()) == shared_path);
+
+        CsvColumnCache::Build(tmp.Str(), shared_path);
+        CHECK(CsvColumnCache::Open(tmp.Str(), shared_path) != nullptr);
+        // サイズ・更新時刻が同じでも、別のファイルのキャッシュは開かない
+        CHECK(CsvColumnCache::Open(other, shared_path) == nullptr);
+    }
+}
+
+TEST_CASE("CsvReader: column cache matches direct read") {
+    const TempFile tmp("test_csv_wrapper_cached.csv", MakeCsv(5000)); // 作成時の 1 ブロック（4096 行）を超える
+    const TempFile cache_file("test_csv_wrapper_cached.csv.colcache", "");
+    std::filesystem::remove(cache_file.path);
+    const auto filter = utility::Col("flag") == 1 && utility::Col("value") > 50.0 && utility::Col("category") != "B";
+    const std::vector<utility::ColumnSpec> specs = {
+        {      "id",  utility::ColumnType::kInt64},
+        {"category", utility::ColumnType::kString},
+    };
+
+    const utility::CsvReader reference(tmp.Str());
+    const auto expected = reference.ReadFiltered(FlagViewIsOne, {"id", "value"});
+    const auto expected_labels = reference.ReadFilteredAsStrings(filter, {"category", "id"});
+    // id・value は数値列として保存され、文字列出力は値から元の表記（"12.500000" 等）に戻す
+    const auto expected_numbers = reference.ReadFilteredAsStrings(filter, {"value", "id"});
+
+    for (const unsigned int num_threads : {1U, 4U}) {
+        utility::CsvReaderOptions options = ParallelOptions(num_threads);
+        options.column_cache = true;
+        const utility::CsvReader reader(tmp.Str(), options);
+        CHECK(reader.ReadFiltered(FlagViewIsOne, {"id", "value"}) == expected);
+        REQUIRE(std::filesystem::exists(cache_file.path));
+        CHECK(reader.ReadFilteredAsStrings(filter, {"category", "id"}) == expected_labels);
+        CHECK(reader.ReadFilteredAsStrings(filter, {"value", "id"}) == expected_numbers);
+        const auto views = reader.ReadFilteredAsViews(filter, {"category", "id"});
+        CHECK(std::equal(views.begin(), views.end(), expected_labels.begin(), expected_labels.end()));
+
+        const auto table = reader.ReadColumns(FlagViewIsOne, specs);
+        const auto expected_table = reference.ReadColumns(FlagViewIsOne, specs);
+        REQUIRE(table.RowCount() == expected_table.RowCount());
+        for (std::size_t i = 0; i < table.RowCount(); ++i) {
+            CHECK(table.Int64Column(0)[i] == expected_table.Int64Column(0)[i]);
+            CHECK(table.StringColumn(1)[i] == expected_table.StringColumn(1)[i]);
+        }
+    }
+
+    // 有効なキャッシュは作り直さない
+    const auto built_at = std::filesystem::last_write_time(cache_file.path);
+    utility::CsvReaderOptions options;
+    options.column_cache = true;
+    CHECK(utility::CsvReader(tmp.Str(), options).ReadFiltered(filter, {"id"}).size() * 2 == expected_labels.size());
+    CHECK(std::filesystem::last_write_time(cache_file.path) == built_at);
+}
+
+// ──────────────────────────────────────────────────────────────
+// 複数問い合わせの一括走査
+// ──────────────────────────────────────────────────────────────
+
+TEST_CASE("CsvReader: ReadQueries matches individual ReadColumns") {
+    using utility::Col;
+    const TempFile tmp("test_csv_wrapper_queries.csv", MakeCsv(500));
+    const TempFile cache_file("test_csv_wrapper_queries.csv.colcache", "");
+    std::filesystem::remove(cache_file.path);
+
+    const std::vector<utility::ColumnSpec> id_spec = {{"id", utility::ColumnType::kInt64}};
+    const std::vector<utility::ColumnSpec> label_specs = {
+        {"category", utility::ColumnType::kString},
+        {   "value", utility::ColumnType::kDouble},
+    };
+    auto large_value = [](const utility::CsvRowView &row) { return row["value"].get<double>() > 200.0; };
+    const auto category_b = Col("category") == "B";
+
+    utility::CsvQuerySet queries;
+    const std::size_t flagged = queries.Add(Col("flag") == 1, id_spec);
+    const std::size_t large = queries.Add(large_value, label_specs);
+    const std::size_t labels = queries.Add(category_b, label_specs);
+    REQUIRE(queries.Size() == 3);
+
+    const utility::CsvReader reference(tmp.Str());
+    const auto expected_flagged = reference.ReadColumns(FlagViewIsOne, id_spec);
+    const auto expected_large = reference.ReadColumns(large_value, label_specs);
+    const auto expected_labels = reference.ReadColumns(category_b, label_specs);
+
+    auto check_same = [](const utility::ColumnTable &actual, const utility::ColumnTable &expected) {
+        REQUIRE(actual.RowCount() == expected.RowCount());
+        for (std::size_t i = 0; i < actual.RowCount(); ++i) {
+            for (std::size_t col = 0; col < actual.ColumnCount(); ++col) {
+                switch (actual.Spec(col).type) {
+                    case utility::ColumnType::kInt64:
+                        CHECK(actual.Int64Column(col)[i] == expected.Int64Column(col)[i]);
+                        break;
+                    case utility::ColumnType::kDouble:
+                        CHECK(actual.DoubleColumn(col)[i] == expected.DoubleColumn(col)[i]);
+                        break;
+                    case utility::ColumnType::kString:
+                        CHECK(actual.StringColumn(col)[i] == expected.StringColumn(col)[i]);
+                        break;
+                    case utility::ColumnType::kDictionary:
+                        CHECK(actual.DictionaryColumn(col)[i] == expected.DictionaryColumn(col)[i]);
+                        break;
+                }
+            }
+        }
+    };
+
+    for (const auto backend : {utility::CsvBackend::kCsvParser, utility::CsvBackend::kMmap}) {
+        for (const bool column_cache : {false, true}) {
+            for (const unsigned int num_threads : {1U, 4U}) {
+                utility::CsvReaderOptions options = ParallelOptions(num_threads);
+                options.backend = backend;
+                options.column_cache = column_cache;
+                const auto results = utility::CsvReader(tmp.Str(), options).ReadQueries(queries);
+                REQUIRE(results.size() == 3);
+                check_same(results[flagged], expected_flagged);
+                check_same(results[large], expected_large);
+                check_same(results[labels], expected_labels);
+            }
+        }
+    }
+
+    SUBCASE("filter-only query set") {
+        utility::CsvQuerySet filters;
+        filters.Add(Col("flag") == 1, id_spec);
+        filters.Add(category_b, label_specs);
+        const auto results = utility::CsvReader(tmp.Str(), MmapOptions(1)).ReadQueries(filters);
+        check_same(results[0], expected_flagged);
+        check_same(results[1], expected_labels);
+    }
+
+    SUBCASE("empty query set and unknown column") {
+        CHECK(reference.ReadQueries(utility::CsvQuerySet{}).empty());
+        utility::CsvQuerySet invalid;
+        invalid.Add(Col("missing") == 1, id_spec);
+        CHECK_THROWS_AS(reference.ReadQueries(invalid), std::invalid_argument);
+    }
+}
+
+// ──────────────────────────────────────────────────────────────
+// 集計
+// ──────────────────────────────────────────────────────────────
+
+TEST_CASE("CsvReader: ReadAggregates and ReadHistogram") {
+    using utility::Col;
+    const TempFile tmp("test_csv_wrapper_aggregate.csv", MakeCsv(600));
+
+    // 参照値: ReadColumns の結果から直接計算する
+    const utility::CsvReader reference(tmp.Str());
+    const auto rows = reference.ReadColumns(
+        FlagViewIsOne, {{"category", utility::ColumnType::kString}, {"value", utility::ColumnType::kDouble}}
+    );
+    REQUIRE(rows.RowCount() == 200);
+
+    for (const auto backend : {utility::CsvBackend::kCsvParser, utility::CsvBackend::kMmap}) {
+        for (const unsigned int num_threads : {1U, 4U}) {
+            utility::CsvReaderOptions options = ParallelOptions(num_threads);
+            options.backend = backend;
+            const utility::CsvReader reader(tmp.Str(), options);
+
+            const auto result = reader.ReadAggregates(Col("flag") == 1, "category", {"value", "id"});
+            // flag == 1 は i % 3 == 0 の行なので category はすべて "A"
+            REQUIRE(result.GroupCount() == 1);
+            CHECK(result.Key(0) == "A");
+            CHECK(result.RowCount(0) == 200);
+            const auto &value = result.Stats("A", "value");
+            double sum = 0.0;
+            for (double v : rows.DoubleColumn(1)) {
+                sum += v;
+            }
+            CHECK(value.count == 200);
+            CHECK(value.sum == doctest::Approx(sum));
+            CHECK(value.min == 0.0);
+            CHECK(value.max == doctest::Approx(298.5));
+            CHECK(result.Stats(0, 1).Mean() == doctest::Approx(298.5));
+
+            // グループは最初に現れた順
+            const auto all = reader.ReadAggregates([](const utility::CsvRowView &) { return true; }, "category", {});
+            REQUIRE(all.GroupCount() == 3);
+            CHECK(all.Key(0) == "A");
+            CHECK(all.Key(1) == "B");
+            CHECK(all.Key(2) == "C");
+            CHECK(all.RowCount(1) == 200);
+            CHECK(all.Find("D") == -1);
+
+            const auto total = reader.ReadAggregates(FlagViewIsOne, "", {"value"});
+            REQUIRE(total.GroupCount() == 1);
+            CHECK(total.Stats(0, 0).sum == doctest::Approx(sum));
+
+            const auto histogram = reader.ReadHistogram(Col("flag") == 1, "value", 0.0, 200.0, 4);
+            CHECK(histogram.Counts() == std::vector<std::uint64_t>{34, 33, 33, 34});
+            CHECK(histogram.Underflow() == 0);
+            CHECK(histogram.Overflow() == 66);
+            CHECK(histogram.BinLower(1) == 50.0);
+        }
+    }
+
+    CHECK_THROWS_AS(reference.ReadAggregates(FlagViewIsOne, "missing", {"value"}), std::invalid_argument);
+    CHECK_THROWS_AS(reference.ReadAggregates(FlagViewIsOne, "", {"category"}), std::runtime_error);
+    CHECK_THROWS_AS(reference.ReadHistogram(FlagViewIsOne, "value", 1.0, 1.0, 4), std::invalid_argument);
+}
+
+// ──────────────────────────────────────────────────────────────
+// 辞書符号化列
+// ──────────────────────────────────────────────────────────────
+
+TEST_CASE("CsvReader: dictionary-encoded column matches string column") {
+    const TempFile tmp("test_csv_wrapper_dictionary.csv", MakeCsv(600));
+    const TempFile cache_file("test_csv_wrapper_dictionary.csv.colcache", "");
+    std::filesystem::remove(cache_file.path);
+    const auto expected = utility::CsvReader(tmp.Str()).ReadColumns(
+        [](const csv::CSVRow &) { return true; }, {{"category", utility::ColumnType::kString}}
+    );
+    REQUIRE(expected.RowCount() == 600);
+
+    for (const auto backend : {utility::CsvBackend::kCsvParser, utility::CsvBackend::kMmap}) {
+        for (const bool column_cache : {false, true}) {
+            for (const unsigned int num_threads : {1U, 4U}) {
+                utility::CsvReaderOptions options = ParallelOptions(num_threads);
+                options.backend = backend;
+                options.column_cache = column_cache;
+                const auto table = utility::CsvReader(tmp.Str(), options)
+                                       .ReadColumns(
+                                           [](const utility::CsvRowView &) { return true; },
+                                           {{"category", utility::ColumnType::kDictionary}}
+                                       );
+                const auto &category = table.DictionaryColumn("category");
+                REQUIRE(category.Size() == expected.RowCount());
+                // 並列スキャンで範囲ごとに作った辞書も、結合後は出現順の 3 種類になる
+                CHECK(category.Values() == std::vector<std::string_view>{"A", "B", "C"});
+                for (std::size_t i = 0; i < category.Size(); ++i) {
+                    CHECK(category[i] == expected.StringColumn(0)[i]);
+                }
+            }
+        }
+    }
+}
+
+// ──────────────────────────────────────────────────────────────
+// 列単位の CSV 書き出し
+// ──────────────────────────────────────────────────────────────
+
+static std::string ReadFile(const std::filesystem::path &path) {
+    std::ifstream ifs(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>()};
+}
+
+TEST_CASE("CsvWriter: round trip through CsvReader") {
+    const TempFile tmp("test_csv_writer_round_trip.csv", "");
+    constexpr std::size_t kRows = 1000;
+    std::vector<std::int64_t> ids(kRows);
+    std::vector<std::int32_t> steps(kRows);
+    std::vector<double> values(kRows);
+    std::vector<std::string> labels(kRows);
+    for (std::size_t i = 0; i < kRows; ++i) {
+        ids[i] = static_cast<std::int64_t>(i) * 1'000'000'007 - 500'000'000'000;
+        steps[i] = static_cast<std::int32_t>(i) - 100;
+        values[i] = 1.0 / static_cast<double>(i + 3) * (i % 2 == 0 ? 1.0 : -1e10);
+        labels[i] = i % 3 == 0 ? "plain" : (i % 3 == 1 ? "with,comma" : "say \"hi\"\nnext");
+    }
+
+    std::string single;
+    for (const unsigned int threads : {1U, 4U}) {
+        utility::CsvWriterOptions options;
+        options.threads = threads;
+        options.block_rows = 64;   // 並列整形で複数の組に分かれるように小さくする
+        options.buffer_bytes = 1024;
+        {
+            utility::CsvWriter writer(tmp.Str(), {"id", "step", "value", "label"}, options);
+            // 2 回に分けて渡しても 1 つの表として続けて書かれる
+            writer.WriteColumns({{ids.data(), 600}, {steps.data(), 600}, {values.data(), 600}, {labels.data(), 600}});
+            writer.WriteColumns(
+                {{ids.data() + 600, kRows - 600},
+                 {steps.data() + 600, kRows - 600},
+                 {values.data() + 600, kRows - 600},
+                 {labels.data() + 600, kRows - 600}}
+            );
+            CHECK(writer.RowsWritten() == kRows);
+            writer.Close();
+        }
+        // スレッド数によらず同じバイト列になる
+        const std::string content = ReadFile(tmp.path);
+        if (threads == 1) {
+            single = content;
+        } else {
+            CHECK(content == single);
+        }
+
+        // クォート内の改行と "" エスケープも内蔵トークナイザで元どおりに読める
+        const auto table = utility::CsvReader(tmp.Str()).ReadRange(
+            0,
+            kRows,
+            {{"id", utility::ColumnType::kInt64},
+             {"step", utility::ColumnType::kInt64},
+             {"value", utility::ColumnType::kDouble},
+             {"label", utility::ColumnType::kString}}
+        );
+        REQUIRE(table.RowCount() == kRows);
+        for (std::size_t i = 0; i < kRows; ++i) {
+            CHECK(table.Int64Column(0)[i] == ids[i]);
+            CHECK(table.Int64Column(1)[i] == steps[i]);
+            CHECK(table.DoubleColumn(2)[i] == values[i]); // 最短表記でも値は元に戻る
+            CHECK(table.StringColumn(3)[i] == labels[i]);
+        }
+    }
+
+    SUBCASE("empty fields in a single-column table are not read as blank lines") {
+        const std::vector<std::string> notes = {"a", "", "b", ""};
+        {
+            utility::CsvWriter writer(tmp.Str(), {"note"});
+            writer.WriteColumns({notes});
+            writer.Close();
+        }
+        CHECK(ReadFile(tmp.path) == "note\na\n\"\"\nb\n\"\"\n");
+        const auto table =
+            utility::CsvReader(tmp.Str()).ReadRange(0, notes.size(), {{"note", utility::ColumnType::kString}});
+        REQUIRE(table.RowCount() == notes.size());
+        for (std::size_t i = 0; i < notes.size(); ++i) {
+            CHECK(table.StringColumn(0)[i] == notes[i]);
+        }
+    }
+}
+
+TEST_CASE("OutputFile: Close writes pending bytes first") {
+    const TempFile tmp("test_output_file.txt", "");
+    utility::OutputFile file(tmp.Str());
+    file.Write("ab", 2);
+    file.Close("cd", 2);
+    CHECK_FALSE(file.IsOpen());
+    file.Close("ignored", 7); // 2 回目以降は何もしない
+    CHECK(ReadFile(tmp.path) == "abcd");
+
+    // 書き込みに失敗してもファイルは閉じ、書き込みのエラーを報告する
+    if (std::filesystem::exists("/dev/full")) {
+        utility::OutputFile full("/dev/full");
+        CHECK_THROWS_AS(full.Close("x", 1), std::runtime_error);
+        CHECK_FALSE(full.IsOpen());
+    }
+}
+
+TEST_CASE("CsvWriter: fixed precision, WriteTable and errors") {
+    const TempFile tmp("test_csv_writer_table.csv", "");
+    {
+        const std::vector<double> values{0.5, -1.25, 1e-9};
+        utility::CsvWriter writer(tmp.Str(), {"value"});
+        writer.WriteColumns({utility::CsvColumnView(values, 3)});
+        CHECK_THROWS_AS(
+            utility::CsvColumnView(values, utility::CsvColumnView::kMaxPrecision + 1), std::invalid_argument
+        );
+    }
+    CHECK(ReadFile(tmp.path) == "value\n0.500\n-1.250\n0.000\n");
+
+    const TempFile source("test_csv_writer_source.csv", MakeCsv(50));
+    const auto table = utility::CsvReader(source.Str()).ReadColumns(
+        [](const utility::CsvRowView &) { return true; },
+        {{"id", utility::ColumnType::kInt64},
+         {"category", utility::ColumnType::kDictionary},
+         {"value", utility::ColumnType::kDouble},
+         {"flag", utility::ColumnType::kString}}
+    );
+    {
+        utility::CsvWriter writer(tmp.Str(), {"id", "category", "value", "flag"});
+        writer.WriteTable(table);
+    }
+    const auto copy = utility::CsvReader(tmp.Str()).ReadColumns(
+        [](const utility::CsvRowView &) { return true; },
+        {{"id", utility::ColumnType::kInt64},
+         {"category", utility::ColumnType::kString},
+         {"value", utility::ColumnType::kDouble},
+         {"flag", utility::ColumnType::kString}}
+    );
+    REQUIRE(copy.RowCount() == table.RowCount());
+    for (std::size_t i = 0; i < copy.RowCount(); ++i) {
+        CHECK(copy.Int64Column(0)[i] == table.Int64Column(0)[i]);
+        CHECK(copy.StringColumn(1)[i] == table.DictionaryColumn(1)[i]);
+        CHECK(copy.DoubleColumn(2)[i] == table.DoubleColumn(2)[i]);
+        CHECK(copy.StringColumn(3)[i] == table.StringColumn(3)[i]);
+    }
+
+    utility::CsvWriter writer(tmp.Str(), {"a", "b"});
+    const std::vector<std::int64_t> two{1, 2};
+    const std::vector<std::int64_t> three{1, 2, 3};
+    CHECK_THROWS_AS(writer.WriteColumns({two}), std::invalid_argument);
+    CHECK_THROWS_AS(writer.WriteColumns({two, three}), std::invalid_argument);
+    writer.Close();
+    CHECK_THROWS_AS(writer.WriteColumns({two, two}), std::runtime_error);
+    CHECK_THROWS_AS(utility::CsvWriter("/nonexistent-dir/out.csv", {"a"}), std::runtime_error);
+
+    // 並列整形中の書き込みエラーも呼び出し元に例外で返る
+    if (std::filesystem::exists("/dev/full")) {
+        utility::CsvWriterOptions options;
+        options.threads = 4;
+        options.block_rows = 16;
+        options.buffer_bytes = 64;
+        utility::CsvWriter full("/dev/full", {"a"}, options);
+        const std::vector<std::int64_t> many(1000, 7);
+        CHECK_THROWS_AS(full.WriteColumns({many}), std::runtime_error);
+    }
+}
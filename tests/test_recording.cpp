@@ -0,0 +1,225 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <doctest/doctest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "support/temp_file.hpp"
+#include "template_cli_cpp/recording/binary_recorder.hpp"
+#include "template_cli_cpp/recording/buffered_recorder.hpp"
+#include "template_cli_cpp/recording/recorder_factory.hpp"
+
+// ファイルを行ごとに読むヘルパー
+static std::vector<std::string> ReadLines(const std::filesystem::path &path) {
+    std::ifstream ifs(path);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(ifs, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+// ──────────────────────────────────────────────────────────────
+// BufferedRecorder
+// ──────────────────────────────────────────────────────────────
+
+TEST_CASE("BufferedRecorder: header and records in order after Flush") {
+    const TempFile tmp("test_buffered_recorder.csv", "");
+    {
+        // 小さいキューと出力バッファで、満杯時の待機と途中の write も通す
+        recording::BufferedRecorderOptions options;
+        options.queue_capacity = 3;
+        options.buffer_bytes = 32;
+        auto rec = recording::RecorderFactory::MakeBufferedCsvFile(tmp.Str(), "step,value", options);
+        CHECK(rec->QueueCapacity() == 4);
+        CHECK_FALSE(rec->IsEnabled());
+        rec->Write("{},{}", -1, "ignored");
+        rec->Enable();
+        for (int step = 0; step < 200; ++step) {
+            rec->Write("{},{:.1f}", step, step * 0.5);
+        }
+        rec->Flush();
+
+        const auto lines = ReadLines(tmp.path);
+        REQUIRE(lines.size() == 201);
+        CHECK(lines[0] == "step,value");
+        CHECK(lines[1] == "0,0.0");
+        CHECK(lines[200] == "199,99.5");
+        CHECK(rec->DroppedCount() == 0);
+
+        rec->Disable();
+        rec->Write("{}", "ignored");
+        rec->Enable();
+        rec->Output("last");
+    }
+    // デストラクタで残りを書き出す
+    const auto lines = ReadLines(tmp.path);
+    REQUIRE(lines.size() == 202);
+    CHECK(lines[201] == "last");
+}
+
+TEST_CASE("BufferedRecorder: concurrent producers keep per-thread order") {
+    const TempFile tmp("test_buffered_recorder_mt.txt", "");
+    constexpr int kThreads = 4;
+    constexpr int kRecords = 2000;
+    {
+        recording::BufferedRecorderOptions options;
+        options.queue_capacity = 16;
+        recording::BufferedRecorder rec(tmp.Str(), options);
+        rec.Enable();
+        std::vector<std::thread> producers;
+        for (int t = 0; t < kThreads; ++t) {
+            producers.emplace_back([&rec, t] {
+                for (int i = 0; i < kRecords; ++i) {
+                    rec.Write("{} {}", t, i);
+                }
+            });
+        }
+        for (auto &producer : producers) {
+            producer.join();
+        }
+        rec.Flush();
+    }
+    const auto lines = ReadLines(tmp.path);
+    REQUIRE(lines.size() == static_cast<std::size_t>(kThreads * kRecords));
+    std::vector<int> next(kThreads, 0);
+    bool ordered = true;
+    for (const auto &line : lines) {
+        const auto space = line.find(' ');
+        const int t = std::stoi(line.substr(0, space));
+        const int i = std::stoi(line.substr(space + 1));
+        ordered = ordered && i == next[static_cast<std::size_t>(t)];
+        next[static_cast<std::size_t>(t)] = i + 1;
+    }
+    CHECK(ordered);
+}
+
+TEST_CASE("BufferedRecorder: kDrop counts records that did not fit") {
+    const TempFile tmp("test_buffered_recorder_drop.txt", "");
+    constexpr std::size_t kRecords = 20000;
+    std::uint64_t dropped = 0;
+    {
+        recording::BufferedRecorderOptions options;
+        options.queue_capacity = 2;
+        options.overflow = recording::OverflowPolicy::kDrop;
+        recording::BufferedRecorder rec(tmp.Str(), options);
+        rec.Enable();
+        for (std::size_t i = 0; i < kRecords; ++i) {
+            rec.Write("{}", i);
+        }
+        rec.Flush();
+        dropped = rec.DroppedCount();
+    }
+    // 書かれたレコードと捨てたレコードで全件になり、書かれた分は昇順に並ぶ
+    const auto lines = ReadLines(tmp.path);
+    CHECK(lines.size() + dropped == kRecords);
+    bool ascending = true;
+    for (std::size_t i = 1; i < lines.size(); ++i) {
+        ascending = ascending && std::stoul(lines[i - 1]) < std::stoul(lines[i]);
+    }
+    CHECK(ascending);
+}
+
+TEST_CASE("BufferedRecorder: bad path throws") {
+    CHECK_THROWS_AS(recording::BufferedRecorder("/nonexistent_dir_for_test/out.txt"), std::runtime_error);
+}
+
+// ──────────────────────────────────────────────────────────────
+// BinaryRecorder / BinaryRecordReader
+// ──────────────────────────────────────────────────────────────
+
+TEST_CASE("BinaryRecorder: round trip through BinaryRecordReader") {
+    const TempFile tmp("test_binary_recorder.bin", "");
+    constexpr int kRows = 1000;
+    {
+        // 3 行ごとのブロック + Flush() による途中までのブロックを混ぜる
+        auto rec = recording::RecorderFactory::MakeBinaryFile(
+            tmp.Str(),
+            {{"step", utility::ColumnType::kInt64},
+             {"energy", utility::ColumnType::kDouble},
+             {"count", utility::ColumnType::kInt64}},
+            3
+        );
+        rec->Append(-1, -1.0, -1); // disabled の間は記録しない
+        rec->Enable();
+        for (int step = 0; step < kRows; ++step) {
+            rec->Append(step, step * 0.25, std::uint32_t{7} * static_cast<std::uint32_t>(step));
+            if (step == 500) {
+                rec->Flush();
+            }
+        }
+        CHECK(rec->RowsWritten() == kRows);
+        rec->Close();
+    }
+
+    const recording::BinaryRecordReader reader(tmp.Str());
+    REQUIRE(reader.Schema().size() == 3);
+    CHECK(reader.Schema()[1].name == "energy");
+    CHECK(reader.Schema()[1].type == utility::ColumnType::kDouble);
+    CHECK(reader.RowCount() == kRows);
+    CHECK(reader.BlockCount() > 1);
+    CHECK(reader.BlockRows(0) == 3);
+    CHECK(reader.DoubleBlock(1, 1)[0] == doctest::Approx(0.75));
+    CHECK_THROWS_AS(reader.Int64Block(0, 1), std::invalid_argument);
+
+    const utility::ColumnTable table = reader.ReadColumns();
+    REQUIRE(table.RowCount() == kRows);
+    const auto &steps = table.Int64Column("step");
+    const auto &energy = table.DoubleColumn("energy");
+    const auto &count = table.Int64Column("count");
+    bool match = true;
+    for (int step = 0; step < kRows; ++step) {
+        const auto row = static_cast<std::size_t>(step);
+        match = match && steps[row] == step && energy[row] == step * 0.25 && count[row] == 7 * step;
+    }
+    CHECK(match);
+}
+
+TEST_CASE("BinaryRecorder: integers convert to double columns, doubles rejected for int64 columns") {
+    const TempFile tmp("test_binary_recorder_types.bin", "");
+    {
+        recording::BinaryRecorder rec(
+            tmp.Str(), {{"i", utility::ColumnType::kInt64}, {"d", utility::ColumnType::kDouble}}
+        );
+        rec.Enable();
+        rec.Append(std::int64_t{-5'000'000'000}, 3);
+        CHECK_THROWS_AS(rec.Append(1.5, 2.0), std::invalid_argument);
+        CHECK_THROWS_AS(rec.Append(1), std::invalid_argument);
+    }
+    const auto table = recording::BinaryRecordReader(tmp.Str()).ReadColumns();
+    REQUIRE(table.RowCount() == 1);
+    CHECK(table.Int64Column("i")[0] == -5'000'000'000);
+    CHECK(table.DoubleColumn("d")[0] == 3.0);
+}
+
+TEST_CASE("BinaryRecorder: invalid schema and malformed files") {
+    const TempFile tmp("test_binary_recorder_bad.bin", "");
+    CHECK_THROWS_AS(recording::BinaryRecorder(tmp.Str(), {}), std::invalid_argument);
+    CHECK_THROWS_AS(
+        recording::BinaryRecorder(tmp.Str(), {{"s", utility::ColumnType::kString}}), std::invalid_argument
+    );
+
+    {
+        std::ofstream ofs(tmp.path, std::ios::binary);
+        ofs << "step,value\n1,2\n";
+    }
+    CHECK_THROWS_AS(recording::BinaryRecordReader(tmp.Str()), std::runtime_error);
+
+    {
+        recording::BinaryRecorder rec(tmp.Str(), {{"x", utility::ColumnType::kDouble}});
+        rec.Enable();
+        rec.Append(1.0);
+        rec.Append(2.0);
+    }
+    // 最後のブロックを切り詰める
+    std::filesystem::resize_file(tmp.path, std::filesystem::file_size(tmp.path) - 4);
+    CHECK_THROWS_AS(recording::BinaryRecordReader(tmp.Str()), std::runtime_error);
+}
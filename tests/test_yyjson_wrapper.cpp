@@ -2,16 +2,42 @@
 
 #include <doctest/doctest.h>
 
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 #include <nlohmann/json.hpp>
 
+#include "support/temp_file.hpp"
+#include "template_cli_cpp/utility/json_lines_reader.hpp"
+#include "template_cli_cpp/utility/json_lines_writer.hpp"
 #include "template_cli_cpp/utility/yyjson_wrapper.hpp"
 
 // JSON文字列をパースして検証するヘルパー
 static nlohmann::json Parse(const std::string &s) { return nlohmann::json::parse(s); }
 
+// 文字列をそのままファイルに書くヘルパー
+static void WriteFile(const std::filesystem::path &path, const std::string &content) {
+    std::ofstream ofs(path, std::ios::binary);
+    ofs << content;
+}
+
+// ファイルを行ごとに読むヘルパー
+static std::vector<std::string> ReadLines(const std::filesystem::path &path) {
+    std::ifstream ifs(path);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(ifs, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
 // ──────────────────────────────────────────────────────────────
 // フラットオブジェクト
 // ──────────────────────────────────────────────────────────────
@@ -273,3 +299,348 @@ TEST_CASE("JsonBuilder: move semantics") {
     CHECK(j["val"] == 10);
     // ムーブ後の b1 は空ドキュメントと同等（デストラクタが安全に動く）
 }
+
+// ──────────────────────────────────────────────────────────────
+// アリーナ
+// ──────────────────────────────────────────────────────────────
+
+TEST_CASE("JsonBuilder: arena-backed builder matches default builder") {
+    utility::JsonArena arena;
+    utility::JsonBuilder with_arena(arena);
+    utility::JsonBuilder plain;
+    for (auto *b : {&with_arena, &plain}) {
+        b->Add("name", std::string("demo"));
+        b->Add("version", 1);
+        auto meta = b->AddNested("meta");
+        b->AddToNested(meta, "debug", false);
+        b->Add("values", std::vector<int>{1, 2, 3});
+    }
+    CHECK(with_arena.Serialize() == plain.Serialize());
+
+    std::string out;
+    const std::size_t written = with_arena.SerializeTo(out);
+    CHECK(written == out.size());
+    CHECK(out == plain.Serialize());
+}
+
+TEST_CASE("JsonBuilder: SerializeTo appends") {
+    utility::JsonBuilder b;
+    b.Add("x", 1);
+    std::string out = "prefix ";
+    const std::size_t written = b.SerializeTo(out);
+    CHECK(out == "prefix {\"x\":1}");
+    CHECK(written == out.size() - 7);
+
+    // 書き出し用の一時バッファを呼び出し側のアリーナから確保する（確保はその場で巻き戻る）
+    utility::JsonArena scratch(1024);
+    for (int i = 0; i < 10; ++i) {
+        out.clear();
+        CHECK(b.SerializeTo(out, scratch) == out.size());
+        CHECK(out == "{\"x\":1}");
+    }
+    CHECK(scratch.BlockAllocations() == 1);
+}
+
+TEST_CASE("JsonBuilder: Clear reuses the arena") {
+    utility::JsonArena arena(1024);
+    utility::JsonBuilder b(arena);
+    std::string line;
+    std::size_t blocks_after_first = 0;
+    for (int step = 0; step < 100; ++step) {
+        b.Clear();
+        CHECK(b.Empty());
+        b.Add("step", step);
+        b.Add("value", step * 0.5);
+        b.Add("label", std::string(100, 'a'));
+        line.clear();
+        b.SerializeTo(line);
+        auto j = Parse(line);
+        CHECK(j["step"] == step);
+        CHECK_FALSE(j.contains("x"));
+        if (step == 0) {
+            blocks_after_first = arena.BlockAllocations();
+        }
+    }
+    // 同じ形のレコードの繰り返しではブロックが増えない
+    CHECK(arena.BlockAllocations() == blocks_after_first);
+
+    // ブロックより大きいレコードも書ける（必要な大きさのブロックを追加する）
+    b.Clear();
+    b.Add("big", std::string(10'000, 'z'));
+    line.clear();
+    b.SerializeTo(line);
+    CHECK(Parse(line)["big"].get<std::string>().size() == 10'000);
+    CHECK(arena.Capacity() >= 10'000);
+}
+
+// ──────────────────────────────────────────────────────────────
+// 構造体のスキーマ（JsonField）による一括追加
+// ──────────────────────────────────────────────────────────────
+
+struct StepInputs {
+    double dt;
+    std::uint32_t seed;
+};
+
+struct StepRecord {
+    int step;
+    std::int64_t ticks;
+    std::uint64_t checksum;
+    bool converged;
+    std::string label;
+    std::vector<double> forces;
+    std::vector<std::int64_t> ids;
+    std::array<float, 2> range;
+    std::vector<bool> flags;
+};
+
+static constexpr auto kStepInputsFields = std::make_tuple(
+    utility::JsonField{"dt", &StepInputs::dt},
+    utility::JsonField{"seed", &StepInputs::seed}
+);
+
+static constexpr auto kStepRecordFields = std::make_tuple(
+    utility::JsonField{"step", &StepRecord::step},
+    utility::JsonField{"ticks", &StepRecord::ticks},
+    utility::JsonField{"checksum", &StepRecord::checksum},
+    utility::JsonField{"converged", &StepRecord::converged},
+    utility::JsonField{"label", &StepRecord::label},
+    utility::JsonField{"forces", &StepRecord::forces},
+    utility::JsonField{"ids", &StepRecord::ids},
+    utility::JsonField{"range", &StepRecord::range},
+    utility::JsonField{"flags", &StepRecord::flags}
+);
+
+TEST_CASE("JsonBuilder: AddFields serializes a described struct") {
+    StepRecord record{
+        7,
+        -9'000'000'000,
+        18'446'744'073'709'551'615ULL,
+        true,
+        "run \"a\"",
+        {0.5, -1.25},
+        {1, -2, 3},
+        {0.5F, 2.0F},
+        {true, false},
+    };
+    const StepInputs inputs{0.001, 42};
+
+    utility::JsonBuilder b;
+    b.AddFields(record, kStepRecordFields);
+    b.AddFields(b.AddNested("inputs"), inputs, kStepInputsFields);
+    record.label = "changed"; // 文字列値はコピーされている
+    auto j = Parse(b.Serialize());
+
+    CHECK(b.Size() == 10);
+    CHECK(j["step"] == 7);
+    CHECK(j["ticks"] == -9'000'000'000);
+    CHECK(j["checksum"].get<std::uint64_t>() == 18'446'744'073'709'551'615ULL);
+    CHECK(j["converged"] == true);
+    CHECK(j["label"] == "run \"a\"");
+    CHECK(j["forces"] == nlohmann::json::array({0.5, -1.25}));
+    CHECK(j["ids"] == nlohmann::json::array({1, -2, 3}));
+    CHECK(j["range"] == nlohmann::json::array({0.5, 2.0}));
+    CHECK(j["flags"] == nlohmann::json::array({true, false}));
+    CHECK(j["inputs"]["dt"] == 0.001);
+    CHECK(j["inputs"]["seed"] == 42);
+
+    // キーの順序はスキーマの順（nlohmann::json はキーを辞書順に並べ替えるため文字列で確認する）
+    const std::string text = b.Serialize();
+    CHECK(text.find("\"step\"") < text.find("\"ticks\""));
+    CHECK(text.find("\"ticks\"") < text.find("\"flags\""));
+}
+
+TEST_CASE("JsonBuilder: Add accepts 64-bit integers and numeric vectors") {
+    utility::JsonBuilder b;
+    b.Add("i64", std::int64_t{-5'000'000'000});
+    b.Add("u64", std::uint64_t{10'000'000'000ULL});
+    b.Add("doubles", std::vector<double>{1.5, 2.5});
+    b.Add("i64s", std::vector<std::int64_t>{-1, 5'000'000'000});
+    b.Add("u64s", std::vector<std::uint64_t>{0, 1});
+    b.Add("floats", std::vector<float>{0.25F});
+    b.Add("empty", std::vector<double>{});
+    b.Add("view", std::string_view("abc").substr(1));
+    auto j = Parse(b.Serialize());
+    CHECK(j["i64"] == -5'000'000'000);
+    CHECK(j["u64"] == 10'000'000'000ULL);
+    CHECK(j["doubles"] == nlohmann::json::array({1.5, 2.5}));
+    CHECK(j["i64s"] == nlohmann::json::array({-1, 5'000'000'000}));
+    CHECK(j["u64s"] == nlohmann::json::array({0, 1}));
+    CHECK(j["floats"] == nlohmann::json::array({0.25}));
+    CHECK(j["empty"] == nlohmann::json::array());
+    CHECK(j["view"] == "bc");
+}
+
+TEST_CASE("JsonBuilder: Add accepts JsonArrayView over contiguous numbers") {
+    const std::vector<double> state{0.5, -1.25, 3.0};
+    const std::array<std::uint64_t, 2> counts{7, 8};
+    const std::int64_t raw[] = {-3, 4, 5};
+    const std::vector<std::int16_t> small{-2, 300};
+    const std::vector<std::uint8_t> bytes{0, 255};
+    const std::vector<float> partial{1.5F, 2.5F, 3.5F};
+
+    utility::JsonBuilder b;
+    b.Add("state", utility::JsonArrayView(state));
+    b.Add("counts", utility::JsonArrayView(counts));
+    b.Add("raw", utility::JsonArrayView(raw, 2));
+    b.Add("small", utility::JsonArrayView(small));
+    b.Add("bytes", utility::JsonArrayView(bytes));
+    b.Add("partial", utility::JsonArrayView<float>(partial.data() + 1, 2));
+    b.Add("empty", utility::JsonArrayView<double>(nullptr, 0));
+    auto nested = b.AddNested("nested");
+    b.AddToNested(nested, "state", utility::JsonArrayView(state));
+    auto j = Parse(b.Serialize());
+    CHECK(j["state"] == nlohmann::json::array({0.5, -1.25, 3.0}));
+    CHECK(j["counts"] == nlohmann::json::array({7, 8}));
+    CHECK(j["raw"] == nlohmann::json::array({-3, 4}));
+    CHECK(j["small"] == nlohmann::json::array({-2, 300}));
+    CHECK(j["bytes"] == nlohmann::json::array({0, 255}));
+    CHECK(j["partial"] == nlohmann::json::array({2.5, 3.5}));
+    CHECK(j["empty"] == nlohmann::json::array());
+    CHECK(j["nested"]["state"] == j["state"]);
+}
+
+// ──────────────────────────────────────────────────────────────
+// JSON Lines 出力
+// ──────────────────────────────────────────────────────────────
+
+TEST_CASE("JsonLinesWriter: one document per line") {
+    const TempFile tmp("test_json_lines_writer.jsonl", "");
+    std::vector<std::string> expected;
+    {
+        // 小さいバッファで途中の write も通す
+        utility::JsonLinesWriter writer(tmp.Str(), 64);
+        utility::JsonArena arena;
+        utility::JsonBuilder b(arena);
+        for (int step = 0; step < 50; ++step) {
+            b.Clear();
+            b.Add("step", step);
+            b.Add("label", std::string("s") + std::to_string(step));
+            writer.Write(b);
+            expected.push_back(b.Serialize());
+        }
+
+        std::vector<utility::JsonBuilder> batch(3);
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            batch[i].Add("batch", static_cast<int>(i));
+            expected.push_back(batch[i].Serialize());
+        }
+        writer.WriteBatch(batch);
+
+        CHECK(writer.LinesWritten() == expected.size());
+        std::size_t bytes = 0;
+        for (const auto &line : expected) {
+            bytes += line.size() + 1;
+        }
+        CHECK(writer.BytesWritten() == bytes);
+        writer.Close();
+        CHECK_THROWS_AS(writer.Write(b), std::runtime_error);
+    }
+
+    const auto lines = ReadLines(tmp.path);
+    CHECK(lines == expected);
+    CHECK(Parse(lines[49])["label"] == "s49");
+    CHECK(Parse(lines.back())["batch"] == 2);
+}
+
+TEST_CASE("JsonLinesWriter: destructor flushes, bad path throws") {
+    const TempFile tmp("test_json_lines_writer_dtor.jsonl", "");
+    {
+        utility::JsonLinesWriter writer(tmp.Str());
+        utility::JsonBuilder b;
+        b.Add("x", 1);
+        writer.Write(b);
+    }
+    CHECK(ReadLines(tmp.path) == std::vector<std::string>{"{\"x\":1}"});
+
+    CHECK_THROWS_AS(utility::JsonLinesWriter("/nonexistent-dir/out.jsonl"), std::runtime_error);
+}
+
+TEST_CASE("JsonLinesReader: projects JSON pointers into typed columns") {
+    const TempFile tmp("test_json_lines_reader.jsonl", "");
+    constexpr int kRecords = 500;
+    {
+        utility::JsonLinesWriter writer(tmp.Str());
+        utility::JsonArena arena;
+        utility::JsonBuilder b(arena);
+        for (int step = 0; step < kRecords; ++step) {
+            b.Clear();
+            b.Add("step", step);
+            b.Add("converged", step % 2 == 0);
+            b.Add("label", std::string(step % 3 == 0 ? "a\"b" : "c"));
+            auto results = b.AddNested("results");
+            b.AddToNested(results, "value", step * 0.5);
+            writer.Write(b);
+        }
+    }
+    const std::vector<utility::ColumnSpec> specs = {
+        {"/step", utility::ColumnType::kInt64},
+        {"/results/value", utility::ColumnType::kDouble},
+        {"/converged", utility::ColumnType::kInt64},
+        {"/label", utility::ColumnType::kString},
+        {"/label", utility::ColumnType::kDictionary},
+    };
+
+    for (const unsigned int threads : {1U, 3U}) {
+        utility::JsonLinesReaderOptions options;
+        options.num_threads = threads;
+        options.range_bytes = 1024; // 範囲を細かく分けて境界をまたぐ処理も通す
+        const utility::JsonLinesReader reader(tmp.Str(), options);
+        const utility::ColumnTable table = reader.ReadColumns(specs);
+        REQUIRE(table.RowCount() == kRecords);
+        const auto &steps = table.Int64Column(0);
+        const auto &values = table.DoubleColumn(1);
+        const auto &converged = table.Int64Column(2);
+        const auto &labels = table.StringColumn(3);
+        const auto &dictionary = table.DictionaryColumn(4);
+        for (int row = 0; row < kRecords; ++row) {
+            const auto i = static_cast<std::size_t>(row);
+            CHECK(steps[i] == row);
+            CHECK(values[i] == row * 0.5);
+            CHECK(converged[i] == (row % 2 == 0 ? 1 : 0));
+            CHECK(labels[i] == (row % 3 == 0 ? "a\"b" : "c"));
+            CHECK(dictionary[i] == labels[i]);
+        }
+    }
+}
+
+TEST_CASE("JsonLinesReader: blank lines, missing values and errors") {
+    const TempFile tmp(
+        "test_json_lines_reader_errors.jsonl", "{\"x\":1,\"y\":2.5}\n\n  \r\n{\"x\":-2}\n{\"x\":3,\"y\":null}"
+    );
+    const std::vector<utility::ColumnSpec> specs = {
+        {"/x", utility::ColumnType::kInt64},
+        {"/y", utility::ColumnType::kDouble},
+    };
+
+    CHECK_THROWS_AS(utility::JsonLinesReader(tmp.Str()).ReadColumns(specs), std::runtime_error);
+
+    utility::JsonLinesReaderOptions options;
+    options.allow_missing = true;
+    const utility::ColumnTable table = utility::JsonLinesReader(tmp.Str(), options).ReadColumns(specs);
+    REQUIRE(table.RowCount() == 3);
+    CHECK(table.Int64Column(0)[1] == -2);
+    CHECK(table.DoubleColumn(1)[0] == 2.5);
+    CHECK(std::isnan(table.DoubleColumn(1)[1]));
+    CHECK(std::isnan(table.DoubleColumn(1)[2]));
+
+    // 型の合わない値・JSON Pointer の形式・不正な行
+    CHECK_THROWS_AS(
+        utility::JsonLinesReader(tmp.Str(), options).ReadColumns({{"/x", utility::ColumnType::kString}}),
+        std::runtime_error
+    );
+    CHECK_THROWS_AS(
+        utility::JsonLinesReader(tmp.Str()).ReadColumns({{"x", utility::ColumnType::kInt64}}),
+        std::invalid_argument
+    );
+    WriteFile(tmp.path, "{\"x\":1}\n{\"x\":\n");
+    CHECK_THROWS_AS(
+        utility::JsonLinesReader(tmp.Str()).ReadColumns({{"/x", utility::ColumnType::kInt64}}), std::runtime_error
+    );
+
+    // 存在しないファイル
+    std::filesystem::remove(tmp.path);
+    CHECK_THROWS_AS(
+        utility::JsonLinesReader(tmp.Str()).ReadColumns({{"/x", utility::ColumnType::kInt64}}), std::runtime_error
+    );
+}